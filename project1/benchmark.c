@@ -0,0 +1,620 @@
+/*
+ * benchmark.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "object-pool.h"
+#include "event-log.h"
+#include "memory-management.h"
+#include "eviction-policy.h"
+#include "process-data-file-parser.h"
+#include "scheduled-process-source.h"
+#include "process-metrics.h"
+#include "process-scheduler.h"
+#include "scheduling-policy.h"
+#include "pcb-table.h"
+#include "trace-generator.h"
+#include "benchmark.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+extern int optind;
+extern char *optarg;
+
+/* Run the benchmarks and print their results as JSON, in the same shape as
+ * Google Benchmark's, so results of two builds can be diffed:
+ *
+ *   benchmark [-o output.json] [-t min time] [-f filter]
+ *
+ * With -f, only benchmarks with the filter in their name are run.
+ */
+int main(int argc, char *argv[])
+{
+    char input, *output_filename = "-", *filter = NULL;
+    double min_time = BENCHMARK_MIN_TIME;
+    char name[128];
+    int i, first = 1;
+    FILE *fp;
+    benchmark_t benchmarks[] = {
+        { "BM_swap_in_process_memory", benchmark_swap_in_process_memory, 16, "holes" },
+        { "BM_swap_in_process_memory", benchmark_swap_in_process_memory, 256, "holes" },
+        { "BM_swap_in_process_memory", benchmark_swap_in_process_memory, 4096, "holes" },
+        { "BM_swap_in_process_memory", benchmark_swap_in_process_memory, 65536, "holes" },
+        { "BM_swap_out_process_memory", benchmark_swap_out_process_memory, 16, "holes" },
+        { "BM_swap_out_process_memory", benchmark_swap_out_process_memory, 256, "holes" },
+        { "BM_swap_out_process_memory", benchmark_swap_out_process_memory, 4096, "holes" },
+        { "BM_swap_out_process_memory", benchmark_swap_out_process_memory, 65536, "holes" },
+        { "BM_add_free_memory_segment", benchmark_add_free_memory_segment, 16, "holes" },
+        { "BM_add_free_memory_segment", benchmark_add_free_memory_segment, 256, "holes" },
+        { "BM_add_free_memory_segment", benchmark_add_free_memory_segment, 4096, "holes" },
+        { "BM_add_free_memory_segment", benchmark_add_free_memory_segment, 65536, "holes" },
+        { "BM_add_pcb_to_pcbs_queue", benchmark_add_pcb_to_pcbs_queue, 16, "depth" },
+        { "BM_add_pcb_to_pcbs_queue", benchmark_add_pcb_to_pcbs_queue, 256, "depth" },
+        { "BM_add_pcb_to_pcbs_queue", benchmark_add_pcb_to_pcbs_queue, 4096, "depth" },
+        { "BM_add_pcb_to_pcbs_queue", benchmark_add_pcb_to_pcbs_queue, 65536, "depth" },
+        { "BM_add_pcb_to_pcbs_queue_random", benchmark_add_pcb_to_pcbs_queue_random, 16, "depth" },
+        { "BM_add_pcb_to_pcbs_queue_random", benchmark_add_pcb_to_pcbs_queue_random, 256, "depth" },
+        { "BM_add_pcb_to_pcbs_queue_random", benchmark_add_pcb_to_pcbs_queue_random, 4096, "depth" },
+        { "BM_scheduler_run_fcfs", benchmark_scheduler_run_fcfs, 10, "interarrival" },
+        { "BM_scheduler_run_fcfs", benchmark_scheduler_run_fcfs, 4, "interarrival" },
+        { "BM_scheduler_run_multi", benchmark_scheduler_run_multi, 10, "interarrival" },
+        { "BM_scheduler_run_multi", benchmark_scheduler_run_multi, 4, "interarrival" },
+        { "BM_scheduler_run_multi_large", benchmark_scheduler_run_multi_large, 10, "interarrival" },
+        { "BM_scheduler_run_multi_large", benchmark_scheduler_run_multi_large, 4, "interarrival" },
+        { "BM_scheduler_run_pcb_table_fcfs", benchmark_scheduler_run_pcb_table_fcfs, 10, "interarrival" },
+        { "BM_scheduler_run_pcb_table_fcfs", benchmark_scheduler_run_pcb_table_fcfs, 4, "interarrival" },
+        { "BM_scheduler_run_pcb_table_multi", benchmark_scheduler_run_pcb_table_multi, 10, "interarrival" },
+        { "BM_scheduler_run_pcb_table_multi", benchmark_scheduler_run_pcb_table_multi, 4, "interarrival" },
+        { "BM_scheduler_run_pcb_table_multi_large", benchmark_scheduler_run_pcb_table_multi_large, 10, "interarrival" },
+        { "BM_scheduler_run_pcb_table_multi_large", benchmark_scheduler_run_pcb_table_multi_large, 4, "interarrival" },
+    };
+
+    // Handle program arguments.
+    while ((input = getopt(argc, argv, "o:t:f:")) != EOF)
+    {
+        switch (input)
+        {
+            case 'o':  // Filename of JSON output.
+                output_filename = optarg;
+                break;
+
+            case 't':  // Least time to measure each benchmark for.
+                min_time = atof(optarg);
+                if (min_time <= 0)
+                {
+                    fprintf(stderr, "Invalid min time argument\n");
+                    exit(1);
+                }
+                break;
+
+            case 'f':  // Only run benchmarks with this in their name.
+                filter = optarg;
+                break;
+
+            default:  // Unknown argument.
+                fprintf(stderr, "Unknown argument\n");
+                exit(1);
+                break;
+        }
+    }
+
+    // Open output and error check.
+    fp = (strcmp(output_filename, "-") == 0) ? stdout : fopen(output_filename, "w");
+    if (fp == NULL)
+    {
+        perror("fopen");
+        exit(1);
+    }
+
+    fprintf(fp, "{\n");
+    print_benchmark_context(min_time, fp);
+    fprintf(fp, "  \"benchmarks\": [");
+    for (i = 0; i < (int)(sizeof(benchmarks) / sizeof(benchmarks[0])); i++)
+    {
+        snprintf(name, sizeof(name), "%s/%s:%d",
+            benchmarks[i].name, benchmarks[i].arg_name, benchmarks[i].arg);
+        if (filter != NULL && strstr(name, filter) == NULL)
+        {
+            continue;
+        }
+        fprintf(stderr, "%s\n", name);
+        measure_benchmark(&benchmarks[i], min_time, first, fp);
+        first = 0;
+    }
+    fprintf(fp, "\n  ]\n}\n");
+
+    if (fp != stdout)
+    {
+        fclose(fp);
+    }
+
+    return 0;
+}
+
+void start_benchmark_timing(benchmark_state_t *state)
+{
+    state->real_start = get_clock_time(CLOCK_MONOTONIC);
+    state->cpu_start = get_clock_time(CLOCK_PROCESS_CPUTIME_ID);
+    return;
+}
+
+void stop_benchmark_timing(benchmark_state_t *state)
+{
+    state->cpu_time += get_clock_time(CLOCK_PROCESS_CPUTIME_ID) - state->cpu_start;
+    state->real_time += get_clock_time(CLOCK_MONOTONIC) - state->real_start;
+    return;
+}
+
+double get_clock_time(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+void measure_benchmark(benchmark_t *benchmark, double min_time, int first,
+    FILE *fp)
+{
+    benchmark_state_t state;
+    double growth;
+
+    /* Grow the iterations by how far off the min time the last measurement
+     * was, with some to spare, until it is reached.
+     */
+    state.iterations = 1;
+    while (1)
+    {
+        state.items = 0;
+        state.real_time = 0;
+        state.cpu_time = 0;
+        benchmark->run(&state, benchmark->arg);
+        if (state.real_time >= min_time * 1e9)
+        {
+            break;
+        }
+        growth = (state.real_time > 0) ? 1.4 * min_time * 1e9 / state.real_time :
+            BENCHMARK_MAX_GROWTH;
+        growth = (growth < BENCHMARK_MAX_GROWTH) ? growth : BENCHMARK_MAX_GROWTH;
+        state.iterations = (long)(state.iterations * growth) + 1;
+    }
+
+    fprintf(fp, "%s\n    {\n", first ? "" : ",");
+    fprintf(fp, "      \"name\": \"%s/%s:%d\",\n",
+        benchmark->name, benchmark->arg_name, benchmark->arg);
+    fprintf(fp, "      \"run_name\": \"%s/%s:%d\",\n",
+        benchmark->name, benchmark->arg_name, benchmark->arg);
+    fprintf(fp, "      \"run_type\": \"iteration\",\n");
+    fprintf(fp, "      \"iterations\": %ld,\n", state.iterations);
+    fprintf(fp, "      \"real_time\": %.4f,\n", state.real_time / state.iterations);
+    fprintf(fp, "      \"cpu_time\": %.4f,\n", state.cpu_time / state.iterations);
+    fprintf(fp, "      \"time_unit\": \"ns\",\n");
+    fprintf(fp, "      \"items_per_second\": %.4f\n",
+        (state.real_time > 0) ? state.items / (state.real_time / 1e9) : 0.0);
+    fprintf(fp, "    }");
+    fflush(fp);
+
+    return;
+}
+
+void print_benchmark_context(double min_time, FILE *fp)
+{
+    char date[64], host_name[256];
+    time_t now = time(NULL);
+
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+    if (gethostname(host_name, sizeof(host_name)) != 0)
+    {
+        strcpy(host_name, "unknown");
+    }
+    host_name[sizeof(host_name) - 1] = '\0';
+
+    fprintf(fp, "  \"context\": {\n");
+    fprintf(fp, "    \"date\": \"%s\",\n", date);
+    fprintf(fp, "    \"host_name\": \"%s\",\n", host_name);
+    fprintf(fp, "    \"executable\": \"benchmark\",\n");
+    fprintf(fp, "    \"num_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(fp, "    \"min_time\": %.2f,\n", min_time);
+#ifdef __OPTIMIZE__
+    fprintf(fp, "    \"library_build_type\": \"release\"\n");
+#else
+    fprintf(fp, "    \"library_build_type\": \"debug\"\n");
+#endif
+    fprintf(fp, "  },\n");
+
+    return;
+}
+
+int make_benchmark_holes(int holes, process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    process_memory_t **proc_mems;
+    int i;
+
+    proc_mems = (process_memory_t**)malloc(sizeof(process_memory_t*) * 2 * holes);
+    if (proc_mems == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    /* Fill main memory from the top, then swap out every other process memory
+     * and pin the rest, so only process memories swapped in later move.
+     */
+    for (i = 0; i < 2 * holes; i++)
+    {
+        proc_mems[i] = new_process_memory(
+            BENCHMARK_SEGMENT_SIZE, -1 - i, proc_mems_list
+            );
+        swap_in_process_memory(proc_mems[i], 0, proc_mems_list, mem_segs_list);
+    }
+    for (i = 0; i < 2 * holes; i++)
+    {
+        if (i % 2 == 1)
+        {
+            swap_out_process_memory_by_process_memory(
+                proc_mems[i], proc_mems_list, mem_segs_list
+                );
+        }
+        else
+        {
+            pin_process_memory(proc_mems[i], proc_mems_list);
+        }
+    }
+    free(proc_mems);
+
+    return 2 * holes * BENCHMARK_SEGMENT_SIZE;
+}
+
+void benchmark_swap_in_process_memory(benchmark_state_t *state, int holes)
+{
+    process_memories_list_t *proc_mems_list = new_process_memories_list();
+    free_memory_segments_list_t *mem_segs_list = new_free_memory_segments_list(
+        2 * holes * BENCHMARK_SEGMENT_SIZE
+        );
+    process_memory_t *proc_mems[BENCHMARK_BATCH];
+    long done;
+    int i, batch;
+
+    set_process_memories_list_eviction_policy(proc_mems_list, &largest_eviction_policy);
+    make_benchmark_holes(holes, proc_mems_list, mem_segs_list);
+    for (i = 0; i < BENCHMARK_BATCH; i++)
+    {
+        proc_mems[i] = new_process_memory(1, i, proc_mems_list);
+    }
+
+    /* Swap small process memories into the highest hole, shrinking it but
+     * keeping the number of holes, then swap them back out untimed.
+     */
+    for (done = 0; done < state->iterations; done += batch)
+    {
+        batch = (state->iterations - done < BENCHMARK_BATCH) ?
+            state->iterations - done : BENCHMARK_BATCH;
+        start_benchmark_timing(state);
+        for (i = 0; i < batch; i++)
+        {
+            swap_in_process_memory(proc_mems[i], 0, proc_mems_list, mem_segs_list);
+        }
+        stop_benchmark_timing(state);
+        for (i = 0; i < batch; i++)
+        {
+            swap_out_process_memory(proc_mems_list, mem_segs_list);
+        }
+    }
+    state->items = state->iterations;
+
+    free_free_memory_segments_list(mem_segs_list);
+    free_process_memories_list(proc_mems_list);
+
+    return;
+}
+
+void benchmark_swap_out_process_memory(benchmark_state_t *state, int holes)
+{
+    process_memories_list_t *proc_mems_list = new_process_memories_list();
+    free_memory_segments_list_t *mem_segs_list = new_free_memory_segments_list(
+        2 * holes * BENCHMARK_SEGMENT_SIZE
+        );
+    process_memory_t *proc_mems[BENCHMARK_BATCH];
+    long done;
+    int i, batch;
+
+    set_process_memories_list_eviction_policy(proc_mems_list, &largest_eviction_policy);
+    make_benchmark_holes(holes, proc_mems_list, mem_segs_list);
+    for (i = 0; i < BENCHMARK_BATCH; i++)
+    {
+        proc_mems[i] = new_process_memory(1, i, proc_mems_list);
+    }
+
+    // Swap small process memories in untimed, then swap them back out.
+    for (done = 0; done < state->iterations; done += batch)
+    {
+        batch = (state->iterations - done < BENCHMARK_BATCH) ?
+            state->iterations - done : BENCHMARK_BATCH;
+        for (i = 0; i < batch; i++)
+        {
+            swap_in_process_memory(proc_mems[i], 0, proc_mems_list, mem_segs_list);
+        }
+        start_benchmark_timing(state);
+        for (i = 0; i < batch; i++)
+        {
+            swap_out_process_memory(proc_mems_list, mem_segs_list);
+        }
+        stop_benchmark_timing(state);
+    }
+    state->items = state->iterations;
+
+    free_free_memory_segments_list(mem_segs_list);
+    free_process_memories_list(proc_mems_list);
+
+    return;
+}
+
+void benchmark_add_free_memory_segment(benchmark_state_t *state, int holes)
+{
+    /* Main memory is cells of 5: 2 free, then 3 taken. Freeing the middle of
+     * the taken 3 adds a hole that best fit takes back first.
+     */
+    free_memory_segments_list_t *mem_segs_list = new_free_memory_segments_list(5 * holes);
+    int max_batch = (holes < BENCHMARK_BATCH) ? holes : BENCHMARK_BATCH;
+    unsigned int cell;
+    long done;
+    int i, batch;
+
+    set_free_memory_segments_list_fit_policy(mem_segs_list, best_fit);
+    take_fitting_free_memory(5 * holes, mem_segs_list);
+    for (i = 0; i < holes; i++)
+    {
+        add_new_free_memory_segment_to_free_memory_segments_list(
+            i * 5 + 2, 2, mem_segs_list
+            );
+    }
+
+    /* Scatter the cells freed, all different within a batch as holes is a power
+     * of 2.
+     */
+    for (done = 0; done < state->iterations; done += batch)
+    {
+        batch = (state->iterations - done < max_batch) ?
+            state->iterations - done : max_batch;
+        start_benchmark_timing(state);
+        for (i = 0; i < batch; i++)
+        {
+            cell = (unsigned int)(done + i) * 2654435761u % (unsigned int)holes;
+            add_new_free_memory_segment_to_free_memory_segments_list(
+                cell * 5 + 4, 1, mem_segs_list
+                );
+        }
+        stop_benchmark_timing(state);
+        for (i = 0; i < batch; i++)
+        {
+            take_fitting_free_memory(1, mem_segs_list);
+        }
+    }
+    state->items = state->iterations;
+
+    free_free_memory_segments_list(mem_segs_list);
+
+    return;
+}
+
+void benchmark_add_pcb_to_pcbs_queue(benchmark_state_t *state, int depth)
+{
+    pcbs_queue_t *pcbs_queue = new_pcbs_queue();
+    process_control_block_t *pcbs;
+    long done;
+    int i, batch;
+
+    pcbs = (process_control_block_t*)calloc(depth + BENCHMARK_BATCH,
+        sizeof(process_control_block_t));
+    if (pcbs == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    for (i = 0; i < depth + BENCHMARK_BATCH; i++)
+    {
+        pcbs[i].process_id = i;
+    }
+    for (i = 0; i < depth; i++)
+    {
+        add_pcb_to_pcbs_queue(&pcbs[i], pcbs_queue);
+    }
+
+    // Append pcbs after the others, then remove them untimed.
+    for (done = 0; done < state->iterations; done += batch)
+    {
+        batch = (state->iterations - done < BENCHMARK_BATCH) ?
+            state->iterations - done : BENCHMARK_BATCH;
+        start_benchmark_timing(state);
+        for (i = 0; i < batch; i++)
+        {
+            add_pcb_to_pcbs_queue(&pcbs[depth + i], pcbs_queue);
+        }
+        stop_benchmark_timing(state);
+        for (i = 0; i < batch; i++)
+        {
+            remove_pcb_from_pcbs_queue(&pcbs[depth + i], pcbs_queue);
+        }
+    }
+    state->items = state->iterations;
+
+    free(pcbs);
+    free(pcbs_queue);
+
+    return;
+}
+
+void benchmark_add_pcb_to_pcbs_queue_random(benchmark_state_t *state,
+    int depth)
+{
+    pcbs_queue_t *pcbs_queue = new_pcbs_queue();
+    process_control_block_t *pcbs;
+    unsigned int random_state = TREE_PRIORITY_SEED;
+    long done;
+    int i, batch;
+
+    pcbs = (process_control_block_t*)calloc(depth + BENCHMARK_BATCH,
+        sizeof(process_control_block_t));
+    if (pcbs == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    for (i = 0; i < depth; i++)
+    {
+        pcbs[i].process_id = 2 * i + 1;
+        add_pcb_to_pcbs_queue(&pcbs[i], pcbs_queue);
+    }
+
+    /* Insert pcbs with (xorshift) pseudo-random process ids among the others,
+     * then remove them untimed.
+     */
+    for (done = 0; done < state->iterations; done += batch)
+    {
+        batch = (state->iterations - done < BENCHMARK_BATCH) ?
+            state->iterations - done : BENCHMARK_BATCH;
+        for (i = 0; i < batch; i++)
+        {
+            random_state ^= random_state << 13;
+            random_state ^= random_state >> 17;
+            random_state ^= random_state << 5;
+            pcbs[depth + i].process_id = 2 * (random_state % (depth + 1));
+        }
+        start_benchmark_timing(state);
+        for (i = 0; i < batch; i++)
+        {
+            add_pcb_to_pcbs_queue(&pcbs[depth + i], pcbs_queue);
+        }
+        stop_benchmark_timing(state);
+        for (i = 0; i < batch; i++)
+        {
+            remove_pcb_from_pcbs_queue(&pcbs[depth + i], pcbs_queue);
+        }
+    }
+    state->items = state->iterations;
+
+    free(pcbs);
+    free(pcbs_queue);
+
+    return;
+}
+
+void benchmark_scheduler_run_fcfs(benchmark_state_t *state,
+    int interarrival_time)
+{
+    benchmark_scheduler_run(state, &fcfs_scheduling_policy, 1000, interarrival_time, 0);
+    return;
+}
+
+void benchmark_scheduler_run_multi(benchmark_state_t *state,
+    int interarrival_time)
+{
+    benchmark_scheduler_run(state, &multi_scheduling_policy, 1000, interarrival_time, 0);
+    return;
+}
+
+void benchmark_scheduler_run_multi_large(benchmark_state_t *state,
+    int interarrival_time)
+{
+    benchmark_scheduler_run(state, &multi_scheduling_policy, 10000, interarrival_time, 0);
+    return;
+}
+
+void benchmark_scheduler_run_pcb_table_fcfs(benchmark_state_t *state,
+    int interarrival_time)
+{
+    benchmark_scheduler_run(state, &fcfs_scheduling_policy, 1000, interarrival_time, 1);
+    return;
+}
+
+void benchmark_scheduler_run_pcb_table_multi(benchmark_state_t *state,
+    int interarrival_time)
+{
+    benchmark_scheduler_run(state, &multi_scheduling_policy, 1000, interarrival_time, 1);
+    return;
+}
+
+void benchmark_scheduler_run_pcb_table_multi_large(benchmark_state_t *state,
+    int interarrival_time)
+{
+    benchmark_scheduler_run(state, &multi_scheduling_policy, 10000, interarrival_time, 1);
+    return;
+}
+
+void benchmark_scheduler_run(benchmark_state_t *state,
+    const scheduling_policy_t *policy, int memsize, int interarrival_time,
+    int pcb_table)
+{
+    trace_generator_options_t trace_options;
+    trace_generator_t *generator;
+    scheduled_processes_table_t *table;
+    scheduled_process_source_t *source;
+    scheduled_process_t sp;
+    scheduler_options_t options;
+    simulation_summary_t summary;
+    int quanta[MIN_PRIORITY] = { Q1_QUANTUM, Q2_QUANTUM, Q3_QUANTUM };
+    long i;
+
+    // Generate the trace once, up front.
+    set_default_trace_generator_options(&trace_options);
+    trace_options.records = BENCHMARK_RUN_PROCESSES;
+    trace_options.mean_interarrival_time = interarrival_time;
+    generator = new_trace_generator(&trace_options);
+    table = new_scheduled_processes_table(BENCHMARK_RUN_PROCESSES);
+    while (generate_scheduled_process(generator, &sp))
+    {
+        append_to_scheduled_processes_table(&sp, table);
+    }
+    free_trace_generator(generator);
+
+    // Run the simulation with the defaults, printing nothing.
+    options.scheduling_policy = policy;
+    options.memsize = memsize;
+    options.fit_policy = first_fit;
+    options.eviction_policy = &largest_eviction_policy;
+    options.levels = MIN_PRIORITY;
+    options.quanta = quanta;
+    options.boost_interval = BOOST_INTERVAL;
+    options.cpus = CPUS;
+    options.migration_cost = MIGRATION_COST;
+    options.page_size = PAGE_SIZE;
+    options.tlb_entries = TLB_ENTRIES;
+    options.tlb_ways = TLB_WAYS;
+    options.compaction_threshold = COMPACTION_THRESHOLD;
+    options.compaction_cost = COMPACTION_COST;
+    options.output = NULL;
+    options.event_log = NULL;
+    options.metrics = NULL;
+
+    for (i = 0; i < state->iterations; i++)
+    {
+        source = new_table_source(table, 0);
+        start_benchmark_timing(state);
+        if (pcb_table)
+        {
+            scheduler_run_pcb_table(source, &options, &summary);
+        }
+        else
+        {
+            scheduler_run(source, &options, &summary);
+        }
+        stop_benchmark_timing(state);
+        free_scheduled_process_source(source);
+    }
+    state->items = state->iterations * BENCHMARK_RUN_PROCESSES;
+
+    free_scheduled_processes_table(table);
+
+    return;
+}
@@ -0,0 +1,96 @@
+/*
+ * benchmark.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Default least time each benchmark is measured for, in seconds.
+#define BENCHMARK_MIN_TIME       0.2
+// Most the iterations grow by between measurements.
+#define BENCHMARK_MAX_GROWTH     10.0
+// Operations timed together, to keep clock reads out of the measurement.
+#define BENCHMARK_BATCH          64
+// Size of the process memories holes are made between.
+#define BENCHMARK_SEGMENT_SIZE   256
+// Scheduled processes of each runner benchmark trace.
+#define BENCHMARK_RUN_PROCESSES  20000
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Data structure to hold the state of a benchmark being measured: how many
+ * iterations (operations) to run, and the time spent in its timed sections.
+ */
+typedef struct benchmark_state_t
+{
+    long   iterations;
+    long   items;        // Items processed, for the items per second.
+    double real_time;    // Nanoseconds of wall time.
+    double cpu_time;     // Nanoseconds of process cpu time.
+    double real_start;
+    double cpu_start;
+} benchmark_state_t;
+
+/* Data structure to hold a benchmark: a function measured with an argument,
+ * named as "function/argument".
+ */
+typedef struct benchmark_t
+{
+    char *name;
+    void (*run)(benchmark_state_t *state, int arg);
+    int  arg;
+    char *arg_name;
+} benchmark_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Start or stop timing a section of a benchmark. */
+void start_benchmark_timing(benchmark_state_t *state);
+void stop_benchmark_timing(benchmark_state_t *state);
+/* Get the time of a clock in nanoseconds. */
+double get_clock_time(clockid_t clock);
+/* Measure a benchmark, growing its iterations until it runs for at least a
+ * min time, and print it as a JSON object, after a comma unless the first.
+ */
+void measure_benchmark(benchmark_t *benchmark, double min_time, int first,
+    FILE *fp);
+/* Print the JSON context of the benchmarks run. */
+void print_benchmark_context(double min_time, FILE *fp);
+/* Make memory of holes free memory segments, each between two process memories
+ * pinned in main memory, and return the memory size.
+ */
+int make_benchmark_holes(int holes, process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list);
+/* Benchmarks of the memory manager, with a number of holes. */
+void benchmark_swap_in_process_memory(benchmark_state_t *state, int holes);
+void benchmark_swap_out_process_memory(benchmark_state_t *state, int holes);
+void benchmark_add_free_memory_segment(benchmark_state_t *state, int holes);
+/* Benchmarks of adding pcbs to a pcbs queue of a depth, in process id order or
+ * in random order.
+ */
+void benchmark_add_pcb_to_pcbs_queue(benchmark_state_t *state, int depth);
+void benchmark_add_pcb_to_pcbs_queue_random(benchmark_state_t *state,
+    int depth);
+/* Benchmarks of the runner over a generated trace, with a mean time between
+ * arrivals (the lower, the deeper the ready queues), in main memory of 1000
+ * (few holes) or 10000 (many holes), with linked pcbs or a pcb table.
+ */
+void benchmark_scheduler_run_fcfs(benchmark_state_t *state,
+    int interarrival_time);
+void benchmark_scheduler_run_multi(benchmark_state_t *state,
+    int interarrival_time);
+void benchmark_scheduler_run_multi_large(benchmark_state_t *state,
+    int interarrival_time);
+void benchmark_scheduler_run_pcb_table_fcfs(benchmark_state_t *state,
+    int interarrival_time);
+void benchmark_scheduler_run_pcb_table_multi(benchmark_state_t *state,
+    int interarrival_time);
+void benchmark_scheduler_run_pcb_table_multi_large(benchmark_state_t *state,
+    int interarrival_time);
+void benchmark_scheduler_run(benchmark_state_t *state,
+    const scheduling_policy_t *policy, int memsize, int interarrival_time,
+    int pcb_table);
@@ -0,0 +1,359 @@
+/*
+ * binary-trace.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "process-data-file-parser.h"
+#include "binary-trace.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int is_binary_trace_file(char filename[])
+{
+    FILE *fp;
+    char magic[BINARY_TRACE_MAGIC_LEN];
+    int result = 0;
+
+    // Compare start of file with magic.
+    fp = fopen(filename, "rb");
+    if (fp != NULL)
+    {
+        result = (fread(magic, 1, BINARY_TRACE_MAGIC_LEN, fp) == BINARY_TRACE_MAGIC_LEN &&
+            memcmp(magic, BINARY_TRACE_MAGIC, BINARY_TRACE_MAGIC_LEN) == 0);
+        fclose(fp);
+    }
+
+    return result;
+}
+
+binary_trace_t *new_binary_trace(FILE *fp, int flags, int writing)
+{
+    binary_trace_t *trace;
+
+    // Allocate memory for binary trace and its buffer and error check.
+    trace = (binary_trace_t*)malloc(sizeof(binary_trace_t));
+    if (trace == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    trace->buffer = (unsigned char*)malloc(BINARY_TRACE_BUFFER_LEN);
+    if (trace->buffer == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set binary trace.
+    trace->fp = fp;
+    trace->writing = writing;
+    trace->flags = flags;
+    trace->records = BINARY_TRACE_UNKNOWN_RECORDS;
+    trace->records_done = 0;
+    trace->prev_start_time = 0;
+    trace->prev_process_id = 0;
+    trace->buffer_len = 0;
+    trace->buffer_pos = 0;
+
+    return trace;
+}
+
+binary_trace_t *open_binary_trace(char filename[])
+{
+    FILE *fp;
+    binary_trace_t *trace;
+    unsigned char header[BINARY_TRACE_HEADER_LEN];
+
+    // Open file and error check.
+    fp = (strcmp(filename, "-") == 0) ? stdin : fopen(filename, "rb");
+    if (fp == NULL)
+    {
+        perror("fopen");
+        exit(1);
+    }
+
+    // Read and check header.
+    if (fread(header, 1, BINARY_TRACE_HEADER_LEN, fp) != BINARY_TRACE_HEADER_LEN ||
+        memcmp(header, BINARY_TRACE_MAGIC, BINARY_TRACE_MAGIC_LEN) != 0)
+    {
+        fprintf(stderr, "Invalid binary trace\n");
+        exit(1);
+    }
+    if (decode_le16(header + 4) != BINARY_TRACE_VERSION ||
+        decode_le32(header + 8) != BINARY_TRACE_MAX_RECORD_LEN)
+    {
+        fprintf(stderr, "Unsupported binary trace version\n");
+        exit(1);
+    }
+
+    trace = new_binary_trace(fp, decode_le16(header + 6), 0);
+    trace->records = decode_le64(header + 16);
+
+    return trace;
+}
+
+int read_binary_trace(binary_trace_t *trace, scheduled_process_t *sp)
+{
+    int fields[BINARY_TRACE_RECORD_FIELDS], i;
+
+    // No records left.
+    if (trace->records_done >= trace->records)
+    {
+        return 0;
+    }
+
+    // Decode record, ending at a partial one.
+    for (i = 0; i < BINARY_TRACE_RECORD_FIELDS; i++)
+    {
+        if (!read_binary_trace_varint(trace, &fields[i]))
+        {
+            return 0;
+        }
+    }
+    sp->start_time = fields[0];
+    sp->process_id = fields[1];
+    sp->memory_size = fields[2];
+    sp->job_time = fields[3];
+    if (trace->flags & BINARY_TRACE_DELTAS)
+    {
+        sp->start_time += trace->prev_start_time;
+        sp->process_id += trace->prev_process_id;
+    }
+    trace->prev_start_time = sp->start_time;
+    trace->prev_process_id = sp->process_id;
+
+    trace->records_done++;
+
+    return 1;
+}
+
+int read_binary_trace_varint(binary_trace_t *trace, int *value)
+{
+    unsigned int result = 0;
+    int shift = 0, byte;
+
+    do
+    {
+        // Refill buffer when empty.
+        if (trace->buffer_pos == trace->buffer_len)
+        {
+            trace->buffer_len = (int)fread(trace->buffer, 1,
+                BINARY_TRACE_BUFFER_LEN, trace->fp);
+            trace->buffer_pos = 0;
+            if (trace->buffer_len == 0)
+            {
+                return 0;
+            }
+        }
+
+        // Add the low 7 bits, ignoring any beyond an int.
+        byte = trace->buffer[trace->buffer_pos++];
+        if (shift < 32)
+        {
+            result |= (unsigned int)(byte & 0x7F) << shift;
+        }
+        shift += 7;
+    } while (byte & 0x80);
+    *value = decode_zigzag(result);
+
+    return 1;
+}
+
+binary_trace_t *create_binary_trace(char filename[], int flags)
+{
+    FILE *fp;
+    binary_trace_t *trace;
+    unsigned char header[BINARY_TRACE_HEADER_LEN];
+
+    // Open file and error check.
+    fp = (strcmp(filename, "-") == 0) ? stdout : fopen(filename, "wb");
+    if (fp == NULL)
+    {
+        perror("fopen");
+        exit(1);
+    }
+
+    trace = new_binary_trace(fp, flags, 1);
+
+    // Write header, with the record count unknown until closed.
+    memcpy(header, BINARY_TRACE_MAGIC, BINARY_TRACE_MAGIC_LEN);
+    encode_le16(header + 4, BINARY_TRACE_VERSION);
+    encode_le16(header + 6, flags);
+    encode_le32(header + 8, BINARY_TRACE_MAX_RECORD_LEN);
+    encode_le32(header + 12, 0);
+    encode_le64(header + 16, BINARY_TRACE_UNKNOWN_RECORDS);
+    if (fwrite(header, 1, BINARY_TRACE_HEADER_LEN, fp) != BINARY_TRACE_HEADER_LEN)
+    {
+        perror("fwrite");
+        exit(1);
+    }
+
+    return trace;
+}
+
+void write_binary_trace(binary_trace_t *trace, scheduled_process_t *sp)
+{
+    int start_time = sp->start_time, process_id = sp->process_id;
+
+    // Flush buffer when a record may not fit.
+    if (trace->buffer_len + BINARY_TRACE_MAX_RECORD_LEN > BINARY_TRACE_BUFFER_LEN)
+    {
+        flush_binary_trace(trace);
+    }
+
+    // Encode record.
+    if (trace->flags & BINARY_TRACE_DELTAS)
+    {
+        start_time -= trace->prev_start_time;
+        process_id -= trace->prev_process_id;
+    }
+    trace->buffer_len += encode_varint(trace->buffer + trace->buffer_len,
+        encode_zigzag(start_time));
+    trace->buffer_len += encode_varint(trace->buffer + trace->buffer_len,
+        encode_zigzag(process_id));
+    trace->buffer_len += encode_varint(trace->buffer + trace->buffer_len,
+        encode_zigzag(sp->memory_size));
+    trace->buffer_len += encode_varint(trace->buffer + trace->buffer_len,
+        encode_zigzag(sp->job_time));
+    trace->prev_start_time = sp->start_time;
+    trace->prev_process_id = sp->process_id;
+
+    trace->records_done++;
+
+    return;
+}
+
+void flush_binary_trace(binary_trace_t *trace)
+{
+    if (trace->buffer_len > 0 &&
+        fwrite(trace->buffer, 1, trace->buffer_len, trace->fp) != (size_t)trace->buffer_len)
+    {
+        perror("fwrite");
+        exit(1);
+    }
+    trace->buffer_len = 0;
+
+    return;
+}
+
+void close_binary_trace(binary_trace_t *trace)
+{
+    unsigned char count[8];
+
+    if (trace == NULL)
+    {
+        return;
+    }
+
+    // Written trace: flush buffer, then fill in record count if seekable.
+    if (trace->writing)
+    {
+        flush_binary_trace(trace);
+        if (trace->fp != stdout && fseek(trace->fp, 16, SEEK_SET) == 0)
+        {
+            encode_le64(count, trace->records_done);
+            fwrite(count, 1, sizeof(count), trace->fp);
+        }
+    }
+
+    if (trace->fp != stdout && trace->fp != stdin)
+    {
+        fclose(trace->fp);
+    }
+    else
+    {
+        fflush(trace->fp);
+    }
+    free(trace->buffer);
+    free(trace);
+
+    return;
+}
+
+unsigned long long convert_process_data_file_to_binary_trace(FILE *fp,
+    binary_trace_t *trace)
+{
+    char line[LINE_MAX_LEN];
+    scheduled_process_t sp;
+
+    // Read in, parse and write each valid line.
+    while (fgets(line, LINE_MAX_LEN, fp) != NULL)
+    {
+        if (parse_process_data_line(line, &sp))
+        {
+            write_binary_trace(trace, &sp);
+        }
+    }
+
+    return trace->records_done;
+}
+
+void encode_le16(unsigned char *p, unsigned int value)
+{
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    return;
+}
+
+void encode_le32(unsigned char *p, unsigned int value)
+{
+    encode_le16(p, value & 0xFFFF);
+    encode_le16(p + 2, (value >> 16) & 0xFFFF);
+    return;
+}
+
+void encode_le64(unsigned char *p, unsigned long long value)
+{
+    encode_le32(p, (unsigned int)(value & 0xFFFFFFFFu));
+    encode_le32(p + 4, (unsigned int)(value >> 32));
+    return;
+}
+
+unsigned int decode_le16(const unsigned char *p)
+{
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+unsigned int decode_le32(const unsigned char *p)
+{
+    return decode_le16(p) | (decode_le16(p + 2) << 16);
+}
+
+unsigned long long decode_le64(const unsigned char *p)
+{
+    return (unsigned long long)decode_le32(p) |
+        ((unsigned long long)decode_le32(p + 4) << 32);
+}
+
+int encode_varint(unsigned char *p, unsigned int value)
+{
+    int len = 0;
+
+    // 7 bits at a time, low first, marking all but the last byte.
+    while (value >= 0x80)
+    {
+        p[len++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    p[len++] = (unsigned char)value;
+
+    return len;
+}
+
+unsigned int encode_zigzag(int value)
+{
+    return (value < 0) ? ~((unsigned int)value << 1) : (unsigned int)value << 1;
+}
+
+int decode_zigzag(unsigned int value)
+{
+    return (value & 1) ? (int)~(value >> 1) : (int)(value >> 1);
+}
@@ -0,0 +1,99 @@
+/*
+ * binary-trace.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* A binary trace is a header followed by variable length records, header
+ * fields little-endian:
+ *
+ *   header: magic "PTRC", u16 version, u16 flags, u32 max record length,
+ *           u32 reserved, u64 record count (all ones if unknown, e.g. when
+ *           written to a pipe, in which case records run to end of file)
+ *   record: start time, process id, memory size, job time, each a zig-zag
+ *           varint (7 bits a byte, low first, high bit set on all but last)
+ *
+ * With the deltas flag, start time and process id hold the differences from
+ * the previous record's (from 0 for the first record), so a sorted trace with
+ * sequential ids takes about 1 byte for each, and a record 4 to 6 bytes in
+ * all, against 16 for fixed width fields and 15 to 20 for a text line.
+ * Records cannot be seeked to by index, which nothing needs, as traces are
+ * read in order.
+ */
+#define BINARY_TRACE_MAGIC              "PTRC"
+#define BINARY_TRACE_MAGIC_LEN          4
+#define BINARY_TRACE_VERSION            2
+#define BINARY_TRACE_HEADER_LEN         24
+// Four varints of at most 5 bytes.
+#define BINARY_TRACE_MAX_RECORD_LEN     20
+#define BINARY_TRACE_RECORD_FIELDS      4
+#define BINARY_TRACE_UNKNOWN_RECORDS    0xFFFFFFFFFFFFFFFFull
+#define BINARY_TRACE_DELTAS             0x0001
+// Number of bytes read or written at a time.
+#define BINARY_TRACE_BUFFER_LEN         65536
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Data structure to hold a binary trace being read or written. */
+typedef struct binary_trace_t
+{
+    FILE               *fp;
+    int                writing;      // Opened for writing, not reading.
+    int                flags;
+    unsigned long long records;      // Record count, as in the header.
+    unsigned long long records_done; // Records read or written so far.
+    int                prev_start_time;
+    int                prev_process_id;
+    unsigned char      *buffer;
+    int                buffer_len;   // Bytes in buffer.
+    int                buffer_pos;   // Next byte in buffer.
+} binary_trace_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Check if a file starts with the binary trace magic. */
+int is_binary_trace_file(char filename[]);
+/* Allocate memory for and initialise a new binary trace on an open file. */
+binary_trace_t *new_binary_trace(FILE *fp, int flags, int writing);
+/* Open a binary trace for reading, checking its header. Exits if invalid. */
+binary_trace_t *open_binary_trace(char filename[]);
+/* Read the next scheduled process of the binary trace. Returns 0 at its end. */
+int read_binary_trace(binary_trace_t *trace, scheduled_process_t *sp);
+/* Create a binary trace for writing, "-" for standard output. */
+binary_trace_t *create_binary_trace(char filename[], int flags);
+/* Read the next varint of the binary trace, refilling its buffer as needed.
+ * Returns 0 at its end.
+ */
+int read_binary_trace_varint(binary_trace_t *trace, int *value);
+/* Write a scheduled process to the end of the binary trace. */
+void write_binary_trace(binary_trace_t *trace, scheduled_process_t *sp);
+/* Write out the buffered records of the binary trace. */
+void flush_binary_trace(binary_trace_t *trace);
+/* Flush and close a binary trace, filling in the record count if written to a
+ * seekable file, and free all memory allocated for it.
+ */
+void close_binary_trace(binary_trace_t *trace);
+/* Convert a text process data file to a binary trace, streaming line by line.
+ * Returns the number of records written.
+ */
+unsigned long long convert_process_data_file_to_binary_trace(FILE *fp,
+    binary_trace_t *trace);
+/* Encode or decode little-endian integers. */
+void encode_le16(unsigned char *p, unsigned int value);
+void encode_le32(unsigned char *p, unsigned int value);
+void encode_le64(unsigned char *p, unsigned long long value);
+unsigned int decode_le16(const unsigned char *p);
+unsigned int decode_le32(const unsigned char *p);
+unsigned long long decode_le64(const unsigned char *p);
+/* Encode an unsigned integer as a varint, returning its length in bytes. */
+int encode_varint(unsigned char *p, unsigned int value);
+/* Map signed integers to unsigned ones and back, small magnitudes to small
+ * values (0, -1, 1, -2, ... to 0, 1, 2, 3, ...).
+ */
+unsigned int encode_zigzag(int value);
+int decode_zigzag(unsigned int value);
@@ -0,0 +1,305 @@
+/*
+ * buddy-allocator.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include "buddy-allocator.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+buddy_allocator_t *new_buddy_allocator(int size)
+{
+    buddy_allocator_t *buddy;
+    buddy_free_bitmap_t *bitmap;
+    int order, level, len, address;
+
+    if (size < 1)
+    {
+        fprintf(stderr, "Main memory too small for a buddy allocator\n");
+        exit(1);
+    }
+
+    // Allocate memory for buddy allocator and error check.
+    buddy = (buddy_allocator_t*)malloc(sizeof(buddy_allocator_t));
+    if (buddy == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    buddy->size = size;
+    buddy->max_order = 0;
+    while ((2L << buddy->max_order) <= size)
+    {
+        buddy->max_order++;
+    }
+    buddy->free_bitmaps = (buddy_free_bitmap_t*)malloc(
+        sizeof(buddy_free_bitmap_t) * (buddy->max_order + 1)
+        );
+    if (buddy->free_bitmaps == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Allocate each order's bitmap levels, all clear, up to a single word.
+    for (order = 0; order <= buddy->max_order; order++)
+    {
+        bitmap = &buddy->free_bitmaps[order];
+        bitmap->levels = 1;
+        len = (size >> order) / BUDDY_BITMAP_WORD_BITS + 1;
+        while (len > 1)
+        {
+            bitmap->levels++;
+            len = len / BUDDY_BITMAP_WORD_BITS + 1;
+        }
+        bitmap->words = (unsigned long**)malloc(sizeof(unsigned long*) * bitmap->levels);
+        if (bitmap->words == NULL)
+        {
+            perror("malloc");
+            exit(1);
+        }
+        len = (size >> order) / BUDDY_BITMAP_WORD_BITS + 1;
+        for (level = 0; level < bitmap->levels; level++)
+        {
+            bitmap->words[level] = (unsigned long*)calloc(len, sizeof(unsigned long));
+            if (bitmap->words[level] == NULL)
+            {
+                perror("malloc");
+                exit(1);
+            }
+            len = len / BUDDY_BITMAP_WORD_BITS + 1;
+        }
+    }
+
+    // Free the largest aligned blocks that fit, lowest addressed first.
+    buddy->free_blocks = 0;
+    buddy->allocated_size = 0;
+    buddy->allocated_block_size = 0;
+    address = 0;
+    for (order = buddy->max_order; order >= 0; order--)
+    {
+        if (size - address >= (1 << order))
+        {
+            set_buddy_block_free(order, address >> order, buddy);
+            buddy->free_blocks++;
+            address += 1 << order;
+        }
+    }
+
+    return buddy;
+}
+
+int get_buddy_order(int size)
+{
+    int order = 0;
+
+    while ((1L << order) < size)
+    {
+        order++;
+    }
+
+    return order;
+}
+
+int allocate_buddy_block(int size, buddy_allocator_t *buddy)
+{
+    int order = get_buddy_order(size);
+    int split_order, index, address;
+
+    // Find the smallest free block that holds the size.
+    index = NO_BLOCK;
+    for (split_order = order; split_order <= buddy->max_order; split_order++)
+    {
+        index = get_lowest_free_buddy_block(split_order, buddy);
+        if (index != NO_BLOCK)
+        {
+            break;
+        }
+    }
+    if (index == NO_BLOCK)
+    {
+        return NO_BLOCK;
+    }
+    clear_buddy_block_free(split_order, index, buddy);
+    buddy->free_blocks--;
+    address = index << split_order;
+
+    // Split it down, keeping the lower half and freeing the upper one.
+    while (split_order > order)
+    {
+        split_order--;
+        set_buddy_block_free(split_order, (address >> split_order) + 1, buddy);
+        buddy->free_blocks++;
+    }
+    buddy->allocated_size += size;
+    buddy->allocated_block_size += 1 << order;
+
+    return address;
+}
+
+void free_buddy_block(int address, int size, buddy_allocator_t *buddy)
+{
+    int order = get_buddy_order(size);
+    int index = address >> order;
+
+    buddy->allocated_size -= size;
+    buddy->allocated_block_size -= 1 << order;
+
+    /* Merge with its buddy while that is free, as long as the merged block is
+     * in main memory.
+     */
+    while (order < buddy->max_order &&
+        ((long)((index ^ 1) + 1) << order) <= buddy->size &&
+        is_buddy_block_free(order, index ^ 1, buddy))
+    {
+        clear_buddy_block_free(order, index ^ 1, buddy);
+        buddy->free_blocks--;
+        index >>= 1;
+        order++;
+    }
+    set_buddy_block_free(order, index, buddy);
+    buddy->free_blocks++;
+
+    return;
+}
+
+int get_largest_free_buddy_block_size(buddy_allocator_t *buddy)
+{
+    buddy_free_bitmap_t *bitmap;
+    int order;
+
+    // Any free block of an order shows in its top level word.
+    for (order = buddy->max_order; order >= 0; order--)
+    {
+        bitmap = &buddy->free_bitmaps[order];
+        if (bitmap->words[bitmap->levels - 1][0] != 0)
+        {
+            return 1 << order;
+        }
+    }
+
+    return 0;
+}
+
+void set_buddy_block_free(int order, int index, buddy_allocator_t *buddy)
+{
+    buddy_free_bitmap_t *bitmap = &buddy->free_bitmaps[order];
+    unsigned long word;
+    int level;
+
+    // Set its bit, and its word's bit a level up if the word was zero.
+    for (level = 0; level < bitmap->levels; level++)
+    {
+        word = bitmap->words[level][index / BUDDY_BITMAP_WORD_BITS];
+        bitmap->words[level][index / BUDDY_BITMAP_WORD_BITS] =
+            word | (1UL << (index % BUDDY_BITMAP_WORD_BITS));
+        if (word != 0)
+        {
+            break;
+        }
+        index /= BUDDY_BITMAP_WORD_BITS;
+    }
+
+    return;
+}
+
+void clear_buddy_block_free(int order, int index, buddy_allocator_t *buddy)
+{
+    buddy_free_bitmap_t *bitmap = &buddy->free_bitmaps[order];
+    unsigned long word;
+    int level;
+
+    // Clear its bit, and its word's bit a level up if the word is now zero.
+    for (level = 0; level < bitmap->levels; level++)
+    {
+        word = bitmap->words[level][index / BUDDY_BITMAP_WORD_BITS] &
+            ~(1UL << (index % BUDDY_BITMAP_WORD_BITS));
+        bitmap->words[level][index / BUDDY_BITMAP_WORD_BITS] = word;
+        if (word != 0)
+        {
+            break;
+        }
+        index /= BUDDY_BITMAP_WORD_BITS;
+    }
+
+    return;
+}
+
+int is_buddy_block_free(int order, int index, buddy_allocator_t *buddy)
+{
+    return (buddy->free_bitmaps[order].words[0][index / BUDDY_BITMAP_WORD_BITS] >>
+        (index % BUDDY_BITMAP_WORD_BITS)) & 1;
+}
+
+int get_lowest_free_buddy_block(int order, buddy_allocator_t *buddy)
+{
+    buddy_free_bitmap_t *bitmap = &buddy->free_bitmaps[order];
+    unsigned long word;
+    int level, index;
+
+    // Follow the lowest set bit of each level down from the top.
+    index = 0;
+    for (level = bitmap->levels - 1; level >= 0; level--)
+    {
+        word = bitmap->words[level][index];
+        if (word == 0)
+        {
+            return NO_BLOCK;
+        }
+        index = index * BUDDY_BITMAP_WORD_BITS + __builtin_ctzl(word);
+    }
+
+    return index;
+}
+
+void print_buddy_allocator(buddy_allocator_t *buddy)
+{
+    int order, index;
+
+    // Iterate over each order's blocks and print the free ones.
+    printf("{\n");
+    for (order = buddy->max_order; order >= 0; order--)
+    {
+        for (index = 0; index < (buddy->size >> order); index++)
+        {
+            if (is_buddy_block_free(order, index, buddy))
+            {
+                printf("  [order: %d, address: %d, size: %d]\n",
+                    order,
+                    index << order,
+                    1 << order);
+            }
+        }
+    }
+    printf("}\n");
+
+    return;
+}
+
+void free_buddy_allocator(buddy_allocator_t *buddy)
+{
+    int order, level;
+
+    if (buddy != NULL)
+    {
+        for (order = 0; order <= buddy->max_order; order++)
+        {
+            for (level = 0; level < buddy->free_bitmaps[order].levels; level++)
+            {
+                free(buddy->free_bitmaps[order].words[level]);
+            }
+            free(buddy->free_bitmaps[order].words);
+        }
+        free(buddy->free_bitmaps);
+    }
+    free(buddy);
+
+    return;
+}
@@ -0,0 +1,75 @@
+/*
+ * buddy-allocator.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Returned as the address of a block when none is free that fits.
+#define NO_BLOCK -1
+// Bits in each word of the free bitmaps.
+#define BUDDY_BITMAP_WORD_BITS ((int)(sizeof(unsigned long) * 8))
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Data structure to hold the free blocks of one order (size 2^order) of a
+ * buddy allocator, as a bitmap of which aligned blocks are free. Above it are
+ * summary bitmaps, each bit set if a word below is not zero, up to a single
+ * word, so a free block is found in O(log M) too.
+ */
+typedef struct buddy_free_bitmap_t
+{
+    int           levels;
+    unsigned long **words;  // Words of each level, the block bits first.
+} buddy_free_bitmap_t;
+
+/* Data structure to hold a binary buddy allocator of main memory. Blocks are
+ * split in halves until just large enough for a process memory, and merged
+ * back with their buddy when both are free. Main memory that is not a power
+ * of two starts as the largest aligned blocks that fit, which never merge.
+ */
+typedef struct buddy_allocator_t
+{
+    int                 size;
+    int                 max_order;
+    buddy_free_bitmap_t *free_bitmaps;  // Free blocks of each order.
+    int                 free_blocks;
+    int                 allocated_size;        // Total size of process memories.
+    int                 allocated_block_size;  // Total size of their blocks.
+} buddy_allocator_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Allocate memory for and initialise a new buddy allocator of main memory of a
+ * size, all free.
+ */
+buddy_allocator_t *new_buddy_allocator(int size);
+/* Get the order of the smallest block that holds a size. */
+int get_buddy_order(int size);
+/* Allocate the lowest addressed block of the smallest free order that holds a
+ * size, splitting it down. Returns its address, or NO_BLOCK if none fit.
+ */
+int allocate_buddy_block(int size, buddy_allocator_t *buddy);
+/* Free the block at an address allocated for a size, merging it with its buddy
+ * for as long as that is free.
+ */
+void free_buddy_block(int address, int size, buddy_allocator_t *buddy);
+/* Get the size of the largest free block, 0 if none are. */
+int get_largest_free_buddy_block_size(buddy_allocator_t *buddy);
+/* Set or clear whether the block of an order at an index is free. */
+void set_buddy_block_free(int order, int index, buddy_allocator_t *buddy);
+void clear_buddy_block_free(int order, int index, buddy_allocator_t *buddy);
+/* Check if the block of an order at an index is free. */
+int is_buddy_block_free(int order, int index, buddy_allocator_t *buddy);
+/* Get the index of the lowest addressed free block of an order, or NO_BLOCK if
+ * none are.
+ */
+int get_lowest_free_buddy_block(int order, buddy_allocator_t *buddy);
+/* Print the free blocks of a buddy allocator. */
+void print_buddy_allocator(buddy_allocator_t *buddy);
+/* Free all memory allocated for a buddy allocator. */
+void free_buddy_allocator(buddy_allocator_t *buddy);
@@ -0,0 +1,1262 @@
+/*
+ * checkpoint.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "object-pool.h"
+#include "event-log.h"
+#include "memory-management.h"
+#include "paged-memory.h"
+#include "buddy-allocator.h"
+#include "process-data-file-parser.h"
+#include "scheduled-process-source.h"
+#include "process-metrics.h"
+#include "process-scheduler.h"
+#include "checkpoint.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void save_checkpoint(char filename[], scheduler_state_t *state,
+    scheduled_process_source_t *source, scheduler_options_t *options,
+    simulation_summary_t *summary)
+{
+    FILE *fp;
+    checkpoint_header_t header;
+    process_control_block_t **pcbs;
+    process_memory_t **proc_mems;
+    free_memory_segment_t **mem_segs;
+    process_memory_t *proc_mem;
+    free_memory_segment_t *mem_seg;
+    int pcbs_len, proc_mems_len, mem_segs_len, i;
+    checkpoint_index_t *pcb_index, *proc_mem_index, *mem_seg_index;
+    process_memories_list_t *proc_mems_list = state->proc_mems_list;
+    free_memory_segments_list_t *mem_segs_list = state->mem_segs_list;
+    simulation_metrics_t *metrics = options->metrics;
+
+    // Open checkpoint file and error check.
+    fp = fopen(filename, "wb");
+    if (fp == NULL)
+    {
+        perror("fopen");
+        exit(1);
+    }
+
+    // Index every object pointers are saved as indexes of.
+    pcbs_len = get_checkpoint_pcbs(state->cpus, state->cpus_len, &pcbs);
+    proc_mems_len = 0;
+    for (proc_mem = proc_mems_list->head; proc_mem != NULL; proc_mem = proc_mem->next)
+    {
+        proc_mems_len++;
+    }
+    mem_segs_len = 0;
+    for (mem_seg = mem_segs_list->head; mem_seg != NULL; mem_seg = mem_seg->next)
+    {
+        mem_segs_len++;
+    }
+    proc_mems = (process_memory_t**)malloc(sizeof(process_memory_t*) * (proc_mems_len + 1));
+    mem_segs = (free_memory_segment_t**)malloc(sizeof(free_memory_segment_t*) * (mem_segs_len + 1));
+    if (proc_mems == NULL || mem_segs == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    for (proc_mem = proc_mems_list->head, i = 0; proc_mem != NULL; proc_mem = proc_mem->next)
+    {
+        proc_mems[i++] = proc_mem;
+    }
+    for (mem_seg = mem_segs_list->head, i = 0; mem_seg != NULL; mem_seg = mem_seg->next)
+    {
+        mem_segs[i++] = mem_seg;
+    }
+    pcb_index = new_checkpoint_index((void**)pcbs, pcbs_len);
+    proc_mem_index = new_checkpoint_index((void**)proc_mems, proc_mems_len);
+    mem_seg_index = new_checkpoint_index((void**)mem_segs, mem_segs_len);
+
+    // Set header, written again once the sections are.
+    memset(&header, 0, sizeof(checkpoint_header_t));
+    memcpy(header.magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LEN);
+    header.version = CHECKPOINT_VERSION;
+    header.byte_order = CHECKPOINT_BYTE_ORDER;
+    header.header_len = sizeof(checkpoint_header_t);
+    strncpy(header.scheduling_policy, options->scheduling_policy->name,
+        CHECKPOINT_NAME_LEN - 1);
+    strncpy(header.eviction_policy, proc_mems_list->eviction_policy->name,
+        CHECKPOINT_NAME_LEN - 1);
+    header.memsize = options->memsize;
+    header.fit_policy = options->fit_policy;
+    header.levels = options->levels;
+    header.cpus = options->cpus;
+    header.page_size = options->page_size;
+    header.tlb_entries = options->tlb_entries;
+    header.tlb_ways = options->tlb_ways;
+    header.time = state->time;
+    header.next_boost_time = state->next_boost_time;
+    header.taken = source->taken;
+    header.has_next = (peek_scheduled_process(source) != NULL);
+    if (header.has_next)
+    {
+        header.next = *peek_scheduled_process(source);
+    }
+    header.summary = *summary;
+    header.holes_count = (options->event_log != NULL) ?
+        options->event_log->holes_count : NO_EVENT_VALUE;
+    fwrite(&header, sizeof(checkpoint_header_t), 1, fp);
+
+    // Write each section in order.
+    write_checkpoint_cpus(fp, state, pcb_index, options, &header);
+    write_checkpoint_pcbs(fp, pcbs, pcbs_len, pcb_index, proc_mem_index, &header);
+    write_checkpoint_process_memories(
+        fp, proc_mems_list, proc_mems, proc_mems_len, proc_mem_index, &header
+        );
+    write_checkpoint_memory_segments(
+        fp, mem_segs_list, mem_segs, mem_segs_len, mem_seg_index, &header
+        );
+    if (metrics != NULL)
+    {
+        header.has_metrics = 1;
+        header.total_wait_time = metrics->total_wait_time;
+        header.total_swap_count = metrics->total_swap_count;
+        header.max_wait_time = metrics->max_wait_time;
+        header.max_swap_count = metrics->max_swap_count;
+    }
+    write_checkpoint_section(fp, turnaround_times_section,
+        (metrics != NULL) ? metrics->turnaround_times : NULL, sizeof(int),
+        (metrics != NULL) ? metrics->len : 0, &header);
+    write_checkpoint_section(fp, response_times_section,
+        (metrics != NULL) ? metrics->response_times : NULL, sizeof(int),
+        (metrics != NULL) ? metrics->len : 0, &header);
+
+    // Write the header again with the sections and error check.
+    fseek(fp, 0, SEEK_SET);
+    fwrite(&header, sizeof(checkpoint_header_t), 1, fp);
+    if (ferror(fp) || fclose(fp) != 0)
+    {
+        perror("fwrite");
+        exit(1);
+    }
+
+    free_checkpoint_index(pcb_index);
+    free_checkpoint_index(proc_mem_index);
+    free_checkpoint_index(mem_seg_index);
+    free(pcbs);
+    free(proc_mems);
+    free(mem_segs);
+
+    return;
+}
+
+void write_checkpoint_cpus(FILE *fp, scheduler_state_t *state,
+    checkpoint_index_t *pcb_index, scheduler_options_t *options,
+    checkpoint_header_t *header)
+{
+    checkpoint_cpu_t *cpu_records;
+    checkpoint_pcbs_queue_t *queue_records;
+    int *heap_records;
+    tlb_entry_t *tlb_records;
+    cpu_t *cpu;
+    int i, j, heaps_len = 0, tlbs_len = 0;
+
+    for (i = 0; i < state->cpus_len; i++)
+    {
+        heaps_len += state->cpus[i].ready_heap_len;
+        tlbs_len += (state->cpus[i].tlb != NULL) ? options->tlb_entries : 0;
+    }
+
+    // Allocate memory for records and error check.
+    cpu_records = (checkpoint_cpu_t*)malloc(sizeof(checkpoint_cpu_t) * state->cpus_len);
+    queue_records = (checkpoint_pcbs_queue_t*)malloc(sizeof(checkpoint_pcbs_queue_t) * state->cpus_len * options->levels);
+    heap_records = (int*)malloc(sizeof(int) * (heaps_len + 1));
+    tlb_records = (tlb_entry_t*)malloc(sizeof(tlb_entry_t) * (tlbs_len + 1));
+    if (cpu_records == NULL || queue_records == NULL || heap_records == NULL ||
+        tlb_records == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set records of each CPU, its ready queues, ready heap and tlb.
+    heaps_len = 0;
+    tlbs_len = 0;
+    for (i = 0; i < state->cpus_len; i++)
+    {
+        cpu = &state->cpus[i];
+        cpu_records[i].running = get_checkpoint_index(cpu->running, pcb_index);
+        cpu_records[i].waiting = cpu->waiting;
+        cpu_records[i].ready_heap_len = cpu->ready_heap_len;
+        cpu_records[i].ready_tree = get_checkpoint_index(cpu->ready_tree, pcb_index);
+        cpu_records[i].min_vruntime = cpu->min_vruntime;
+        cpu_records[i].tickets = cpu->tickets;
+        cpu_records[i].random_state = cpu->random_state;
+        cpu_records[i].migration_time = cpu->migration_time;
+        cpu_records[i].tlb_clock = (cpu->tlb != NULL) ? cpu->tlb->clock : 0;
+        cpu_records[i].tlb_hits = (cpu->tlb != NULL) ? cpu->tlb->hits : 0;
+        cpu_records[i].tlb_misses = (cpu->tlb != NULL) ? cpu->tlb->misses : 0;
+
+        for (j = 0; j < cpu->levels; j++)
+        {
+            queue_records[i * cpu->levels + j].head = get_checkpoint_index(
+                cpu->ready_qs[j]->head, pcb_index
+                );
+            queue_records[i * cpu->levels + j].tail = get_checkpoint_index(
+                cpu->ready_qs[j]->tail, pcb_index
+                );
+            queue_records[i * cpu->levels + j].len = cpu->ready_qs[j]->len;
+        }
+        for (j = 0; j < cpu->ready_heap_len; j++)
+        {
+            heap_records[heaps_len++] = get_checkpoint_index(
+                cpu->ready_heap[j], pcb_index
+                );
+        }
+        if (cpu->tlb != NULL)
+        {
+            memcpy(&tlb_records[tlbs_len], cpu->tlb->entries,
+                sizeof(tlb_entry_t) * options->tlb_entries);
+            tlbs_len += options->tlb_entries;
+        }
+    }
+
+    write_checkpoint_section(fp, cpus_section, cpu_records,
+        sizeof(checkpoint_cpu_t), state->cpus_len, header);
+    write_checkpoint_section(fp, ready_qs_section, queue_records,
+        sizeof(checkpoint_pcbs_queue_t), state->cpus_len * options->levels,
+        header);
+    write_checkpoint_section(fp, ready_heaps_section, heap_records,
+        sizeof(int), heaps_len, header);
+    write_checkpoint_section(fp, tlb_entries_section, tlb_records,
+        sizeof(tlb_entry_t), tlbs_len, header);
+
+    free(cpu_records);
+    free(queue_records);
+    free(heap_records);
+    free(tlb_records);
+
+    return;
+}
+
+void write_checkpoint_pcbs(FILE *fp, process_control_block_t *pcbs[], int len,
+    checkpoint_index_t *pcb_index, checkpoint_index_t *proc_mem_index,
+    checkpoint_header_t *header)
+{
+    checkpoint_pcb_t *records;
+    process_control_block_t *pcb;
+    int i;
+
+    // Allocate memory for records and error check.
+    records = (checkpoint_pcb_t*)malloc(sizeof(checkpoint_pcb_t) * (len + 1));
+    if (records == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        pcb = pcbs[i];
+        records[i].next = get_checkpoint_index(pcb->next, pcb_index);
+        records[i].prev = get_checkpoint_index(pcb->prev, pcb_index);
+        records[i].process_id = pcb->process_id;
+        records[i].process_state = pcb->process_state;
+        records[i].process_memory = get_checkpoint_index(
+            pcb->process_memory, proc_mem_index
+            );
+        records[i].priority = pcb->priority;
+        records[i].job_time = pcb->job_time;
+        records[i].burst_time = pcb->burst_time;
+        records[i].cpu_time = pcb->cpu_time;
+        records[i].cpu = pcb->cpu;
+        records[i].metrics = pcb->metrics;
+        records[i].tickets = pcb->tickets;
+        records[i].vruntime = pcb->vruntime;
+        records[i].tree_left = get_checkpoint_index(pcb->tree_left, pcb_index);
+        records[i].tree_right = get_checkpoint_index(pcb->tree_right, pcb_index);
+        records[i].tree_parent = get_checkpoint_index(pcb->tree_parent, pcb_index);
+        records[i].tree_red = pcb->tree_red;
+    }
+
+    write_checkpoint_section(fp, pcbs_section, records,
+        sizeof(checkpoint_pcb_t), len, header);
+    free(records);
+
+    return;
+}
+
+void write_checkpoint_process_memories(FILE *fp,
+    process_memories_list_t *proc_mems_list, process_memory_t *proc_mems[],
+    int len, checkpoint_index_t *proc_mem_index, checkpoint_header_t *header)
+{
+    checkpoint_process_memory_t *records;
+    checkpoint_page_frame_t *frame_records;
+    int *page_table_records, *heap_records;
+    process_memory_t *proc_mem;
+    page_frames_t *page_frames = proc_mems_list->page_frames;
+    int i, page_tables_len = 0, frames_len;
+
+    for (i = 0; i < len; i++)
+    {
+        page_tables_len += (proc_mems[i]->page_table != NULL) ? proc_mems[i]->pages : 0;
+    }
+    frames_len = (page_frames != NULL) ? page_frames->len : 0;
+
+    // Allocate memory for records and error check.
+    records = (checkpoint_process_memory_t*)malloc(sizeof(checkpoint_process_memory_t) * (len + 1));
+    page_table_records = (int*)malloc(sizeof(int) * (page_tables_len + 1));
+    heap_records = (int*)malloc(sizeof(int) * (proc_mems_list->resident_heap_len + 1));
+    frame_records = (checkpoint_page_frame_t*)malloc(sizeof(checkpoint_page_frame_t) * (frames_len + 1));
+    if (records == NULL || page_table_records == NULL || heap_records == NULL ||
+        frame_records == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set records of each process memory and its page table, in list order.
+    page_tables_len = 0;
+    for (i = 0; i < len; i++)
+    {
+        proc_mem = proc_mems[i];
+        records[i].start_address = proc_mem->start_address;
+        records[i].size = proc_mem->size;
+        records[i].swap_in_time = proc_mem->swap_in_time;
+        records[i].process_id = proc_mem->process_id;
+        records[i].sequence = proc_mem->sequence;
+        records[i].heap_index = proc_mem->heap_index;
+        records[i].swap_count = proc_mem->swap_count;
+        records[i].pinned = proc_mem->pinned;
+        records[i].page_table = NO_CHECKPOINT_INDEX;
+        records[i].pages = proc_mem->pages;
+        records[i].resident_pages = proc_mem->resident_pages;
+        records[i].next_page = proc_mem->next_page;
+        records[i].resident_prev = get_checkpoint_index(
+            proc_mem->resident_prev, proc_mem_index
+            );
+        records[i].resident_next = get_checkpoint_index(
+            proc_mem->resident_next, proc_mem_index
+            );
+        records[i].referenced = proc_mem->referenced;
+        records[i].eviction_value = proc_mem->eviction_value;
+        if (proc_mem->page_table != NULL)
+        {
+            records[i].page_table = page_tables_len;
+            memcpy(&page_table_records[page_tables_len], proc_mem->page_table,
+                sizeof(int) * proc_mem->pages);
+            page_tables_len += proc_mem->pages;
+        }
+    }
+    for (i = 0; i < proc_mems_list->resident_heap_len; i++)
+    {
+        heap_records[i] = get_checkpoint_index(
+            proc_mems_list->resident_heap[i], proc_mem_index
+            );
+    }
+    for (i = 0; i < frames_len; i++)
+    {
+        frame_records[i].owner = get_checkpoint_index(
+            page_frames->owners[i], proc_mem_index
+            );
+        frame_records[i].page = page_frames->pages[i];
+        frame_records[i].referenced = page_frames->referenced[i];
+    }
+
+    header->next_sequence = proc_mems_list->next_sequence;
+    header->resident_head = get_checkpoint_index(
+        proc_mems_list->resident_head, proc_mem_index
+        );
+    header->resident_tail = get_checkpoint_index(
+        proc_mems_list->resident_tail, proc_mem_index
+        );
+    header->clock_hand = get_checkpoint_index(
+        proc_mems_list->clock_hand, proc_mem_index
+        );
+    header->resident_count = proc_mems_list->resident_count;
+    header->resident_size = proc_mems_list->resident_size;
+    header->pinned_count = proc_mems_list->pinned_count;
+    header->eviction_inflation = proc_mems_list->eviction_inflation;
+    if (page_frames != NULL)
+    {
+        header->frames_clock_hand = page_frames->clock_hand;
+        header->free_runs = page_frames->free_runs;
+        header->page_faults = page_frames->page_faults;
+        header->page_outs = page_frames->page_outs;
+    }
+
+    write_checkpoint_section(fp, process_memories_section, records,
+        sizeof(checkpoint_process_memory_t), len, header);
+    write_checkpoint_section(fp, page_tables_section, page_table_records,
+        sizeof(int), page_tables_len, header);
+    write_checkpoint_section(fp, resident_heap_section, heap_records,
+        sizeof(int), proc_mems_list->resident_heap_len, header);
+    write_checkpoint_section(fp, page_frames_section, frame_records,
+        sizeof(checkpoint_page_frame_t), frames_len, header);
+    write_checkpoint_section(fp, free_frames_section,
+        (page_frames != NULL) ? page_frames->free_frames : NULL, sizeof(int),
+        (page_frames != NULL) ? page_frames->free_len : 0, header);
+
+    free(records);
+    free(page_table_records);
+    free(heap_records);
+    free(frame_records);
+
+    return;
+}
+
+void write_checkpoint_memory_segments(FILE *fp,
+    free_memory_segments_list_t *mem_segs_list,
+    free_memory_segment_t *mem_segs[], int len,
+    checkpoint_index_t *mem_seg_index, checkpoint_header_t *header)
+{
+    checkpoint_memory_segment_t *records;
+    unsigned long *words = NULL;
+    free_memory_segment_t *mem_seg;
+    buddy_allocator_t *buddy = mem_segs_list->buddy;
+    long words_len = 0;
+    int i;
+
+    // Allocate memory for records and error check.
+    records = (checkpoint_memory_segment_t*)malloc(sizeof(checkpoint_memory_segment_t) * (len + 1));
+    if (records == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set records of each free memory segment, in list order.
+    for (i = 0; i < len; i++)
+    {
+        mem_seg = mem_segs[i];
+        records[i].start_address = mem_seg->start_address;
+        records[i].size = mem_seg->size;
+        records[i].address_left = get_checkpoint_index(
+            mem_seg->address_left, mem_seg_index
+            );
+        records[i].address_right = get_checkpoint_index(
+            mem_seg->address_right, mem_seg_index
+            );
+        records[i].size_left = get_checkpoint_index(
+            mem_seg->size_left, mem_seg_index
+            );
+        records[i].size_right = get_checkpoint_index(
+            mem_seg->size_right, mem_seg_index
+            );
+        records[i].tree_priority = mem_seg->tree_priority;
+        records[i].max_subtree_size = mem_seg->max_subtree_size;
+    }
+    header->address_root = get_checkpoint_index(
+        mem_segs_list->address_root, mem_seg_index
+        );
+    header->size_root = get_checkpoint_index(
+        mem_segs_list->size_root, mem_seg_index
+        );
+    header->tree_seed = mem_segs_list->tree_seed;
+    header->count = mem_segs_list->count;
+    header->compactions = mem_segs_list->compactions;
+    header->compacted_size = mem_segs_list->compacted_size;
+
+    // Or the bitmaps of the buddy allocator, if buddy fit.
+    if (buddy != NULL)
+    {
+        words_len = copy_checkpoint_buddy_words(buddy, NULL, 0);
+        words = (unsigned long*)malloc(sizeof(unsigned long) * words_len);
+        if (words == NULL)
+        {
+            perror("malloc");
+            exit(1);
+        }
+        copy_checkpoint_buddy_words(buddy, words, 0);
+        header->free_blocks = buddy->free_blocks;
+        header->allocated_size = buddy->allocated_size;
+        header->allocated_block_size = buddy->allocated_block_size;
+    }
+
+    write_checkpoint_section(fp, memory_segments_section, records,
+        sizeof(checkpoint_memory_segment_t), len, header);
+    write_checkpoint_section(fp, buddy_words_section, words,
+        sizeof(unsigned long), words_len, header);
+
+    free(records);
+    free(words);
+
+    return;
+}
+
+scheduler_state_t *restore_checkpoint(char filename[],
+    scheduled_process_source_t *source, scheduler_options_t *options,
+    simulation_summary_t *summary)
+{
+    int fd;
+    struct stat st;
+    char *map;
+    size_t map_len;
+    checkpoint_header_t *header;
+    scheduler_state_t *state;
+    process_control_block_t **pcbs;
+    process_memory_t **proc_mems;
+    simulation_metrics_t *metrics = options->metrics;
+    scheduled_process_t *next;
+    int *turnaround_times, *response_times;
+    long i, pcbs_len, proc_mems_len, metrics_len;
+
+    // Map checkpoint file and error check.
+    fd = open(filename, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        perror("open");
+        exit(1);
+    }
+    map_len = st.st_size;
+    if (map_len < sizeof(checkpoint_header_t))
+    {
+        fprintf(stderr, "Invalid checkpoint\n");
+        exit(1);
+    }
+    map = (char*)mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        perror("mmap");
+        exit(1);
+    }
+    close(fd);
+
+    // Check header.
+    header = (checkpoint_header_t*)map;
+    if (memcmp(header->magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LEN) != 0 ||
+        header->version != CHECKPOINT_VERSION ||
+        header->byte_order != CHECKPOINT_BYTE_ORDER ||
+        header->header_len != sizeof(checkpoint_header_t))
+    {
+        fprintf(stderr, "Invalid checkpoint\n");
+        exit(1);
+    }
+    if (!is_checkpoint_matching_options(header, options))
+    {
+        fprintf(stderr, "Checkpoint does not match options\n");
+        exit(1);
+    }
+
+    // Take what the run had already taken from the source, up to the next.
+    i = 0;
+    while (i < header->taken && take_scheduled_process(source, NULL))
+    {
+        i++;
+    }
+    next = peek_scheduled_process(source);
+    if (i < header->taken || header->has_next != (next != NULL) ||
+        (next != NULL && memcmp(next, &header->next, sizeof(scheduled_process_t)) != 0))
+    {
+        fprintf(stderr, "Checkpoint does not match scheduled processes\n");
+        exit(1);
+    }
+
+    // Restore onto the state of a new run.
+    state = new_scheduler_state(options);
+    state->time = header->time;
+    state->next_boost_time = header->next_boost_time;
+    *summary = header->summary;
+    if (options->event_log != NULL)
+    {
+        options->event_log->holes_count = header->holes_count;
+    }
+
+    // Allocate every object first, so pointers between them can be set.
+    get_checkpoint_section(map, map_len, process_memories_section,
+        sizeof(checkpoint_process_memory_t), header);
+    get_checkpoint_section(map, map_len, pcbs_section,
+        sizeof(checkpoint_pcb_t), header);
+    proc_mems_len = header->section_lens[process_memories_section];
+    pcbs_len = header->section_lens[pcbs_section];
+    proc_mems = (process_memory_t**)malloc(sizeof(process_memory_t*) * (proc_mems_len + 1));
+    pcbs = (process_control_block_t**)malloc(sizeof(process_control_block_t*) * (pcbs_len + 1));
+    if (proc_mems == NULL || pcbs == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    for (i = 0; i < proc_mems_len; i++)
+    {
+        proc_mems[i] = new_process_memory(0, 0, state->proc_mems_list);
+    }
+    for (i = 0; i < pcbs_len; i++)
+    {
+        pcbs[i] = (process_control_block_t*)allocate_from_object_pool(
+            state->pcb_pool
+            );
+    }
+
+    read_checkpoint_process_memories(
+        map, map_len, header, state->proc_mems_list, proc_mems, proc_mems_len
+        );
+    read_checkpoint_pcbs(
+        map, map_len, header, pcbs, pcbs_len, proc_mems, proc_mems_len
+        );
+    read_checkpoint_cpus(map, map_len, header, state, pcbs, pcbs_len, options);
+    read_checkpoint_memory_segments(map, map_len, header, state->mem_segs_list);
+
+    // Metrics of processes finished before the checkpoint, if recorded.
+    metrics_len = header->section_lens[turnaround_times_section];
+    turnaround_times = (int*)get_checkpoint_section(
+        map, map_len, turnaround_times_section, sizeof(int), header
+        );
+    response_times = (int*)get_checkpoint_section(
+        map, map_len, response_times_section, sizeof(int), header
+        );
+    if (metrics != NULL && header->has_metrics &&
+        header->section_lens[response_times_section] == metrics_len)
+    {
+        if (metrics_len > metrics->max_len)
+        {
+            metrics->max_len = metrics_len;
+            metrics->turnaround_times = (int*)realloc(metrics->turnaround_times, sizeof(int) * metrics->max_len);
+            metrics->response_times = (int*)realloc(metrics->response_times, sizeof(int) * metrics->max_len);
+            if (metrics->turnaround_times == NULL || metrics->response_times == NULL)
+            {
+                perror("realloc");
+                exit(1);
+            }
+        }
+        memcpy(metrics->turnaround_times, turnaround_times, sizeof(int) * metrics_len);
+        memcpy(metrics->response_times, response_times, sizeof(int) * metrics_len);
+        metrics->len = metrics_len;
+        metrics->total_wait_time = header->total_wait_time;
+        metrics->total_swap_count = header->total_swap_count;
+        metrics->max_wait_time = header->max_wait_time;
+        metrics->max_swap_count = header->max_swap_count;
+    }
+
+    free(proc_mems);
+    free(pcbs);
+    munmap(map, map_len);
+
+    return state;
+}
+
+void read_checkpoint_process_memories(const char *map, size_t map_len,
+    checkpoint_header_t *header, process_memories_list_t *proc_mems_list,
+    process_memory_t *proc_mems[], int len)
+{
+    checkpoint_process_memory_t *records;
+    checkpoint_page_frame_t *frame_records;
+    int *page_table_records, *heap_records, *free_frames;
+    process_memory_t *proc_mem;
+    page_frames_t *page_frames = proc_mems_list->page_frames;
+    long page_tables_len, heap_len, frames_len, free_len;
+    int i;
+
+    records = (checkpoint_process_memory_t*)get_checkpoint_section(
+        map, map_len, process_memories_section,
+        sizeof(checkpoint_process_memory_t), header
+        );
+    page_table_records = (int*)get_checkpoint_section(
+        map, map_len, page_tables_section, sizeof(int), header
+        );
+    heap_records = (int*)get_checkpoint_section(
+        map, map_len, resident_heap_section, sizeof(int), header
+        );
+    frame_records = (checkpoint_page_frame_t*)get_checkpoint_section(
+        map, map_len, page_frames_section, sizeof(checkpoint_page_frame_t),
+        header
+        );
+    free_frames = (int*)get_checkpoint_section(
+        map, map_len, free_frames_section, sizeof(int), header
+        );
+    page_tables_len = header->section_lens[page_tables_section];
+    heap_len = header->section_lens[resident_heap_section];
+    frames_len = header->section_lens[page_frames_section];
+    free_len = header->section_lens[free_frames_section];
+
+    // Set each process memory and its page table, and append it in list order.
+    for (i = 0; i < len; i++)
+    {
+        proc_mem = proc_mems[i];
+        proc_mem->start_address = records[i].start_address;
+        proc_mem->size = records[i].size;
+        proc_mem->swap_in_time = records[i].swap_in_time;
+        proc_mem->process_id = records[i].process_id;
+        proc_mem->sequence = records[i].sequence;
+        proc_mem->heap_index = records[i].heap_index;
+        proc_mem->swap_count = records[i].swap_count;
+        proc_mem->pinned = records[i].pinned;
+        proc_mem->pages = records[i].pages;
+        proc_mem->resident_pages = records[i].resident_pages;
+        proc_mem->next_page = records[i].next_page;
+        proc_mem->resident_prev = (process_memory_t*)get_checkpoint_object(
+            records[i].resident_prev, (void**)proc_mems, len
+            );
+        proc_mem->resident_next = (process_memory_t*)get_checkpoint_object(
+            records[i].resident_next, (void**)proc_mems, len
+            );
+        proc_mem->referenced = records[i].referenced;
+        proc_mem->eviction_value = records[i].eviction_value;
+        if (records[i].page_table != NO_CHECKPOINT_INDEX)
+        {
+            if (records[i].page_table < 0 || records[i].pages < 1 ||
+                records[i].page_table + (long)records[i].pages > page_tables_len)
+            {
+                fprintf(stderr, "Invalid checkpoint\n");
+                exit(1);
+            }
+            proc_mem->page_table = (int*)malloc(sizeof(int) * proc_mem->pages);
+            if (proc_mem->page_table == NULL)
+            {
+                perror("malloc");
+                exit(1);
+            }
+            memcpy(proc_mem->page_table, &page_table_records[records[i].page_table],
+                sizeof(int) * proc_mem->pages);
+        }
+        append_process_memory_to_process_memories_list(proc_mem, proc_mems_list);
+    }
+
+    // Set the resident heap, grown to fit.
+    if (heap_len > proc_mems_list->resident_heap_max_len)
+    {
+        proc_mems_list->resident_heap_max_len = heap_len;
+        proc_mems_list->resident_heap = (process_memory_t**)realloc(proc_mems_list->resident_heap, sizeof(process_memory_t*) * proc_mems_list->resident_heap_max_len);
+        if (proc_mems_list->resident_heap == NULL)
+        {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    for (i = 0; i < heap_len; i++)
+    {
+        proc_mems_list->resident_heap[i] = (process_memory_t*)get_checkpoint_object(
+            heap_records[i], (void**)proc_mems, len
+            );
+    }
+    proc_mems_list->resident_heap_len = heap_len;
+    proc_mems_list->next_sequence = header->next_sequence;
+    proc_mems_list->resident_head = (process_memory_t*)get_checkpoint_object(
+        header->resident_head, (void**)proc_mems, len
+        );
+    proc_mems_list->resident_tail = (process_memory_t*)get_checkpoint_object(
+        header->resident_tail, (void**)proc_mems, len
+        );
+    proc_mems_list->clock_hand = (process_memory_t*)get_checkpoint_object(
+        header->clock_hand, (void**)proc_mems, len
+        );
+    proc_mems_list->resident_count = header->resident_count;
+    proc_mems_list->resident_size = header->resident_size;
+    proc_mems_list->pinned_count = header->pinned_count;
+    proc_mems_list->eviction_inflation = header->eviction_inflation;
+
+    // Set page frames, if paged.
+    if (page_frames == NULL)
+    {
+        return;
+    }
+    if (frames_len != page_frames->len || free_len > page_frames->len)
+    {
+        fprintf(stderr, "Invalid checkpoint\n");
+        exit(1);
+    }
+    for (i = 0; i < frames_len; i++)
+    {
+        page_frames->owners[i] = (process_memory_t*)get_checkpoint_object(
+            frame_records[i].owner, (void**)proc_mems, len
+            );
+        page_frames->pages[i] = frame_records[i].page;
+        page_frames->referenced[i] = frame_records[i].referenced;
+    }
+    memcpy(page_frames->free_frames, free_frames, sizeof(int) * free_len);
+    page_frames->free_len = free_len;
+    page_frames->free_runs = header->free_runs;
+    page_frames->clock_hand = header->frames_clock_hand;
+    page_frames->page_faults = header->page_faults;
+    page_frames->page_outs = header->page_outs;
+
+    return;
+}
+
+void read_checkpoint_pcbs(const char *map, size_t map_len,
+    checkpoint_header_t *header, process_control_block_t *pcbs[], int len,
+    process_memory_t *proc_mems[], int proc_mems_len)
+{
+    checkpoint_pcb_t *records;
+    process_control_block_t *pcb;
+    int i;
+
+    records = (checkpoint_pcb_t*)get_checkpoint_section(
+        map, map_len, pcbs_section, sizeof(checkpoint_pcb_t), header
+        );
+
+    for (i = 0; i < len; i++)
+    {
+        pcb = pcbs[i];
+        pcb->next = (process_control_block_t*)get_checkpoint_object(
+            records[i].next, (void**)pcbs, len
+            );
+        pcb->prev = (process_control_block_t*)get_checkpoint_object(
+            records[i].prev, (void**)pcbs, len
+            );
+        pcb->process_id = records[i].process_id;
+        pcb->process_state = records[i].process_state;
+        pcb->process_memory = (process_memory_t*)get_checkpoint_object(
+            records[i].process_memory, (void**)proc_mems, proc_mems_len
+            );
+        pcb->priority = records[i].priority;
+        pcb->job_time = records[i].job_time;
+        pcb->burst_time = records[i].burst_time;
+        pcb->cpu_time = records[i].cpu_time;
+        pcb->cpu = records[i].cpu;
+        pcb->metrics = records[i].metrics;
+        pcb->tickets = records[i].tickets;
+        pcb->vruntime = records[i].vruntime;
+        pcb->tree_left = (process_control_block_t*)get_checkpoint_object(
+            records[i].tree_left, (void**)pcbs, len
+            );
+        pcb->tree_right = (process_control_block_t*)get_checkpoint_object(
+            records[i].tree_right, (void**)pcbs, len
+            );
+        pcb->tree_parent = (process_control_block_t*)get_checkpoint_object(
+            records[i].tree_parent, (void**)pcbs, len
+            );
+        pcb->tree_red = records[i].tree_red;
+
+        // Every pcb has its process memory.
+        if (pcb->process_memory == NULL)
+        {
+            fprintf(stderr, "Invalid checkpoint\n");
+            exit(1);
+        }
+    }
+
+    return;
+}
+
+void read_checkpoint_cpus(const char *map, size_t map_len,
+    checkpoint_header_t *header, scheduler_state_t *state,
+    process_control_block_t *pcbs[], int pcbs_len,
+    scheduler_options_t *options)
+{
+    checkpoint_cpu_t *cpu_records;
+    checkpoint_pcbs_queue_t *queue_records;
+    int *heap_records;
+    tlb_entry_t *tlb_records;
+    cpu_t *cpu;
+    long heaps_len = 0, tlbs_len = 0;
+    int i, j;
+
+    cpu_records = (checkpoint_cpu_t*)get_checkpoint_section(
+        map, map_len, cpus_section, sizeof(checkpoint_cpu_t), header
+        );
+    queue_records = (checkpoint_pcbs_queue_t*)get_checkpoint_section(
+        map, map_len, ready_qs_section, sizeof(checkpoint_pcbs_queue_t), header
+        );
+    heap_records = (int*)get_checkpoint_section(
+        map, map_len, ready_heaps_section, sizeof(int), header
+        );
+    tlb_records = (tlb_entry_t*)get_checkpoint_section(
+        map, map_len, tlb_entries_section, sizeof(tlb_entry_t), header
+        );
+    for (i = 0; i < state->cpus_len; i++)
+    {
+        heaps_len += (cpu_records[i].ready_heap_len > 0) ? cpu_records[i].ready_heap_len : 0;
+        tlbs_len += (state->cpus[i].tlb != NULL) ? options->tlb_entries : 0;
+    }
+    if (header->section_lens[cpus_section] != state->cpus_len ||
+        header->section_lens[ready_qs_section] != state->cpus_len * options->levels ||
+        header->section_lens[ready_heaps_section] != heaps_len ||
+        header->section_lens[tlb_entries_section] != tlbs_len)
+    {
+        fprintf(stderr, "Invalid checkpoint\n");
+        exit(1);
+    }
+
+    // Set each CPU, its ready queues, ready heap and tlb.
+    heaps_len = 0;
+    tlbs_len = 0;
+    for (i = 0; i < state->cpus_len; i++)
+    {
+        cpu = &state->cpus[i];
+        cpu->running = (process_control_block_t*)get_checkpoint_object(
+            cpu_records[i].running, (void**)pcbs, pcbs_len
+            );
+        cpu->waiting = cpu_records[i].waiting;
+        cpu->ready_tree = (process_control_block_t*)get_checkpoint_object(
+            cpu_records[i].ready_tree, (void**)pcbs, pcbs_len
+            );
+        cpu->min_vruntime = cpu_records[i].min_vruntime;
+        cpu->tickets = cpu_records[i].tickets;
+        cpu->random_state = cpu_records[i].random_state;
+        cpu->migration_time = cpu_records[i].migration_time;
+
+        for (j = 0; j < cpu->levels; j++)
+        {
+            cpu->ready_qs[j]->head = (process_control_block_t*)get_checkpoint_object(
+                queue_records[i * cpu->levels + j].head, (void**)pcbs, pcbs_len
+                );
+            cpu->ready_qs[j]->tail = (process_control_block_t*)get_checkpoint_object(
+                queue_records[i * cpu->levels + j].tail, (void**)pcbs, pcbs_len
+                );
+            cpu->ready_qs[j]->len = queue_records[i * cpu->levels + j].len;
+        }
+
+        cpu->ready_heap_len = cpu_records[i].ready_heap_len;
+        if (cpu->ready_heap_len > 0)
+        {
+            cpu->ready_heap_max_len = cpu->ready_heap_len;
+            cpu->ready_heap = (process_control_block_t**)malloc(sizeof(process_control_block_t*) * cpu->ready_heap_max_len);
+            if (cpu->ready_heap == NULL)
+            {
+                perror("malloc");
+                exit(1);
+            }
+        }
+        for (j = 0; j < cpu->ready_heap_len; j++)
+        {
+            cpu->ready_heap[j] = (process_control_block_t*)get_checkpoint_object(
+                heap_records[heaps_len++], (void**)pcbs, pcbs_len
+                );
+        }
+
+        if (cpu->tlb != NULL)
+        {
+            memcpy(cpu->tlb->entries, &tlb_records[tlbs_len],
+                sizeof(tlb_entry_t) * options->tlb_entries);
+            tlbs_len += options->tlb_entries;
+            cpu->tlb->clock = cpu_records[i].tlb_clock;
+            cpu->tlb->hits = cpu_records[i].tlb_hits;
+            cpu->tlb->misses = cpu_records[i].tlb_misses;
+        }
+    }
+
+    return;
+}
+
+void read_checkpoint_memory_segments(const char *map, size_t map_len,
+    checkpoint_header_t *header, free_memory_segments_list_t *mem_segs_list)
+{
+    checkpoint_memory_segment_t *records;
+    unsigned long *words;
+    free_memory_segment_t **mem_segs, *mem_seg;
+    buddy_allocator_t *buddy = mem_segs_list->buddy;
+    long len = header->section_lens[memory_segments_section];
+    int i;
+
+    records = (checkpoint_memory_segment_t*)get_checkpoint_section(
+        map, map_len, memory_segments_section,
+        sizeof(checkpoint_memory_segment_t), header
+        );
+    words = (unsigned long*)get_checkpoint_section(
+        map, map_len, buddy_words_section, sizeof(unsigned long), header
+        );
+
+    // Release the free memory segments of the new run's (all free) memory.
+    while (mem_segs_list->head != NULL)
+    {
+        mem_seg = mem_segs_list->head;
+        mem_segs_list->head = mem_seg->next;
+        release_to_object_pool(mem_seg, mem_segs_list->mem_seg_pool);
+    }
+
+    // Allocate memory for free memory segments and error check.
+    mem_segs = (free_memory_segment_t**)malloc(sizeof(free_memory_segment_t*) * (len + 1));
+    if (mem_segs == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    for (i = 0; i < len; i++)
+    {
+        mem_segs[i] = new_free_memory_segment(
+            records[i].start_address, records[i].size, mem_segs_list
+            );
+    }
+
+    // Set each free memory segment, linked in list order and into its trees.
+    for (i = 0; i < len; i++)
+    {
+        mem_seg = mem_segs[i];
+        mem_seg->next = (i + 1 < len) ? mem_segs[i + 1] : NULL;
+        mem_seg->prev = (i > 0) ? mem_segs[i - 1] : NULL;
+        mem_seg->address_left = (free_memory_segment_t*)get_checkpoint_object(
+            records[i].address_left, (void**)mem_segs, len
+            );
+        mem_seg->address_right = (free_memory_segment_t*)get_checkpoint_object(
+            records[i].address_right, (void**)mem_segs, len
+            );
+        mem_seg->size_left = (free_memory_segment_t*)get_checkpoint_object(
+            records[i].size_left, (void**)mem_segs, len
+            );
+        mem_seg->size_right = (free_memory_segment_t*)get_checkpoint_object(
+            records[i].size_right, (void**)mem_segs, len
+            );
+        mem_seg->tree_priority = records[i].tree_priority;
+        mem_seg->max_subtree_size = records[i].max_subtree_size;
+    }
+    mem_segs_list->head = (len > 0) ? mem_segs[0] : NULL;
+    mem_segs_list->address_root = (free_memory_segment_t*)get_checkpoint_object(
+        header->address_root, (void**)mem_segs, len
+        );
+    mem_segs_list->size_root = (free_memory_segment_t*)get_checkpoint_object(
+        header->size_root, (void**)mem_segs, len
+        );
+    mem_segs_list->tree_seed = header->tree_seed;
+    mem_segs_list->count = header->count;
+    mem_segs_list->compactions = header->compactions;
+    mem_segs_list->compacted_size = header->compacted_size;
+    free(mem_segs);
+
+    // Or the bitmaps of the buddy allocator, if buddy fit.
+    if (buddy != NULL)
+    {
+        if (header->section_lens[buddy_words_section] !=
+            copy_checkpoint_buddy_words(buddy, NULL, 0))
+        {
+            fprintf(stderr, "Invalid checkpoint\n");
+            exit(1);
+        }
+        copy_checkpoint_buddy_words(buddy, words, 1);
+        buddy->free_blocks = header->free_blocks;
+        buddy->allocated_size = header->allocated_size;
+        buddy->allocated_block_size = header->allocated_block_size;
+    }
+
+    return;
+}
+
+int is_checkpoint_matching_options(checkpoint_header_t *header,
+    scheduler_options_t *options)
+{
+    return (
+        strncmp(header->scheduling_policy, options->scheduling_policy->name,
+            CHECKPOINT_NAME_LEN) == 0 &&
+        strncmp(header->eviction_policy, options->eviction_policy->name,
+            CHECKPOINT_NAME_LEN) == 0 &&
+        header->memsize == options->memsize &&
+        (header->fit_policy == buddy_fit) == (options->fit_policy == buddy_fit) &&
+        header->levels == options->levels &&
+        header->cpus == options->cpus &&
+        header->page_size == options->page_size &&
+        (options->page_size == 0 || (header->tlb_entries == options->tlb_entries &&
+            header->tlb_ways == options->tlb_ways))
+        );
+}
+
+int get_checkpoint_pcbs(cpu_t cpus[], int len, process_control_block_t ***pcbs)
+{
+    int pcbs_len = add_checkpoint_pcbs(cpus, len, NULL);
+
+    // Allocate memory for pcbs and error check.
+    *pcbs = (process_control_block_t**)malloc(sizeof(process_control_block_t*) * (pcbs_len + 1));
+    if (*pcbs == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    add_checkpoint_pcbs(cpus, len, *pcbs);
+
+    return pcbs_len;
+}
+
+int add_checkpoint_pcbs(cpu_t cpus[], int len, process_control_block_t *pcbs[])
+{
+    process_control_block_t *pcb;
+    int i, j, pcbs_len = 0;
+
+    // Every pcb is running on or waiting for a CPU.
+    for (i = 0; i < len; i++)
+    {
+        if (cpus[i].running != NULL)
+        {
+            pcbs_len = add_checkpoint_pcb(cpus[i].running, pcbs, pcbs_len);
+        }
+        for (j = 0; j < cpus[i].levels; j++)
+        {
+            for (pcb = cpus[i].ready_qs[j]->head; pcb != NULL; pcb = pcb->next)
+            {
+                pcbs_len = add_checkpoint_pcb(pcb, pcbs, pcbs_len);
+            }
+        }
+        for (j = 0; j < cpus[i].ready_heap_len; j++)
+        {
+            pcbs_len = add_checkpoint_pcb(cpus[i].ready_heap[j], pcbs, pcbs_len);
+        }
+        pcbs_len = add_checkpoint_ready_tree_pcbs(cpus[i].ready_tree, pcbs, pcbs_len);
+    }
+
+    return pcbs_len;
+}
+
+int add_checkpoint_pcb(process_control_block_t *pcb,
+    process_control_block_t *pcbs[], int len)
+{
+    if (pcbs != NULL)
+    {
+        pcbs[len] = pcb;
+    }
+    return len + 1;
+}
+
+int add_checkpoint_ready_tree_pcbs(process_control_block_t *root,
+    process_control_block_t *pcbs[], int len)
+{
+    if (root == NULL)
+    {
+        return len;
+    }
+
+    len = add_checkpoint_pcb(root, pcbs, len);
+    len = add_checkpoint_ready_tree_pcbs(root->tree_left, pcbs, len);
+    return add_checkpoint_ready_tree_pcbs(root->tree_right, pcbs, len);
+}
+
+checkpoint_index_t *new_checkpoint_index(void *objects[], int len)
+{
+    checkpoint_index_t *index;
+    int i;
+
+    // Allocate memory for index and error check.
+    index = (checkpoint_index_t*)malloc(sizeof(checkpoint_index_t));
+    if (index != NULL)
+    {
+        index->entries = (checkpoint_index_entry_t*)malloc(sizeof(checkpoint_index_entry_t) * (len + 1));
+    }
+    if (index == NULL || index->entries == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Sort objects by address, to look up their indexes by.
+    for (i = 0; i < len; i++)
+    {
+        index->entries[i].object = objects[i];
+        index->entries[i].index = i;
+    }
+    index->len = len;
+    qsort(index->entries, len, sizeof(checkpoint_index_entry_t),
+        compare_checkpoint_index_entries);
+
+    return index;
+}
+
+int get_checkpoint_index(const void *object, checkpoint_index_t *index)
+{
+    checkpoint_index_entry_t key, *entry;
+
+    /* Pointers left behind in unused links (e.g. the next pcb of a running
+     * one) may not be to an indexed object, and are never followed.
+     */
+    key.object = object;
+    entry = (object == NULL) ? NULL : (checkpoint_index_entry_t*)bsearch(
+        &key, index->entries, index->len, sizeof(checkpoint_index_entry_t),
+        compare_checkpoint_index_entries
+        );
+
+    return (entry != NULL) ? entry->index : NO_CHECKPOINT_INDEX;
+}
+
+int compare_checkpoint_index_entries(const void *a, const void *b)
+{
+    const void *object = ((checkpoint_index_entry_t*)a)->object;
+    const void *other_object = ((checkpoint_index_entry_t*)b)->object;
+
+    return (object > other_object) - (object < other_object);
+}
+
+void free_checkpoint_index(checkpoint_index_t *index)
+{
+    free(index->entries);
+    free(index);
+    return;
+}
+
+void *get_checkpoint_object(int index, void *objects[], int len)
+{
+    if (index == NO_CHECKPOINT_INDEX)
+    {
+        return NULL;
+    }
+    if (index < 0 || index >= len)
+    {
+        fprintf(stderr, "Invalid checkpoint\n");
+        exit(1);
+    }
+
+    return objects[index];
+}
+
+void write_checkpoint_section(FILE *fp, enum checkpoint_section_t section,
+    const void *records, size_t record_len, long len,
+    checkpoint_header_t *header)
+{
+    char padding[CHECKPOINT_ALIGNMENT] = { 0 };
+    long offset = ftell(fp);
+
+    // Pad to the next aligned offset.
+    if (offset % CHECKPOINT_ALIGNMENT != 0)
+    {
+        fwrite(padding, 1, CHECKPOINT_ALIGNMENT - offset % CHECKPOINT_ALIGNMENT, fp);
+        offset += CHECKPOINT_ALIGNMENT - offset % CHECKPOINT_ALIGNMENT;
+    }
+
+    if (len > 0)
+    {
+        fwrite(records, record_len, len, fp);
+    }
+    header->section_offsets[section] = offset;
+    header->section_lens[section] = len;
+
+    return;
+}
+
+void *get_checkpoint_section(const char *map, size_t map_len,
+    enum checkpoint_section_t section, size_t record_len,
+    checkpoint_header_t *header)
+{
+    long offset = header->section_offsets[section];
+    long len = header->section_lens[section];
+
+    if (offset < (long)sizeof(checkpoint_header_t) ||
+        offset % CHECKPOINT_ALIGNMENT != 0 || len < 0 ||
+        (size_t)offset > map_len || len > (long)((map_len - offset) / record_len))
+    {
+        fprintf(stderr, "Invalid checkpoint\n");
+        exit(1);
+    }
+
+    return (void*)(map + offset);
+}
+
+long copy_checkpoint_buddy_words(buddy_allocator_t *buddy,
+    unsigned long words[], int restoring)
+{
+    buddy_free_bitmap_t *bitmap;
+    int order, level, len;
+    long words_len = 0;
+
+    // Each level's words, as allocated by new_buddy_allocator.
+    for (order = 0; order <= buddy->max_order; order++)
+    {
+        bitmap = &buddy->free_bitmaps[order];
+        len = (buddy->size >> order) / BUDDY_BITMAP_WORD_BITS + 1;
+        for (level = 0; level < bitmap->levels; level++)
+        {
+            if (words != NULL && restoring)
+            {
+                memcpy(bitmap->words[level], &words[words_len], sizeof(unsigned long) * len);
+            }
+            else if (words != NULL)
+            {
+                memcpy(&words[words_len], bitmap->words[level], sizeof(unsigned long) * len);
+            }
+            words_len += len;
+            len = len / BUDDY_BITMAP_WORD_BITS + 1;
+        }
+    }
+
+    return words_len;
+}
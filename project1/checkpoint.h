@@ -0,0 +1,313 @@
+/*
+ * checkpoint.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* A checkpoint is a header followed by sections of fixed width records, in the
+ * byte order and layout of the machine that saved it. Each section starts at
+ * an offset aligned to CHECKPOINT_ALIGNMENT, so it is read in place once the
+ * file is mapped. Pointers between objects are saved as the index of the
+ * pointed to object's record, NO_CHECKPOINT_INDEX for NULL.
+ */
+#define CHECKPOINT_MAGIC       "SCKP"
+#define CHECKPOINT_MAGIC_LEN   4
+#define CHECKPOINT_VERSION     1
+#define CHECKPOINT_BYTE_ORDER  0x01020304
+#define CHECKPOINT_ALIGNMENT   8
+#define NO_CHECKPOINT_INDEX    -1
+// Longest scheduling or eviction policy name, with its terminator.
+#define CHECKPOINT_NAME_LEN    16
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Sections of a checkpoint, in the order they are saved. */
+enum checkpoint_section_t
+{
+    cpus_section,              // checkpoint_cpu_t of each CPU.
+    ready_qs_section,          // checkpoint_pcbs_queue_t of each CPU's levels.
+    ready_heaps_section,       // Pcb indexes of each CPU's ready heap.
+    tlb_entries_section,       // tlb_entry_t of each CPU's tlb, if paged.
+    pcbs_section,              // checkpoint_pcb_t of each pcb.
+    process_memories_section,  // checkpoint_process_memory_t, in list order.
+    page_tables_section,       // Frames of every page table, if paged.
+    resident_heap_section,     // Process memory indexes of the resident heap.
+    page_frames_section,       // checkpoint_page_frame_t of each frame.
+    free_frames_section,       // Free frames stack, if paged.
+    memory_segments_section,   // checkpoint_memory_segment_t, in list order.
+    buddy_words_section,       // Words of every buddy bitmap, if buddy fit.
+    turnaround_times_section,  // Metrics of each finished process, if
+    response_times_section,    // recorded.
+    checkpoint_sections
+};
+
+/* Data structure to hold the header of a checkpoint: the options the runner
+ * state depends on, which a restored run must match, and the state of the run
+ * other than its objects.
+ */
+typedef struct checkpoint_header_t
+{
+    char                 magic[CHECKPOINT_MAGIC_LEN];
+    int                  version;
+    int                  byte_order;  // CHECKPOINT_BYTE_ORDER, as saved.
+    int                  header_len;  // Size of the header, as saved.
+    char                 scheduling_policy[CHECKPOINT_NAME_LEN];
+    char                 eviction_policy[CHECKPOINT_NAME_LEN];
+    int                  memsize;
+    int                  fit_policy;
+    int                  levels;
+    int                  cpus;
+    int                  page_size;
+    int                  tlb_entries;
+    int                  tlb_ways;
+    // Runner.
+    int                  time;
+    int                  next_boost_time;
+    long                 taken;  // Scheduled processes taken from the source.
+    int                  has_next;  // And the next one, to check it by.
+    scheduled_process_t  next;
+    simulation_summary_t summary;
+    int                  holes_count;  // Last logged number of holes.
+    // Process memories list.
+    int                  next_sequence;
+    int                  resident_head;
+    int                  resident_tail;
+    int                  clock_hand;
+    int                  resident_count;
+    int                  resident_size;
+    int                  pinned_count;
+    double               eviction_inflation;
+    // Page frames, if paged.
+    int                  frames_clock_hand;
+    int                  free_runs;
+    long                 page_faults;
+    long                 page_outs;
+    // Free memory segments list.
+    int                  address_root;
+    int                  size_root;
+    unsigned int         tree_seed;
+    int                  count;
+    int                  compactions;
+    long                 compacted_size;
+    // Buddy allocator, if buddy fit.
+    int                  free_blocks;
+    int                  allocated_size;
+    int                  allocated_block_size;
+    // Metrics of finished processes, if recorded.
+    int                  has_metrics;
+    long long            total_wait_time;
+    long long            total_swap_count;
+    int                  max_wait_time;
+    int                  max_swap_count;
+    // Offset in the file and number of records of each section.
+    long                 section_offsets[checkpoint_sections];
+    long                 section_lens[checkpoint_sections];
+} checkpoint_header_t;
+
+/* Data structure to hold a saved CPU. */
+typedef struct checkpoint_cpu_t
+{
+    int          running;
+    int          waiting;
+    int          ready_heap_len;
+    int          ready_tree;
+    int          min_vruntime;
+    int          tickets;
+    unsigned int random_state;
+    int          migration_time;
+    unsigned int tlb_clock;
+    long         tlb_hits;
+    long         tlb_misses;
+} checkpoint_cpu_t;
+
+/* Data structure to hold a saved process control block queue. */
+typedef struct checkpoint_pcbs_queue_t
+{
+    int head;
+    int tail;
+    int len;
+} checkpoint_pcbs_queue_t;
+
+/* Data structure to hold a saved process control block. */
+typedef struct checkpoint_pcb_t
+{
+    int               next;
+    int               prev;
+    int               process_id;
+    int               process_state;
+    int               process_memory;
+    int               priority;
+    int               job_time;
+    int               burst_time;
+    int               cpu_time;
+    int               cpu;
+    process_metrics_t metrics;
+    int               tickets;
+    int               vruntime;
+    int               tree_left;
+    int               tree_right;
+    int               tree_parent;
+    int               tree_red;
+} checkpoint_pcb_t;
+
+/* Data structure to hold a saved process memory. Its page table, if it has
+ * one, is its pages of the page tables section from an offset.
+ */
+typedef struct checkpoint_process_memory_t
+{
+    int    start_address;
+    int    size;
+    int    swap_in_time;
+    int    process_id;
+    int    sequence;
+    int    heap_index;
+    int    swap_count;
+    int    pinned;
+    int    page_table;  // Offset in the page tables, or NO_CHECKPOINT_INDEX.
+    int    pages;
+    int    resident_pages;
+    int    next_page;
+    int    resident_prev;
+    int    resident_next;
+    int    referenced;
+    double eviction_value;
+} checkpoint_process_memory_t;
+
+/* Data structure to hold a saved page frame. */
+typedef struct checkpoint_page_frame_t
+{
+    int owner;
+    int page;
+    int referenced;
+} checkpoint_page_frame_t;
+
+/* Data structure to hold a saved free memory segment. */
+typedef struct checkpoint_memory_segment_t
+{
+    int          start_address;
+    int          size;
+    int          address_left;
+    int          address_right;
+    int          size_left;
+    int          size_right;
+    unsigned int tree_priority;
+    int          max_subtree_size;
+} checkpoint_memory_segment_t;
+
+/* Data structure to hold an object saved in a checkpoint, and the index of its
+ * record, to look up the index of a pointer by.
+ */
+typedef struct checkpoint_index_entry_t
+{
+    const void *object;
+    int        index;
+} checkpoint_index_entry_t;
+
+/* Data structure to hold the indexes of objects, sorted by address. */
+typedef struct checkpoint_index_t
+{
+    checkpoint_index_entry_t *entries;
+    int                      len;
+} checkpoint_index_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Save the state of a stopped run, and how much of its source it has taken,
+ * to a checkpoint file.
+ */
+void save_checkpoint(char filename[], scheduler_state_t *state,
+    scheduled_process_source_t *source, scheduler_options_t *options,
+    simulation_summary_t *summary);
+/* Write the sections of the CPUs, pcbs, process memories (and page frames)
+ * and free memory segments (or buddy allocator) of a run to a checkpoint file,
+ * and record the rest of their state in the header.
+ */
+void write_checkpoint_cpus(FILE *fp, scheduler_state_t *state,
+    checkpoint_index_t *pcb_index, scheduler_options_t *options,
+    checkpoint_header_t *header);
+void write_checkpoint_pcbs(FILE *fp, process_control_block_t *pcbs[], int len,
+    checkpoint_index_t *pcb_index, checkpoint_index_t *proc_mem_index,
+    checkpoint_header_t *header);
+void write_checkpoint_process_memories(FILE *fp,
+    process_memories_list_t *proc_mems_list, process_memory_t *proc_mems[],
+    int len, checkpoint_index_t *proc_mem_index, checkpoint_header_t *header);
+void write_checkpoint_memory_segments(FILE *fp,
+    free_memory_segments_list_t *mem_segs_list,
+    free_memory_segment_t *mem_segs[], int len,
+    checkpoint_index_t *mem_seg_index, checkpoint_header_t *header);
+/* Restore the state of a run from a checkpoint file, taking the scheduled
+ * processes it had already taken from the (same) source. Exits if the
+ * checkpoint is invalid or does not match the options.
+ */
+scheduler_state_t *restore_checkpoint(char filename[],
+    scheduled_process_source_t *source, scheduler_options_t *options,
+    simulation_summary_t *summary);
+/* Read the sections of a mapped checkpoint file back into the process
+ * memories (and page frames), pcbs, CPUs and free memory segments (or buddy
+ * allocator) of a new run. Pcbs and process memories are already allocated,
+ * one per record.
+ */
+void read_checkpoint_process_memories(const char *map, size_t map_len,
+    checkpoint_header_t *header, process_memories_list_t *proc_mems_list,
+    process_memory_t *proc_mems[], int len);
+void read_checkpoint_pcbs(const char *map, size_t map_len,
+    checkpoint_header_t *header, process_control_block_t *pcbs[], int len,
+    process_memory_t *proc_mems[], int proc_mems_len);
+void read_checkpoint_cpus(const char *map, size_t map_len,
+    checkpoint_header_t *header, scheduler_state_t *state,
+    process_control_block_t *pcbs[], int pcbs_len,
+    scheduler_options_t *options);
+void read_checkpoint_memory_segments(const char *map, size_t map_len,
+    checkpoint_header_t *header, free_memory_segments_list_t *mem_segs_list);
+/* Check the options a checkpoint was saved with match the options it is
+ * restored with. Quanta, boost interval, costs, compaction threshold, and fit
+ * policy other than buddy fit, may differ.
+ */
+int is_checkpoint_matching_options(checkpoint_header_t *header,
+    scheduler_options_t *options);
+/* Get the pcbs of every CPU: running, then waiting in their ready queues,
+ * ready heap and ready tree. Returns the number of pcbs.
+ */
+int get_checkpoint_pcbs(cpu_t cpus[], int len, process_control_block_t ***pcbs);
+/* Add the pcbs of every CPU, a pcb, or the pcbs of a ready tree, to pcbs
+ * unless NULL. Returns the new number of pcbs.
+ */
+int add_checkpoint_pcbs(cpu_t cpus[], int len, process_control_block_t *pcbs[]);
+int add_checkpoint_pcb(process_control_block_t *pcb,
+    process_control_block_t *pcbs[], int len);
+int add_checkpoint_ready_tree_pcbs(process_control_block_t *root,
+    process_control_block_t *pcbs[], int len);
+/* Allocate memory for and initialise the indexes of objects. */
+checkpoint_index_t *new_checkpoint_index(void *objects[], int len);
+/* Get the index of an object, NO_CHECKPOINT_INDEX if NULL or not indexed. */
+int get_checkpoint_index(const void *object, checkpoint_index_t *index);
+/* Compare checkpoint index entries for qsort and bsearch, by address. */
+int compare_checkpoint_index_entries(const void *a, const void *b);
+/* Free all memory allocated for the indexes of objects. */
+void free_checkpoint_index(checkpoint_index_t *index);
+/* Get the object of an index of a checkpoint, NULL for NO_CHECKPOINT_INDEX.
+ * Exits if out of range.
+ */
+void *get_checkpoint_object(int index, void *objects[], int len);
+/* Write a section of records to a checkpoint file at its next aligned offset,
+ * and record it in the header.
+ */
+void write_checkpoint_section(FILE *fp, enum checkpoint_section_t section,
+    const void *records, size_t record_len, long len,
+    checkpoint_header_t *header);
+/* Get the records of a section of a mapped checkpoint file, checking they lie
+ * within it. Exits if not.
+ */
+void *get_checkpoint_section(const char *map, size_t map_len,
+    enum checkpoint_section_t section, size_t record_len,
+    checkpoint_header_t *header);
+/* Copy the words of every bitmap of a buddy allocator to words, or from words
+ * if restoring, unless NULL. Returns the number of words.
+ */
+long copy_checkpoint_buddy_words(buddy_allocator_t *buddy,
+    unsigned long words[], int restoring);
@@ -0,0 +1,85 @@
+/*
+ * convert-trace.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "process-data-file-parser.h"
+#include "binary-trace.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+extern int optind;
+extern char *optarg;
+
+/* Convert a text process data file into a binary trace, "-" for standard
+ * input or output:
+ *
+ *   convert-trace -f input.txt -o output.trc [-d]
+ *
+ * With -d, start times and process ids are delta encoded.
+ */
+int main(int argc, char *argv[])
+{
+    char input, *filename = NULL, *output_filename = NULL;
+    int flags = 0;
+    FILE *fp;
+    binary_trace_t *trace;
+
+    // Handle program arguments.
+    while ((input = getopt(argc, argv, "f:o:d")) != EOF)
+    {
+        switch (input)
+        {
+            case 'f':  // Filename of scheduled processes text input.
+                filename = optarg;
+                break;
+
+            case 'o':  // Filename of binary trace output.
+                output_filename = optarg;
+                break;
+
+            case 'd':  // Delta encode start times and process ids.
+                flags |= BINARY_TRACE_DELTAS;
+                break;
+
+            default:  // Unknown argument.
+                fprintf(stderr, "Unknown argument\n");
+                exit(1);
+                break;
+        }
+    }
+    if (filename == NULL || output_filename == NULL)
+    {
+        fprintf(stderr, "Missing filename argument\n");
+        exit(1);
+    }
+
+    // Open input and error check.
+    fp = (strcmp(filename, "-") == 0) ? stdin : fopen(filename, "r");
+    if (fp == NULL)
+    {
+        perror("fopen");
+        exit(1);
+    }
+
+    // Convert each line.
+    trace = create_binary_trace(output_filename, flags);
+    convert_process_data_file_to_binary_trace(fp, trace);
+    close_binary_trace(trace);
+
+    if (fp != stdin)
+    {
+        fclose(fp);
+    }
+
+    return 0;
+}
@@ -0,0 +1,320 @@
+/*
+ * event-log.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "process-data-file-parser.h"
+#include "binary-trace.h"
+#include "event-log.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Global variables. ///////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const event_log_format_t binary_event_log_format =
+{
+    "binary",
+    write_binary_event_log_header,
+    format_binary_event
+};
+
+const event_log_format_t csv_event_log_format =
+{
+    "csv",
+    write_csv_event_log_header,
+    format_csv_event
+};
+
+const event_log_format_t jsonl_event_log_format =
+{
+    "jsonl",
+    NULL,
+    format_jsonl_event
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const event_log_format_t *get_event_log_format_by_name(char name[])
+{
+    const event_log_format_t *formats[] = {
+        &binary_event_log_format,
+        &csv_event_log_format,
+        &jsonl_event_log_format,
+        NULL
+    };
+    int i;
+
+    // Iterate over formats and find format by name.
+    for (i = 0; formats[i] != NULL; i++)
+    {
+        if (strcmp(formats[i]->name, name) == 0)
+        {
+            return formats[i];
+        }
+    }
+
+    return NULL;
+}
+
+char *get_simulation_event_type_name(enum simulation_event_type_t type)
+{
+    switch (type)
+    {
+        case load_event:
+            return "load";
+        case preempt_event:
+            return "preempt";
+        case swap_in_event:
+            return "swap_in";
+        case swap_out_event:
+            return "swap_out";
+        case terminate_event:
+            return "terminate";
+        case holes_event:
+            return "holes";
+        case compact_event:
+            return "compact";
+    }
+    return "unknown";
+}
+
+event_log_t *open_event_log(char filename[], const event_log_format_t *format)
+{
+    event_log_t *log;
+
+    // Allocate memory for event log and its buffer and error check.
+    log = (event_log_t*)malloc(sizeof(event_log_t));
+    if (log == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    log->buffer = (simulation_event_t*)malloc(sizeof(simulation_event_t) * EVENT_LOG_BUFFER_EVENTS);
+    if (log->buffer == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Open file and error check.
+    log->fp = (strcmp(filename, "-") == 0) ? stdout : fopen(filename, "wb");
+    if (log->fp == NULL)
+    {
+        perror("fopen");
+        exit(1);
+    }
+
+    // Set event log.
+    log->format = format;
+    log->buffer_len = 0;
+    log->time = 0;
+    log->holes_count = NO_EVENT_VALUE;
+
+    // Not every format has a header.
+    if (log->format->write_header != NULL)
+    {
+        log->format->write_header(log->fp);
+    }
+
+    return log;
+}
+
+void set_event_log_time(event_log_t *log, int time)
+{
+    if (log != NULL)
+    {
+        log->time = time;
+    }
+    return;
+}
+
+void log_simulation_event(event_log_t *log, enum simulation_event_type_t type,
+    int process_id, int start_address, int value)
+{
+    simulation_event_t *event;
+
+    if (log == NULL)
+    {
+        return;
+    }
+
+    // Write out buffer first if it is full.
+    if (log->buffer_len == EVENT_LOG_BUFFER_EVENTS)
+    {
+        flush_event_log(log);
+    }
+
+    event = &log->buffer[log->buffer_len++];
+    event->time = log->time;
+    event->type = type;
+    event->process_id = process_id;
+    event->start_address = start_address;
+    event->value = value;
+
+    return;
+}
+
+void log_holes_count(event_log_t *log, int holes_count)
+{
+    if (log != NULL && log->holes_count != holes_count)
+    {
+        log->holes_count = holes_count;
+        log_simulation_event(
+            log, holes_event, NO_EVENT_VALUE, NO_EVENT_VALUE, holes_count
+            );
+    }
+    return;
+}
+
+void flush_event_log(event_log_t *log)
+{
+    char chunk[EVENT_LOG_CHUNK_LEN];
+    int i, chunk_len = 0;
+
+    for (i = 0; i < log->buffer_len; i++)
+    {
+        // Write out chunk if the next event might not fit.
+        if (chunk_len > EVENT_LOG_CHUNK_LEN - EVENT_LOG_MAX_LINE_LEN)
+        {
+            fwrite(chunk, 1, chunk_len, log->fp);
+            chunk_len = 0;
+        }
+        chunk_len += log->format->format_event(chunk + chunk_len, &log->buffer[i]);
+    }
+    fwrite(chunk, 1, chunk_len, log->fp);
+    log->buffer_len = 0;
+
+    return;
+}
+
+void close_event_log(event_log_t *log)
+{
+    if (log == NULL)
+    {
+        return;
+    }
+
+    flush_event_log(log);
+    if (log->fp != stdout)
+    {
+        fclose(log->fp);
+    }
+    else
+    {
+        fflush(log->fp);
+    }
+
+    free(log->buffer);
+    free(log);
+
+    return;
+}
+
+void write_binary_event_log_header(FILE *fp)
+{
+    unsigned char header[EVENT_LOG_HEADER_LEN];
+
+    memcpy(header, EVENT_LOG_MAGIC, EVENT_LOG_MAGIC_LEN);
+    encode_le16(header + 4, EVENT_LOG_VERSION);
+    encode_le16(header + 6, EVENT_LOG_RECORD_LEN);
+    fwrite(header, 1, EVENT_LOG_HEADER_LEN, fp);
+
+    return;
+}
+
+int format_binary_event(char *p, simulation_event_t *event)
+{
+    unsigned char *record = (unsigned char*)p;
+
+    encode_le32(record, (unsigned int)event->time);
+    encode_le32(record + 4, (unsigned int)event->type);
+    encode_le32(record + 8, (unsigned int)event->process_id);
+    encode_le32(record + 12, (unsigned int)event->start_address);
+    encode_le32(record + 16, (unsigned int)event->value);
+
+    return EVENT_LOG_RECORD_LEN;
+}
+
+void write_csv_event_log_header(FILE *fp)
+{
+    fputs("time,event,process_id,start_address,value\n", fp);
+    return;
+}
+
+int format_csv_event(char *p, simulation_event_t *event)
+{
+    char *start = p;
+
+    // Format by hand, printf is most of the cost otherwise.
+    p += format_event_int(p, event->time);
+    *p++ = ',';
+    p += format_event_str(p, get_simulation_event_type_name(event->type));
+    *p++ = ',';
+    p += format_event_int(p, event->process_id);
+    *p++ = ',';
+    p += format_event_int(p, event->start_address);
+    *p++ = ',';
+    p += format_event_int(p, event->value);
+    *p++ = '\n';
+
+    return p - start;
+}
+
+int format_jsonl_event(char *p, simulation_event_t *event)
+{
+    char *start = p;
+
+    p += format_event_str(p, "{\"time\":");
+    p += format_event_int(p, event->time);
+    p += format_event_str(p, ",\"event\":\"");
+    p += format_event_str(p, get_simulation_event_type_name(event->type));
+    p += format_event_str(p, "\",\"process_id\":");
+    p += format_event_int(p, event->process_id);
+    p += format_event_str(p, ",\"start_address\":");
+    p += format_event_int(p, event->start_address);
+    p += format_event_str(p, ",\"value\":");
+    p += format_event_int(p, event->value);
+    p += format_event_str(p, "}\n");
+
+    return p - start;
+}
+
+int format_event_int(char *p, int value)
+{
+    char digits[12];
+    unsigned int magnitude;
+    int len = 0, digits_len = 0;
+
+    // Sign, then digits which come out in reverse.
+    magnitude = (unsigned int)value;
+    if (value < 0)
+    {
+        p[len++] = '-';
+        magnitude = 0u - magnitude;
+    }
+    do
+    {
+        digits[digits_len++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (digits_len > 0)
+    {
+        p[len++] = digits[--digits_len];
+    }
+
+    return len;
+}
+
+int format_event_str(char *p, const char *str)
+{
+    int len = strlen(str);
+    memcpy(p, str, len);
+    return len;
+}
@@ -0,0 +1,123 @@
+/*
+ * event-log.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* A binary event log is a header followed by fixed width records, all fields
+ * little-endian:
+ *
+ *   header: magic "PEVT", u16 version, u16 record length
+ *   record: i32 time, i32 event type, i32 process id, i32 start address,
+ *           i32 value
+ */
+#define EVENT_LOG_MAGIC           "PEVT"
+#define EVENT_LOG_MAGIC_LEN       4
+#define EVENT_LOG_VERSION         1
+#define EVENT_LOG_HEADER_LEN      8
+#define EVENT_LOG_RECORD_LEN      20
+// Number of events buffered before they are written.
+#define EVENT_LOG_BUFFER_EVENTS   65536
+// Longest an event can be formatted as.
+#define EVENT_LOG_MAX_LINE_LEN    128
+// Size of the chunks formatted events are written in.
+#define EVENT_LOG_CHUNK_LEN       65536
+// Used in process id and start address when an event has none.
+#define NO_EVENT_VALUE            -1
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Types of simulation events, and what their start address and value hold:
+ *
+ *   load:      start address of the process memory, priority
+ *   preempt:   -, priority the process is lowered to
+ *   swap in:   start address of the process memory, its size
+ *   swap out:  start address it was swapped out from, its size
+ *   terminate: -, cpu time
+ *   holes:     -, number of free memory segments (when it changes)
+ *   compact:   -, total size of process memories moved
+ */
+enum simulation_event_type_t
+{
+    load_event, preempt_event, swap_in_event, swap_out_event, terminate_event,
+    holes_event, compact_event
+};
+
+/* Data structure to hold a simulation event. */
+typedef struct simulation_event_t
+{
+    int                          time;
+    enum simulation_event_type_t type;
+    int                          process_id;
+    int                          start_address;
+    int                          value;
+} simulation_event_t;
+
+/* Data structure to hold an event log format, which formats an event at p and
+ * returns the number of characters, at most EVENT_LOG_MAX_LINE_LEN.
+ */
+typedef struct event_log_format_t
+{
+    char *name;
+    void (*write_header)(FILE *fp);  // NULL if without a header.
+    int  (*format_event)(char *p, simulation_event_t *event);
+} event_log_format_t;
+
+/* Data structure to hold an event log, which batches events in a buffer and
+ * writes them out in its format when the buffer is full.
+ */
+typedef struct event_log_t
+{
+    FILE                     *fp;
+    const event_log_format_t *format;
+    simulation_event_t       *buffer;
+    int                      buffer_len;
+    int                      time;         // Time events are logged at.
+    int                      holes_count;  // Last logged number of holes.
+} event_log_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Global variables. ///////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+extern const event_log_format_t binary_event_log_format;
+extern const event_log_format_t csv_event_log_format;
+extern const event_log_format_t jsonl_event_log_format;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Get an event log format by its name, or NULL if there is none. */
+const event_log_format_t *get_event_log_format_by_name(char name[]);
+/* Get the name of an event type. */
+char *get_simulation_event_type_name(enum simulation_event_type_t type);
+/* Open a file ("-" for standard output) for and initialise a new event log. */
+event_log_t *open_event_log(char filename[], const event_log_format_t *format);
+/* Set the time events are logged at. Does nothing if the log is NULL. */
+void set_event_log_time(event_log_t *log, int time);
+/* Log an event at the log's time. Does nothing if the log is NULL. */
+void log_simulation_event(event_log_t *log, enum simulation_event_type_t type,
+    int process_id, int start_address, int value);
+/* Log the number of holes if it changed since last logged. Does nothing if the
+ * log is NULL.
+ */
+void log_holes_count(event_log_t *log, int holes_count);
+/* Format and write out all buffered events, a chunk at a time. */
+void flush_event_log(event_log_t *log);
+/* Flush and close the event log and free all memory allocated for it. */
+void close_event_log(event_log_t *log);
+/* Binary format hooks. */
+void write_binary_event_log_header(FILE *fp);
+int format_binary_event(char *p, simulation_event_t *event);
+/* CSV format hooks. */
+void write_csv_event_log_header(FILE *fp);
+int format_csv_event(char *p, simulation_event_t *event);
+/* JSON lines format hooks. */
+int format_jsonl_event(char *p, simulation_event_t *event);
+/* Format an integer in decimal at p, returning the number of characters. */
+int format_event_int(char *p, int value);
+/* Copy a string to p, returning the number of characters. */
+int format_event_str(char *p, const char *str);
@@ -0,0 +1,338 @@
+/*
+ * eviction-policy.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "object-pool.h"
+#include "event-log.h"
+#include "memory-management.h"
+#include "eviction-policy.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Global variables. ///////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const eviction_policy_t largest_eviction_policy = {
+    "largest",
+    largest_eviction_add,
+    largest_eviction_remove,
+    largest_eviction_access,
+    largest_eviction_get_victim,
+    is_process_memory_swapped_out_before
+};
+
+const eviction_policy_t lru_eviction_policy = {
+    "lru",
+    fifo_eviction_add,
+    fifo_eviction_remove,
+    lru_eviction_access,
+    fifo_eviction_get_victim,
+    NULL
+};
+
+const eviction_policy_t fifo_eviction_policy = {
+    "fifo",
+    fifo_eviction_add,
+    fifo_eviction_remove,
+    fifo_eviction_access,
+    fifo_eviction_get_victim,
+    NULL
+};
+
+const eviction_policy_t clock_eviction_policy = {
+    "clock",
+    clock_eviction_add,
+    clock_eviction_remove,
+    clock_eviction_access,
+    clock_eviction_get_victim,
+    NULL
+};
+
+const eviction_policy_t gds_eviction_policy = {
+    "gds",
+    gds_eviction_add,
+    largest_eviction_remove,
+    gds_eviction_access,
+    gds_eviction_get_victim,
+    is_process_memory_gds_evicted_before
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const eviction_policy_t *get_eviction_policy_by_name(char name[])
+{
+    const eviction_policy_t *policies[] = {
+        &largest_eviction_policy,
+        &lru_eviction_policy,
+        &fifo_eviction_policy,
+        &clock_eviction_policy,
+        &gds_eviction_policy,
+        NULL
+    };
+    int i;
+
+    // Iterate over policies and find policy by name.
+    for (i = 0; policies[i] != NULL; i++)
+    {
+        if (strcmp(policies[i]->name, name) == 0)
+        {
+            return policies[i];
+        }
+    }
+
+    return NULL;
+}
+
+void append_process_memory_to_resident_list(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    proc_mem->resident_prev = proc_mems_list->resident_tail;
+    proc_mem->resident_next = NULL;
+
+    // If list is empty, add process memory as head.
+    if (proc_mems_list->resident_tail == NULL)
+    {
+        proc_mems_list->resident_head = proc_mem;
+    }
+    else
+    {
+        proc_mems_list->resident_tail->resident_next = proc_mem;
+    }
+    proc_mems_list->resident_tail = proc_mem;
+
+    return;
+}
+
+void remove_process_memory_from_resident_list(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    // Unlink from previous, reassigning list's head if first.
+    if (proc_mem->resident_prev == NULL)
+    {
+        proc_mems_list->resident_head = proc_mem->resident_next;
+    }
+    else
+    {
+        proc_mem->resident_prev->resident_next = proc_mem->resident_next;
+    }
+
+    // Unlink from next, reassigning list's tail if last.
+    if (proc_mem->resident_next == NULL)
+    {
+        proc_mems_list->resident_tail = proc_mem->resident_prev;
+    }
+    else
+    {
+        proc_mem->resident_next->resident_prev = proc_mem->resident_prev;
+    }
+
+    proc_mem->resident_prev = proc_mem->resident_next = NULL;
+
+    return;
+}
+
+void largest_eviction_add(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    add_process_memory_to_resident_heap(proc_mem, proc_mems_list);
+    return;
+}
+
+void largest_eviction_remove(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    remove_process_memory_from_resident_heap(proc_mem, proc_mems_list);
+    return;
+}
+
+void largest_eviction_access(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    // Order does not depend on use, don't do anything.
+    return;
+}
+
+process_memory_t *largest_eviction_get_victim(
+    process_memories_list_t *proc_mems_list)
+{
+    return get_unpinned_process_memory_from_resident_heap(0, proc_mems_list);
+}
+
+void lru_eviction_access(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    // Move to the most recently used end of the list.
+    remove_process_memory_from_resident_list(proc_mem, proc_mems_list);
+    append_process_memory_to_resident_list(proc_mem, proc_mems_list);
+    return;
+}
+
+void fifo_eviction_add(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    append_process_memory_to_resident_list(proc_mem, proc_mems_list);
+    return;
+}
+
+void fifo_eviction_remove(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    remove_process_memory_from_resident_list(proc_mem, proc_mems_list);
+    return;
+}
+
+void fifo_eviction_access(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    // Order does not depend on use, don't do anything.
+    return;
+}
+
+process_memory_t *fifo_eviction_get_victim(
+    process_memories_list_t *proc_mems_list)
+{
+    process_memory_t *proc_mem = proc_mems_list->resident_head;
+
+    // Pinned process memories keep their place, but are passed over.
+    while (proc_mem != NULL && proc_mem->pinned)
+    {
+        proc_mem = proc_mem->resident_next;
+    }
+
+    return proc_mem;
+}
+
+void clock_eviction_add(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    process_memory_t *hand = proc_mems_list->clock_hand;
+
+    proc_mem->referenced = 1;
+
+    /* Insert just behind the clock hand, so it is the last the hand reaches.
+     * The resident list wraps around from its tail to its head.
+     */
+    if (hand == NULL || hand == proc_mems_list->resident_head)
+    {
+        append_process_memory_to_resident_list(proc_mem, proc_mems_list);
+    }
+    else
+    {
+        proc_mem->resident_prev = hand->resident_prev;
+        proc_mem->resident_next = hand;
+        hand->resident_prev->resident_next = proc_mem;
+        hand->resident_prev = proc_mem;
+    }
+    if (hand == NULL)
+    {
+        proc_mems_list->clock_hand = proc_mem;
+    }
+
+    return;
+}
+
+void clock_eviction_remove(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    // Move the clock hand off the process memory first.
+    if (proc_mems_list->clock_hand == proc_mem)
+    {
+        proc_mems_list->clock_hand = (proc_mem->resident_next != NULL) ?
+            proc_mem->resident_next : proc_mems_list->resident_head;
+        if (proc_mems_list->clock_hand == proc_mem)
+        {
+            proc_mems_list->clock_hand = NULL;
+        }
+    }
+
+    remove_process_memory_from_resident_list(proc_mem, proc_mems_list);
+    return;
+}
+
+void clock_eviction_access(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    proc_mem->referenced = 1;
+    return;
+}
+
+process_memory_t *clock_eviction_get_victim(
+    process_memories_list_t *proc_mems_list)
+{
+    process_memory_t *hand = proc_mems_list->clock_hand;
+
+    // All pinned, so the hand would never stop.
+    if (proc_mems_list->resident_count == proc_mems_list->pinned_count)
+    {
+        return NULL;
+    }
+
+    /* Give referenced process memories a second chance, clearing them. Pinned
+     * ones are passed over as they are.
+     */
+    while (hand->pinned || hand->referenced)
+    {
+        if (!hand->pinned)
+        {
+            hand->referenced = 0;
+        }
+        hand = (hand->resident_next != NULL) ?
+            hand->resident_next : proc_mems_list->resident_head;
+    }
+    proc_mems_list->clock_hand = hand;
+
+    return hand;
+}
+
+void gds_eviction_add(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    proc_mem->eviction_value = proc_mems_list->eviction_inflation +
+        GDS_SWAP_IN_COST / proc_mem->size;
+    add_process_memory_to_resident_heap(proc_mem, proc_mems_list);
+    return;
+}
+
+void gds_eviction_access(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    // Restore value as of now and reposition in heap.
+    remove_process_memory_from_resident_heap(proc_mem, proc_mems_list);
+    gds_eviction_add(proc_mem, proc_mems_list);
+    return;
+}
+
+process_memory_t *gds_eviction_get_victim(
+    process_memories_list_t *proc_mems_list)
+{
+    process_memory_t *proc_mem;
+
+    proc_mem = get_unpinned_process_memory_from_resident_heap(0, proc_mems_list);
+    if (proc_mem == NULL)
+    {
+        return NULL;
+    }
+
+    // Values of process memories left are aged by raising the inflation.
+    proc_mems_list->eviction_inflation = proc_mem->eviction_value;
+
+    return proc_mem;
+}
+
+int is_process_memory_gds_evicted_before(process_memory_t *proc_mem,
+    process_memory_t *other_proc_mem)
+{
+    // Lowest value first, then earliest in the process memories list.
+    if (proc_mem->eviction_value != other_proc_mem->eviction_value)
+    {
+        return (proc_mem->eviction_value < other_proc_mem->eviction_value);
+    }
+    return (proc_mem->sequence < other_proc_mem->sequence);
+}
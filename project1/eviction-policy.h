@@ -0,0 +1,79 @@
+/*
+ * eviction-policy.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Cost of swapping a process memory back in, used by greedy-dual-size.
+#define GDS_SWAP_IN_COST 1.0
+
+////////////////////////////////////////////////////////////////////////////////
+// Global variables. ///////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Largest (and if equal largest, longest in memory) process memory first. */
+extern const eviction_policy_t largest_eviction_policy;
+/* Least recently swapped in or loaded process memory first. */
+extern const eviction_policy_t lru_eviction_policy;
+/* Earliest swapped in process memory first. */
+extern const eviction_policy_t fifo_eviction_policy;
+/* Clock (second chance): earliest swapped in process memory that has not been
+ * loaded since the clock hand last passed it.
+ */
+extern const eviction_policy_t clock_eviction_policy;
+/* Greedy-dual-size: lowest value of inflation + cost / size first, where the
+ * inflation rises to the value of each process memory swapped out.
+ */
+extern const eviction_policy_t gds_eviction_policy;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Get an eviction policy by its name, or NULL if there is none. */
+const eviction_policy_t *get_eviction_policy_by_name(char name[]);
+/* Add a process memory to, or remove it from, the end of the resident list. */
+void append_process_memory_to_resident_list(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void remove_process_memory_from_resident_list(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+/* Largest eviction policy hooks. */
+void largest_eviction_add(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void largest_eviction_remove(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void largest_eviction_access(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+process_memory_t *largest_eviction_get_victim(
+    process_memories_list_t *proc_mems_list);
+/* Least recently used eviction policy hooks. */
+void lru_eviction_access(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+/* First in first out eviction policy hooks. */
+void fifo_eviction_add(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void fifo_eviction_remove(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void fifo_eviction_access(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+process_memory_t *fifo_eviction_get_victim(
+    process_memories_list_t *proc_mems_list);
+/* Clock eviction policy hooks. */
+void clock_eviction_add(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void clock_eviction_remove(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void clock_eviction_access(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+process_memory_t *clock_eviction_get_victim(
+    process_memories_list_t *proc_mems_list);
+/* Greedy-dual-size eviction policy hooks. */
+void gds_eviction_add(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void gds_eviction_access(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+process_memory_t *gds_eviction_get_victim(
+    process_memories_list_t *proc_mems_list);
+int is_process_memory_gds_evicted_before(process_memory_t *proc_mem,
+    process_memory_t *other_proc_mem);
@@ -0,0 +1,155 @@
+/*
+ * generate-trace.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "process-data-file-parser.h"
+#include "binary-trace.h"
+#include "trace-generator.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Size of the buffer text traces are written through.
+#define TEXT_TRACE_BUFFER_LEN 1048576
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+extern int optind;
+extern char *optarg;
+
+/* Generate a synthetic trace of scheduled processes as a text process data file
+ * or (with -b) a binary trace, "-" for standard output:
+ *
+ *   generate-trace -o output.txt [-n records] [-s seed] [-a poisson|bursty]
+ *       [-i mean interarrival time] [-j mean job time] [-J max job time]
+ *       [-m mean memory size] [-M max memory size] [-x tail index] [-b [-d]]
+ *
+ * The same options always generate the same trace. With -d, start times and
+ * process ids of a binary trace are delta encoded.
+ */
+int main(int argc, char *argv[])
+{
+    char input, *output_filename = NULL;
+    int binary = 0, flags = 0;
+    trace_generator_options_t options;
+    trace_generator_t *generator;
+    scheduled_process_t sp;
+    binary_trace_t *trace;
+    FILE *fp;
+
+    set_default_trace_generator_options(&options);
+
+    // Handle program arguments.
+    while ((input = getopt(argc, argv, "o:n:s:a:i:j:J:m:M:x:bd")) != EOF)
+    {
+        switch (input)
+        {
+            case 'o':  // Filename of trace output.
+                output_filename = optarg;
+                break;
+
+            case 'n':  // Number of scheduled processes.
+                options.records = strtoull(optarg, NULL, 10);
+                break;
+
+            case 's':  // Seed of the pseudo-random numbers.
+                options.seed = strtoull(optarg, NULL, 10);
+                break;
+
+            case 'a':  // Arrival process, poisson or bursty.
+                if (!parse_arrival_process(optarg, &options.arrivals))
+                {
+                    fprintf(stderr, "Invalid arrival process argument\n");
+                    exit(1);
+                }
+                break;
+
+            case 'i':  // Mean time between arrivals.
+                options.mean_interarrival_time = atof(optarg);
+                break;
+
+            case 'j':  // Mean job time.
+                options.mean_job_time = atof(optarg);
+                break;
+
+            case 'J':  // Max job time.
+                options.max_job_time = atoi(optarg);
+                break;
+
+            case 'm':  // Mean memory size.
+                options.mean_memory_size = atof(optarg);
+                break;
+
+            case 'M':  // Max memory size.
+                options.max_memory_size = atoi(optarg);
+                break;
+
+            case 'x':  // Tail index of job times and memory sizes.
+                options.tail_index = atof(optarg);
+                break;
+
+            case 'b':  // Write a binary trace.
+                binary = 1;
+                break;
+
+            case 'd':  // Delta encode start times and process ids.
+                flags |= BINARY_TRACE_DELTAS;
+                break;
+
+            default:  // Unknown argument.
+                fprintf(stderr, "Unknown argument\n");
+                exit(1);
+                break;
+        }
+    }
+    if (output_filename == NULL)
+    {
+        fprintf(stderr, "Missing filename argument\n");
+        exit(1);
+    }
+    generator = new_trace_generator(&options);
+
+    // Write each scheduled process as a binary trace record.
+    if (binary)
+    {
+        trace = create_binary_trace(output_filename, flags);
+        while (generate_scheduled_process(generator, &sp))
+        {
+            write_binary_trace(trace, &sp);
+        }
+        close_binary_trace(trace);
+        free_trace_generator(generator);
+        return 0;
+    }
+
+    // Or as a line of a text process data file.
+    fp = (strcmp(output_filename, "-") == 0) ? stdout : fopen(output_filename, "w");
+    if (fp == NULL)
+    {
+        perror("fopen");
+        exit(1);
+    }
+    setvbuf(fp, NULL, _IOFBF, TEXT_TRACE_BUFFER_LEN);
+    while (generate_scheduled_process(generator, &sp))
+    {
+        fprintf(fp, "%d %d %d %d\n",
+            sp.start_time, sp.process_id, sp.memory_size, sp.job_time);
+    }
+    if (fp != stdout)
+    {
+        fclose(fp);
+    }
+    free_trace_generator(generator);
+
+    return 0;
+}
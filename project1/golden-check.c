@@ -0,0 +1,362 @@
+/*
+ * golden-check.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "golden-check.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+extern int optind;
+extern char *optarg;
+
+/* Run the simulation over every golden output case in a directory, diff its
+ * output with the expected output, and record the wall time and peak resident
+ * set size of each case:
+ *
+ *   golden-check [-d tests] [-s ./simulation] [-r runs] [-o results.csv]
+ *
+ * With -r, each case is run that many times and its least wall time kept.
+ * Exits with 1 if any case failed.
+ */
+int main(int argc, char *argv[])
+{
+    char input, *dir = "tests", *simulation = "./simulation";
+    char *results_filename = NULL;
+    int runs = 1, cases = 0, failed = 0, i, len;
+    struct dirent **entries;
+    check_case_t check_case;
+    FILE *fp = NULL;
+
+    // Handle program arguments.
+    while ((input = getopt(argc, argv, "d:s:r:o:")) != EOF)
+    {
+        switch (input)
+        {
+            case 'd':  // Directory of inputs and expected outputs.
+                dir = optarg;
+                break;
+
+            case 's':  // Simulation executable to check.
+                simulation = optarg;
+                break;
+
+            case 'r':  // Times to run each case.
+                runs = atoi(optarg);
+                if (runs < 1)
+                {
+                    fprintf(stderr, "Invalid runs argument\n");
+                    exit(1);
+                }
+                break;
+
+            case 'o':  // Filename of CSV results output.
+                results_filename = optarg;
+                break;
+
+            default:  // Unknown argument.
+                fprintf(stderr, "Unknown argument\n");
+                exit(1);
+                break;
+        }
+    }
+
+    // List the directory and error check.
+    len = scandir(dir, &entries, NULL, alphasort);
+    if (len < 0)
+    {
+        perror("scandir");
+        exit(1);
+    }
+    if (results_filename != NULL)
+    {
+        fp = fopen(results_filename, "w");
+        if (fp == NULL)
+        {
+            perror("fopen");
+            exit(1);
+        }
+        fprintf(fp, "case,result,wall_seconds,max_rss_kb\n");
+    }
+
+    // Run each case in name order.
+    for (i = 0; i < len; i++)
+    {
+        if (parse_check_case(dir, entries[i]->d_name, &check_case))
+        {
+            run_check_case(&check_case, simulation, runs);
+            cases++;
+            failed += !check_case.passed;
+
+            if (check_case.passed)
+            {
+                printf("PASS %-40s wall=%.4fs rss=%ldKB\n", check_case.name,
+                    check_case.wall_time, check_case.max_rss);
+            }
+            else
+            {
+                printf("FAIL %-40s wall=%.4fs rss=%ldKB (differs at line %d)\n",
+                    check_case.name, check_case.wall_time, check_case.max_rss,
+                    check_case.diff_line);
+            }
+            if (fp != NULL)
+            {
+                fprintf(fp, "\"%s\",%s,%.6f,%ld\n", check_case.name,
+                    check_case.passed ? "pass" : "fail", check_case.wall_time,
+                    check_case.max_rss);
+            }
+        }
+        free(entries[i]);
+    }
+    free(entries);
+    if (fp != NULL)
+    {
+        fclose(fp);
+    }
+
+    printf("%d of %d cases passed\n", cases - failed, cases);
+
+    return (failed > 0 || cases == 0);
+}
+
+int parse_check_case(char dir[], char filename[], check_case_t *check_case)
+{
+    char *output, *rest, *close;
+    int prefix_len, number_len, options_at, len = strlen(filename);
+
+    // Must be <prefix>Output<n>-<algorithm>-<memsize>...txt.
+    output = strstr(filename, "Output");
+    if (output == NULL || len < 4 || strcmp(filename + len - 4, ".txt") != 0 ||
+        len - 4 >= MAX_CHECK_PATH_LEN)
+    {
+        return 0;
+    }
+    prefix_len = output - filename;
+    number_len = strspn(output + 6, "0123456789");
+    rest = output + 6 + number_len;
+    if (*rest != '-' || sscanf(rest, "-%[^-]-%[0-9]%n", check_case->algorithm,
+        check_case->memsize, &options_at) != 2)
+    {
+        return 0;
+    }
+
+    // Options, each -<option>(<value>), until the extension.
+    check_case->options_len = 0;
+    for (rest += options_at; *rest == '-'; rest = close + 1)
+    {
+        close = strchr(rest, ')');
+        if (check_case->options_len == MAX_CHECK_OPTIONS || rest[1] == '\0' ||
+            rest[2] != '(' || close == NULL)
+        {
+            return 0;
+        }
+        check_case->options[check_case->options_len] = rest[1];
+        snprintf(check_case->option_values[check_case->options_len],
+            MAX_CHECK_PATH_LEN, "%.*s", (int)(close - rest - 3), rest + 3);
+        check_case->options_len++;
+    }
+    if (strcmp(rest, ".txt") != 0)
+    {
+        return 0;
+    }
+
+    snprintf(check_case->name, MAX_CHECK_PATH_LEN, "%.*s", len - 4, filename);
+    snprintf(check_case->expected, MAX_CHECK_PATH_LEN, "%s/%s", dir, filename);
+    snprintf(check_case->input, MAX_CHECK_PATH_LEN, "%s/%.*sInput%.*s.txt",
+        dir, prefix_len, filename, number_len, output + 6);
+    if (!is_file(check_case->input))
+    {
+        snprintf(check_case->input, MAX_CHECK_PATH_LEN, "%s/%.*sInput%.*s.bin",
+            dir, prefix_len, filename, number_len, output + 6);
+    }
+    if (!is_file(check_case->input))
+    {
+        snprintf(check_case->input, MAX_CHECK_PATH_LEN, "%s/specInput.txt", dir);
+    }
+
+    return 1;
+}
+
+void run_check_case(check_case_t *check_case, char simulation[], int runs)
+{
+    char output[] = CHECK_OUTPUT_TEMPLATE, checkpoint[] = CHECK_OUTPUT_TEMPLATE;
+    char *args[MAX_CHECK_ARGS], *restore_args[MAX_CHECK_ARGS];
+    char flags[MAX_CHECK_OPTIONS][3], *value;
+    double wall_time;
+    int i, fd, exited = 1, arg = 0, restore_arg = 0, restore = 0;
+
+    // Create the files the output and checkpoint are written to and error check.
+    fd = mkstemp(output);
+    if (fd < 0 || close(fd) < 0 || (fd = mkstemp(checkpoint)) < 0)
+    {
+        perror("mkstemp");
+        exit(1);
+    }
+    close(fd);
+
+    args[arg++] = simulation;
+    args[arg++] = "-f";
+    args[arg++] = check_case->input;
+    args[arg++] = "-a";
+    args[arg++] = check_case->algorithm;
+    args[arg++] = "-m";
+    args[arg++] = check_case->memsize;
+    for (i = 0; i < arg; i++)
+    {
+        restore_args[restore_arg++] = args[i];
+    }
+
+    /* Pass each option, alone if it has no value. A checkpoint option without
+     * a value saves to the temporary checkpoint, which a second run restores
+     * from, not stopped or saved again.
+     */
+    for (i = 0; i < check_case->options_len; i++)
+    {
+        snprintf(flags[i], sizeof(flags[i]), "-%c", check_case->options[i]);
+        value = check_case->option_values[i];
+        if (check_case->options[i] == 'S' && value[0] == '\0')
+        {
+            value = checkpoint;
+            restore = 1;
+        }
+        args[arg++] = flags[i];
+        if (value[0] != '\0')
+        {
+            args[arg++] = value;
+        }
+        if (check_case->options[i] != 'u' && check_case->options[i] != 'S')
+        {
+            restore_args[restore_arg++] = flags[i];
+            if (value[0] != '\0')
+            {
+                restore_args[restore_arg++] = value;
+            }
+        }
+    }
+    args[arg] = NULL;
+    restore_args[restore_arg++] = "-R";
+    restore_args[restore_arg++] = checkpoint;
+    restore_args[restore_arg] = NULL;
+
+    // Keep the least wall time, as the others were slowed by something else.
+    check_case->max_rss = 0;
+    for (i = 0; i < runs; i++)
+    {
+        wall_time = 0;
+        exited &= run_simulation(args, output, 0, &wall_time, &check_case->max_rss);
+        if (restore)
+        {
+            exited &= run_simulation(restore_args, output, 1, &wall_time,
+                &check_case->max_rss);
+        }
+        if (i == 0 || wall_time < check_case->wall_time)
+        {
+            check_case->wall_time = wall_time;
+        }
+    }
+
+    check_case->diff_line = compare_files(output, check_case->expected);
+    check_case->passed = exited && check_case->diff_line == 0;
+    unlink(output);
+    unlink(checkpoint);
+
+    return;
+}
+
+int run_simulation(char *args[], char output[], int append,
+    double *wall_time, long *max_rss)
+{
+    struct timespec start, end;
+    struct rusage usage;
+    pid_t pid;
+    int status, fd;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        exit(1);
+    }
+
+    // Run the simulation with standard output and error to the output file.
+    if (pid == 0)
+    {
+        fd = open(output, O_WRONLY | (append ? O_APPEND : O_TRUNC));
+        if (fd < 0)
+        {
+            perror("open");
+            _exit(127);
+        }
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+        execv(args[0], args);
+        perror("execv");
+        _exit(127);
+    }
+
+    if (wait4(pid, &status, 0, &usage) < 0)
+    {
+        perror("wait4");
+        exit(1);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    *wall_time += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    *max_rss = (usage.ru_maxrss > *max_rss) ? usage.ru_maxrss : *max_rss;
+
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+int compare_files(char filename[], char other_filename[])
+{
+    FILE *fp, *other_fp;
+    int c, other_c, line = 1;
+
+    fp = fopen(filename, "r");
+    other_fp = fopen(other_filename, "r");
+    if (fp == NULL || other_fp == NULL)
+    {
+        perror("fopen");
+        exit(1);
+    }
+
+    // Compare character by character, counting lines.
+    do
+    {
+        c = getc(fp);
+        other_c = getc(other_fp);
+        if (c != other_c)
+        {
+            break;
+        }
+        line += (c == '\n');
+    } while (c != EOF);
+
+    fclose(fp);
+    fclose(other_fp);
+
+    return (c == other_c) ? 0 : line;
+}
+
+int is_file(char filename[])
+{
+    struct stat st;
+    return (stat(filename, &st) == 0 && S_ISREG(st.st_mode));
+}
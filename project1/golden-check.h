@@ -0,0 +1,65 @@
+/*
+ * golden-check.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#define MAX_CHECK_PATH_LEN  512
+#define MAX_CHECK_OPTIONS   8
+// Simulation, input, algorithm and memory size, each option, and a restore.
+#define MAX_CHECK_ARGS      (7 + 2 * MAX_CHECK_OPTIONS + 3)
+// Where the output of a case is written before it is compared.
+#define CHECK_OUTPUT_TEMPLATE "/tmp/golden-check-XXXXXX"
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Data structure to hold a golden output case. Its expected output file is
+ * named <prefix>Output<n>-<algorithm>-<memsize>[-<option>(<value>)...].txt,
+ * and its input is <prefix>Input<n>.txt, a binary trace <prefix>Input<n>.bin,
+ * or specInput.txt if there is neither.
+ * Each option is passed to the simulation with its value, or alone if the
+ * value is empty. -S() checkpoints the run when stopped (by -u) and appends
+ * the output of a second run restored from it.
+ */
+typedef struct check_case_t
+{
+    char   name[MAX_CHECK_PATH_LEN];
+    char   input[MAX_CHECK_PATH_LEN];
+    char   expected[MAX_CHECK_PATH_LEN];
+    char   algorithm[MAX_CHECK_PATH_LEN];
+    char   memsize[MAX_CHECK_PATH_LEN];
+    char   options[MAX_CHECK_OPTIONS];
+    char   option_values[MAX_CHECK_OPTIONS][MAX_CHECK_PATH_LEN];
+    int    options_len;
+    int    passed;
+    int    diff_line;    // First line that differs, if failed.
+    double wall_time;    // Least wall time of its runs, in seconds.
+    long   max_rss;      // Peak resident set size, in kilobytes.
+} check_case_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Parse a case from the name of its expected output file in a directory.
+ * Returns 0 if it is not an expected output file.
+ */
+int parse_check_case(char dir[], char filename[], check_case_t *check_case);
+/* Run the simulation of a case a number of times, comparing its output with
+ * the expected output and recording its wall time and peak memory.
+ */
+void run_check_case(check_case_t *check_case, char simulation[], int runs);
+/* Run the simulation once with its output to a file, or appended to it,
+ * adding its wall time and peak memory. Returns 0 if it did not exit normally.
+ */
+int run_simulation(char *args[], char output[], int append,
+    double *wall_time, long *max_rss);
+/* Compare two files. Returns 0 if the same, otherwise the first line that
+ * differs.
+ */
+int compare_files(char filename[], char other_filename[]);
+/* Check if a file exists. */
+int is_file(char filename[]);
@@ -9,7 +9,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <stdlib.h>
 #include <stdio.h>
+#include "object-pool.h"
+#include "event-log.h"
 #include "memory-management.h"
+#include "eviction-policy.h"
+#include "paged-memory.h"
+#include "buddy-allocator.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Function definitions. ///////////////////////////////////////////////////////
@@ -18,21 +23,6 @@ free_memory_segments_list_t *new_free_memory_segments_list(int size)
 {
     free_memory_segments_list_t *mem_segs_list;
 
-    free_memory_segment_t *mem_seg;
-
-    // Allocate memory for free memory segment and error check.
-    mem_seg = (free_memory_segment_t*)malloc(sizeof(free_memory_segment_t));
-    if (mem_seg == NULL)
-    {
-        perror("malloc");
-        exit(1);
-    }
-
-    // Set free memory segment.
-    mem_seg->next = NULL;
-    mem_seg->start_address = size;
-    mem_seg->size = size;
-
     // Allocate memory for free memory segments list and error check.
     mem_segs_list = (free_memory_segments_list_t*)malloc(sizeof(free_memory_segments_list_t));
     if (mem_segs_list == NULL)
@@ -42,437 +32,1424 @@ free_memory_segments_list_t *new_free_memory_segments_list(int size)
     }
 
     // Set free memory segments list.
-    mem_segs_list->head = mem_seg;
+    mem_segs_list->head = NULL;
+    mem_segs_list->address_root = NULL;
+    mem_segs_list->size_root = NULL;
+    mem_segs_list->fit_policy = first_fit;
+    mem_segs_list->tree_seed = TREE_PRIORITY_SEED;
+    mem_segs_list->mem_seg_pool = new_object_pool(
+        sizeof(free_memory_segment_t), FREE_MEMORY_SEGMENTS_PER_SLAB
+        );
+    mem_segs_list->count = 0;
+    mem_segs_list->size = size;
+    mem_segs_list->buddy = NULL;
+    mem_segs_list->compaction_threshold = NO_COMPACTION;
+    mem_segs_list->compactions = 0;
+    mem_segs_list->compacted_size = 0;
+
+    // The whole memory starts as one free memory segment.
+    insert_free_memory_segment(
+        new_free_memory_segment(size, size, mem_segs_list), mem_segs_list
+        );
 
     return mem_segs_list;
 }
 
-void add_new_free_memory_segment_to_free_memory_segments_list(int start_address,
-    int size, free_memory_segments_list_t *mem_segs_list)
+void set_free_memory_segments_list_fit_policy(
+    free_memory_segments_list_t *mem_segs_list, enum fit_policy_t fit_policy)
 {
-    free_memory_segment_t *mem_seg;
-
-    free_memory_segment_t *prev_mem_seg, *curr_mem_seg;
+    mem_segs_list->fit_policy = fit_policy;
 
-    // Allocate memory for free memory segment and error check.
-    mem_seg = (free_memory_segment_t*)malloc(sizeof(free_memory_segment_t));
-    if (mem_seg == NULL)
+    // Hand the whole memory, free as one segment, to a buddy allocator.
+    if (fit_policy == buddy_fit && mem_segs_list->buddy == NULL)
     {
-        perror("malloc");
-        exit(1);
+        release_to_object_pool(mem_segs_list->head, mem_segs_list->mem_seg_pool);
+        mem_segs_list->head = NULL;
+        mem_segs_list->address_root = NULL;
+        mem_segs_list->size_root = NULL;
+        mem_segs_list->buddy = new_buddy_allocator(mem_segs_list->size);
+        mem_segs_list->count = mem_segs_list->buddy->free_blocks;
     }
+    return;
+}
+
+void set_free_memory_segments_list_compaction_threshold(
+    free_memory_segments_list_t *mem_segs_list, int compaction_threshold)
+{
+    mem_segs_list->compaction_threshold = compaction_threshold;
+    return;
+}
+
+free_memory_segment_t *new_free_memory_segment(int start_address, int size,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    free_memory_segment_t *mem_seg;
+
+    // Allocate free memory segment from the list's pool.
+    mem_seg = (free_memory_segment_t*)allocate_from_object_pool(
+        mem_segs_list->mem_seg_pool
+        );
 
     // Set free memory segment.
     mem_seg->next = NULL;
+    mem_seg->prev = NULL;
     mem_seg->start_address = start_address;
     mem_seg->size = size;
+    mem_seg->address_left = NULL;
+    mem_seg->address_right = NULL;
+    mem_seg->size_left = NULL;
+    mem_seg->size_right = NULL;
+    mem_seg->max_subtree_size = size;
+
+    // Next pseudo-random tree priority (xorshift), deterministic per list.
+    mem_segs_list->tree_seed ^= mem_segs_list->tree_seed << 13;
+    mem_segs_list->tree_seed ^= mem_segs_list->tree_seed >> 17;
+    mem_segs_list->tree_seed ^= mem_segs_list->tree_seed << 5;
+    mem_seg->tree_priority = mem_segs_list->tree_seed;
+
+    return mem_seg;
+}
+
+void add_new_free_memory_segment_to_free_memory_segments_list(int start_address,
+    int size, free_memory_segments_list_t *mem_segs_list)
+{
+    free_memory_segment_t *mem_seg, *upper_mem_seg, *lower_mem_seg;
+
+    // Free the block it was allocated, merging buddies, with buddy fit.
+    if (mem_segs_list->buddy != NULL)
+    {
+        free_buddy_block(start_address - size, size, mem_segs_list->buddy);
+        mem_segs_list->count = mem_segs_list->buddy->free_blocks;
+        return;
+    }
+
+    // Find the free memory segments directly above and below the new one.
+    upper_mem_seg = get_free_memory_segment_above(start_address, mem_segs_list);
+    lower_mem_seg = get_free_memory_segment_below(start_address, mem_segs_list);
+
+    // Upper free memory segment ends where new one starts, so grow it down.
+    if (upper_mem_seg != NULL &&
+        get_free_memory_segment_end_address(upper_mem_seg) == start_address)
+    {
+        remove_free_memory_segment(upper_mem_seg, mem_segs_list);
+        upper_mem_seg->size += size;
+        mem_seg = upper_mem_seg;
+    }
+    else
+    {
+        mem_seg = new_free_memory_segment(start_address, size, mem_segs_list);
+    }
+
+    // New one ends where lower free memory segment starts, so absorb it.
+    if (lower_mem_seg != NULL &&
+        get_free_memory_segment_end_address(mem_seg) == lower_mem_seg->start_address)
+    {
+        remove_free_memory_segment(lower_mem_seg, mem_segs_list);
+        mem_seg->size += lower_mem_seg->size;
+
+        // Release memory.
+        release_to_object_pool(lower_mem_seg, mem_segs_list->mem_seg_pool);
+    }
+
+    insert_free_memory_segment(mem_seg, mem_segs_list);
+    return;
+}
+
+int get_free_memory_segment_end_address(free_memory_segment_t *mem_seg)
+{
+    return mem_seg->start_address - mem_seg->size;
+}
+
+void consolidate_free_memory_segments_list(
+    free_memory_segments_list_t *mem_segs_list)
+{
+    free_memory_segment_t *curr_mem_seg = mem_segs_list->head, *next_mem_seg;
+
+    /* Iterate over list and consolidate contiguous free memory segments. Adding
+     * free memory segments already consolidates them, so this only has work to
+     * do if segments were changed directly.
+     */
+    while (curr_mem_seg != NULL)
+    {
+        // No more memory segments to consolidate.
+        next_mem_seg = curr_mem_seg->next;
+        if (next_mem_seg == NULL)
+        {
+            break;
+        }
+
+        // Memory segment ends where next memory segment starts, so consolidate.
+        if (get_free_memory_segment_end_address(curr_mem_seg) == next_mem_seg->start_address)
+        {
+            remove_free_memory_segment(curr_mem_seg, mem_segs_list);
+            remove_free_memory_segment(next_mem_seg, mem_segs_list);
+            curr_mem_seg->size += next_mem_seg->size;
+            insert_free_memory_segment(curr_mem_seg, mem_segs_list);
+
+            // Release memory.
+            release_to_object_pool(next_mem_seg, mem_segs_list->mem_seg_pool);
+
+            /* Don't go to next iteration, might be more contiguous memory to
+             * consolidate.
+             */
+        }
+        else
+        {
+            curr_mem_seg = next_mem_seg;
+        }
+    }
+
+    return;
+}
+
+int get_free_memory_segments_list_count(
+    free_memory_segments_list_t *mem_segs_list)
+{
+    return mem_segs_list->count;
+}
 
-    // SPECIAL CASE: If list is empty, assign to head.
-    if (mem_segs_list->head == NULL)
+void insert_free_memory_segment(free_memory_segment_t *mem_seg,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    free_memory_segment_t *upper_mem_seg;
+
+    // Add to list in sorted descending start address order.
+    upper_mem_seg = get_free_memory_segment_above(
+        mem_seg->start_address, mem_segs_list
+        );
+    mem_seg->prev = upper_mem_seg;
+    if (upper_mem_seg == NULL)
     {
+        mem_seg->next = mem_segs_list->head;
         mem_segs_list->head = mem_seg;
     }
     else
     {
-        // Iterate towards end of list.
-        prev_mem_seg = NULL;
-        curr_mem_seg = mem_segs_list->head;
-        while (curr_mem_seg != NULL)
+        mem_seg->next = upper_mem_seg->next;
+        upper_mem_seg->next = mem_seg;
+    }
+    if (mem_seg->next != NULL)
+    {
+        mem_seg->next->prev = mem_seg;
+    }
+
+    // Add to trees.
+    mem_seg->address_left = mem_seg->address_right = NULL;
+    mem_seg->size_left = mem_seg->size_right = NULL;
+    mem_seg->max_subtree_size = mem_seg->size;
+    mem_segs_list->address_root = insert_into_free_memory_segments_address_tree(
+        mem_seg, mem_segs_list->address_root
+        );
+    mem_segs_list->size_root = insert_into_free_memory_segments_size_tree(
+        mem_seg, mem_segs_list->size_root
+        );
+    mem_segs_list->count++;
+
+    return;
+}
+
+void remove_free_memory_segment(free_memory_segment_t *mem_seg,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    // Remove from trees.
+    mem_segs_list->address_root = remove_from_free_memory_segments_address_tree(
+        mem_seg, mem_segs_list->address_root
+        );
+    mem_segs_list->size_root = remove_from_free_memory_segments_size_tree(
+        mem_seg, mem_segs_list->size_root
+        );
+
+    // Remove from list.
+    if (mem_seg->prev == NULL)
+    {
+        mem_segs_list->head = mem_seg->next;
+    }
+    else
+    {
+        mem_seg->prev->next = mem_seg->next;
+    }
+    if (mem_seg->next != NULL)
+    {
+        mem_seg->next->prev = mem_seg->prev;
+    }
+    mem_seg->next = mem_seg->prev = NULL;
+    mem_segs_list->count--;
+
+    return;
+}
+
+free_memory_segment_t *get_free_memory_segment_above(int address,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    free_memory_segment_t *mem_seg = mem_segs_list->address_root,
+        *upper_mem_seg = NULL;
+
+    // Find the lowest start address greater than address.
+    while (mem_seg != NULL)
+    {
+        if (mem_seg->start_address > address)
+        {
+            upper_mem_seg = mem_seg;
+            mem_seg = mem_seg->address_left;
+        }
+        else
+        {
+            mem_seg = mem_seg->address_right;
+        }
+    }
+
+    return upper_mem_seg;
+}
+
+free_memory_segment_t *get_free_memory_segment_below(int address,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    free_memory_segment_t *mem_seg = mem_segs_list->address_root,
+        *lower_mem_seg = NULL;
+
+    // Find the highest start address less than address.
+    while (mem_seg != NULL)
+    {
+        if (mem_seg->start_address < address)
+        {
+            lower_mem_seg = mem_seg;
+            mem_seg = mem_seg->address_right;
+        }
+        else
         {
-            // Add free memory segment to sorted position.
-            if (mem_seg->start_address >= curr_mem_seg->start_address)
+            mem_seg = mem_seg->address_left;
+        }
+    }
+
+    return lower_mem_seg;
+}
+
+int take_fitting_free_memory(int size,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    free_memory_segment_t *mem_seg;
+    int start_address;
+
+    /* Allocate a block, its process memory ending at the block's address,
+     * with buddy fit.
+     */
+    if (mem_segs_list->buddy != NULL)
+    {
+        start_address = allocate_buddy_block(size, mem_segs_list->buddy);
+        mem_segs_list->count = mem_segs_list->buddy->free_blocks;
+        return (start_address == NO_BLOCK) ? IN_DISK : start_address + size;
+    }
+
+    mem_seg = get_fitting_free_memory_segment(size, mem_segs_list);
+    if (mem_seg == NULL)
+    {
+        return IN_DISK;
+    }
+    start_address = mem_seg->start_address;
+
+    // Shrink free memory segment (unused by process).
+    remove_free_memory_segment(mem_seg, mem_segs_list);
+    mem_seg->start_address -= size;
+    mem_seg->size -= size;
+
+    // Delete free memory segment, because memory segment size is 0.
+    if (mem_seg->size == 0)
+    {
+        release_to_object_pool(mem_seg, mem_segs_list->mem_seg_pool);
+    }
+    else
+    {
+        insert_free_memory_segment(mem_seg, mem_segs_list);
+    }
+
+    return start_address;
+}
+
+free_memory_segment_t *get_fitting_free_memory_segment(int size,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    free_memory_segment_t *mem_seg, *best_mem_seg = NULL;
+
+    switch (mem_segs_list->fit_policy)
+    {
+        // Smallest free memory segment that fits, highest address if equal.
+        case best_fit:
+            mem_seg = mem_segs_list->size_root;
+            while (mem_seg != NULL)
             {
-                // Connect and reassign list's head
-                if (curr_mem_seg == mem_segs_list->head)
+                if (mem_seg->size >= size)
                 {
-                    mem_segs_list->head = mem_seg;
-                    mem_seg->next = curr_mem_seg;
+                    best_mem_seg = mem_seg;
+                    mem_seg = mem_seg->size_left;
                 }
-                // Add free memory segment into list.
                 else
                 {
-                    prev_mem_seg->next = mem_seg;
-                    mem_seg->next = curr_mem_seg;
+                    mem_seg = mem_seg->size_right;
                 }
-
-                break;
             }
+            return best_mem_seg;
+            break;
+        // Largest free memory segment if it fits, highest address if equal.
+        case worst_fit:
+            if (mem_segs_list->address_root == NULL ||
+                mem_segs_list->address_root->max_subtree_size < size)
+            {
+                return NULL;
+            }
+            return get_highest_free_memory_segment_of_size(
+                mem_segs_list->address_root->max_subtree_size, mem_segs_list
+                );
+            break;
+        // Highest addressed free memory segment that fits.
+        case first_fit:
+        default:
+            return get_highest_free_memory_segment_of_size(size, mem_segs_list);
+            break;
+    }
+}
 
-            prev_mem_seg = curr_mem_seg;
-            curr_mem_seg = curr_mem_seg->next;
-        }
+free_memory_segment_t *get_highest_free_memory_segment_of_size(int size,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    free_memory_segment_t *mem_seg = mem_segs_list->address_root;
 
-        // SPECIAL CASE: Add to end of list.
-        if (curr_mem_seg == NULL)
+    /* Walk down the address tree, preferring higher addresses, skipping
+     * subtrees whose largest free memory segment is too small.
+     */
+    if (mem_seg == NULL || mem_seg->max_subtree_size < size)
+    {
+        return NULL;
+    }
+    while (mem_seg != NULL)
+    {
+        if (mem_seg->address_right != NULL &&
+            mem_seg->address_right->max_subtree_size >= size)
+        {
+            mem_seg = mem_seg->address_right;
+        }
+        else if (mem_seg->size >= size)
+        {
+            break;
+        }
+        else
         {
-            prev_mem_seg->next = mem_seg;
-            mem_seg->next = curr_mem_seg;
+            mem_seg = mem_seg->address_left;
         }
     }
-
-    consolidate_free_memory_segments_list(mem_segs_list);
+
+    return mem_seg;
+}
+
+void update_free_memory_segment_max_subtree_size(free_memory_segment_t *mem_seg)
+{
+    mem_seg->max_subtree_size = mem_seg->size;
+    if (mem_seg->address_left != NULL &&
+        mem_seg->address_left->max_subtree_size > mem_seg->max_subtree_size)
+    {
+        mem_seg->max_subtree_size = mem_seg->address_left->max_subtree_size;
+    }
+    if (mem_seg->address_right != NULL &&
+        mem_seg->address_right->max_subtree_size > mem_seg->max_subtree_size)
+    {
+        mem_seg->max_subtree_size = mem_seg->address_right->max_subtree_size;
+    }
+    return;
+}
+
+int is_free_memory_segment_before_by_size(free_memory_segment_t *mem_seg,
+    free_memory_segment_t *other_mem_seg)
+{
+    return (mem_seg->size < other_mem_seg->size ||
+        (mem_seg->size == other_mem_seg->size &&
+        mem_seg->start_address > other_mem_seg->start_address));
+}
+
+free_memory_segment_t *insert_into_free_memory_segments_address_tree(
+    free_memory_segment_t *mem_seg, free_memory_segment_t *root)
+{
+    // Empty tree, new free memory segment is the tree.
+    if (root == NULL)
+    {
+        return mem_seg;
+    }
+
+    // New free memory segment has higher priority, so it becomes the root.
+    if (mem_seg->tree_priority > root->tree_priority)
+    {
+        split_free_memory_segments_address_tree(root, mem_seg->start_address,
+            &mem_seg->address_left, &mem_seg->address_right);
+        update_free_memory_segment_max_subtree_size(mem_seg);
+        return mem_seg;
+    }
+
+    // Insert into subtree by start address.
+    if (mem_seg->start_address < root->start_address)
+    {
+        root->address_left = insert_into_free_memory_segments_address_tree(
+            mem_seg, root->address_left
+            );
+    }
+    else
+    {
+        root->address_right = insert_into_free_memory_segments_address_tree(
+            mem_seg, root->address_right
+            );
+    }
+    update_free_memory_segment_max_subtree_size(root);
+
+    return root;
+}
+
+free_memory_segment_t *remove_from_free_memory_segments_address_tree(
+    free_memory_segment_t *mem_seg, free_memory_segment_t *root)
+{
+    // Replace free memory segment with its merged subtrees.
+    if (root == mem_seg)
+    {
+        return merge_free_memory_segments_address_trees(
+            mem_seg->address_left, mem_seg->address_right
+            );
+    }
+
+    // Remove from subtree by start address.
+    if (mem_seg->start_address < root->start_address)
+    {
+        root->address_left = remove_from_free_memory_segments_address_tree(
+            mem_seg, root->address_left
+            );
+    }
+    else
+    {
+        root->address_right = remove_from_free_memory_segments_address_tree(
+            mem_seg, root->address_right
+            );
+    }
+    update_free_memory_segment_max_subtree_size(root);
+
+    return root;
+}
+
+void split_free_memory_segments_address_tree(free_memory_segment_t *root,
+    int start_address, free_memory_segment_t **lower,
+    free_memory_segment_t **upper)
+{
+    if (root == NULL)
+    {
+        *lower = *upper = NULL;
+        return;
+    }
+
+    // Lower tree takes start addresses less than start_address.
+    if (root->start_address < start_address)
+    {
+        split_free_memory_segments_address_tree(root->address_right,
+            start_address, &root->address_right, upper);
+        *lower = root;
+    }
+    else
+    {
+        split_free_memory_segments_address_tree(root->address_left,
+            start_address, lower, &root->address_left);
+        *upper = root;
+    }
+    update_free_memory_segment_max_subtree_size(root);
+
+    return;
+}
+
+free_memory_segment_t *merge_free_memory_segments_address_trees(
+    free_memory_segment_t *lower, free_memory_segment_t *upper)
+{
+    if (lower == NULL)
+    {
+        return upper;
+    }
+    if (upper == NULL)
+    {
+        return lower;
+    }
+
+    // Higher priority becomes the root.
+    if (lower->tree_priority > upper->tree_priority)
+    {
+        lower->address_right = merge_free_memory_segments_address_trees(
+            lower->address_right, upper
+            );
+        update_free_memory_segment_max_subtree_size(lower);
+        return lower;
+    }
+    else
+    {
+        upper->address_left = merge_free_memory_segments_address_trees(
+            lower, upper->address_left
+            );
+        update_free_memory_segment_max_subtree_size(upper);
+        return upper;
+    }
+}
+
+free_memory_segment_t *insert_into_free_memory_segments_size_tree(
+    free_memory_segment_t *mem_seg, free_memory_segment_t *root)
+{
+    // Empty tree, new free memory segment is the tree.
+    if (root == NULL)
+    {
+        return mem_seg;
+    }
+
+    // New free memory segment has higher priority, so it becomes the root.
+    if (mem_seg->tree_priority > root->tree_priority)
+    {
+        split_free_memory_segments_size_tree(root, mem_seg,
+            &mem_seg->size_left, &mem_seg->size_right);
+        return mem_seg;
+    }
+
+    // Insert into subtree by size.
+    if (is_free_memory_segment_before_by_size(mem_seg, root))
+    {
+        root->size_left = insert_into_free_memory_segments_size_tree(
+            mem_seg, root->size_left
+            );
+    }
+    else
+    {
+        root->size_right = insert_into_free_memory_segments_size_tree(
+            mem_seg, root->size_right
+            );
+    }
+
+    return root;
+}
+
+free_memory_segment_t *remove_from_free_memory_segments_size_tree(
+    free_memory_segment_t *mem_seg, free_memory_segment_t *root)
+{
+    // Replace free memory segment with its merged subtrees.
+    if (root == mem_seg)
+    {
+        return merge_free_memory_segments_size_trees(
+            mem_seg->size_left, mem_seg->size_right
+            );
+    }
+
+    // Remove from subtree by size.
+    if (is_free_memory_segment_before_by_size(mem_seg, root))
+    {
+        root->size_left = remove_from_free_memory_segments_size_tree(
+            mem_seg, root->size_left
+            );
+    }
+    else
+    {
+        root->size_right = remove_from_free_memory_segments_size_tree(
+            mem_seg, root->size_right
+            );
+    }
+
+    return root;
+}
+
+void split_free_memory_segments_size_tree(free_memory_segment_t *root,
+    free_memory_segment_t *key_mem_seg, free_memory_segment_t **lower,
+    free_memory_segment_t **upper)
+{
+    if (root == NULL)
+    {
+        *lower = *upper = NULL;
+        return;
+    }
+
+    // Lower tree takes free memory segments ordered before key_mem_seg.
+    if (is_free_memory_segment_before_by_size(root, key_mem_seg))
+    {
+        split_free_memory_segments_size_tree(root->size_right, key_mem_seg,
+            &root->size_right, upper);
+        *lower = root;
+    }
+    else
+    {
+        split_free_memory_segments_size_tree(root->size_left, key_mem_seg,
+            lower, &root->size_left);
+        *upper = root;
+    }
+
+    return;
+}
+
+free_memory_segment_t *merge_free_memory_segments_size_trees(
+    free_memory_segment_t *lower, free_memory_segment_t *upper)
+{
+    if (lower == NULL)
+    {
+        return upper;
+    }
+    if (upper == NULL)
+    {
+        return lower;
+    }
+
+    // Higher priority becomes the root.
+    if (lower->tree_priority > upper->tree_priority)
+    {
+        lower->size_right = merge_free_memory_segments_size_trees(
+            lower->size_right, upper
+            );
+        return lower;
+    }
+    else
+    {
+        upper->size_left = merge_free_memory_segments_size_trees(
+            lower, upper->size_left
+            );
+        return upper;
+    }
+}
+
+process_memories_list_t *new_process_memories_list()
+{
+    process_memories_list_t *proc_mems_list;
+
+    // Allocate memory for process memories list and error check.
+    proc_mems_list = (process_memories_list_t*)malloc(sizeof(process_memories_list_t));
+    if (proc_mems_list == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set process memories list.
+    proc_mems_list->head = NULL;
+    proc_mems_list->tail = NULL;
+    proc_mems_list->next_sequence = 0;
+    proc_mems_list->eviction_policy = &largest_eviction_policy;
+    proc_mems_list->resident_head = NULL;
+    proc_mems_list->resident_tail = NULL;
+    proc_mems_list->clock_hand = NULL;
+    proc_mems_list->eviction_inflation = 0;
+    proc_mems_list->proc_mem_pool = new_object_pool(
+        sizeof(process_memory_t), PROCESS_MEMORIES_PER_SLAB
+        );
+    proc_mems_list->resident_count = 0;
+    proc_mems_list->resident_size = 0;
+    proc_mems_list->event_log = NULL;
+    proc_mems_list->pinned_count = 0;
+    proc_mems_list->page_frames = NULL;
+
+    // Allocate array for heap of process memories in main memory.
+    proc_mems_list->resident_heap_len = 0;
+    proc_mems_list->resident_heap_max_len = INITIAL_RESIDENT_HEAP_MAX_LEN;
+    proc_mems_list->resident_heap = (process_memory_t**)malloc(sizeof(process_memory_t*) * proc_mems_list->resident_heap_max_len);
+    if (proc_mems_list->resident_heap == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Allocate empty index of process memories by process id.
+    proc_mems_list->index_len = 0;
+    proc_mems_list->index_max_len = INITIAL_PROCESS_MEMORIES_INDEX_MAX_LEN;
+    proc_mems_list->index = (process_memory_t**)calloc(proc_mems_list->index_max_len, sizeof(process_memory_t*));
+    if (proc_mems_list->index == NULL)
+    {
+        perror("calloc");
+        exit(1);
+    }
+
+    return proc_mems_list;
+}
+
+void set_process_memories_list_eviction_policy(
+    process_memories_list_t *proc_mems_list,
+    const eviction_policy_t *eviction_policy)
+{
+    proc_mems_list->eviction_policy = eviction_policy;
+    return;
+}
+
+void set_process_memories_list_event_log(
+    process_memories_list_t *proc_mems_list, event_log_t *event_log)
+{
+    proc_mems_list->event_log = event_log;
+    return;
+}
+
+process_memory_t *new_process_memory(int size, int process_id,
+    process_memories_list_t *proc_mems_list)
+{
+    process_memory_t *proc_mem;
+
+    // Allocate process memory from the list's pool.
+    proc_mem = (process_memory_t*)allocate_from_object_pool(
+        proc_mems_list->proc_mem_pool
+        );
+
+    // Set process memory.
+    proc_mem->next = NULL;
+    proc_mem->prev = NULL;
+    proc_mem->start_address = IN_DISK;
+    proc_mem->size = size;
+    proc_mem->swap_in_time = 0;
+    proc_mem->process_id = process_id;
+    proc_mem->sequence = 0;
+    proc_mem->heap_index = NOT_IN_HEAP;
+    proc_mem->swap_count = 0;
+    proc_mem->pinned = 0;
+    proc_mem->page_table = NULL;
+    proc_mem->pages = 0;
+    proc_mem->resident_pages = 0;
+    proc_mem->next_page = 0;
+    proc_mem->resident_prev = NULL;
+    proc_mem->resident_next = NULL;
+    proc_mem->referenced = 0;
+    proc_mem->eviction_value = 0;
+
+    return proc_mem;
+}
+
+void add_process_memory_to_process_memories_list(process_memory_t *new_proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    // Number process memories in list order, used to break swap out ties.
+    new_proc_mem->sequence = proc_mems_list->next_sequence;
+    proc_mems_list->next_sequence++;
+
+    append_process_memory_to_process_memories_list(new_proc_mem, proc_mems_list);
+
+    return;
+}
+
+void append_process_memory_to_process_memories_list(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    // Index it first, so the list holds just the indexed if the index grows.
+    add_process_memory_to_process_memories_index(proc_mem, proc_mems_list);
+
+    // Link after the tail, or as head/first element of an empty list.
+    proc_mem->next = NULL;
+    proc_mem->prev = proc_mems_list->tail;
+    if (proc_mems_list->tail == NULL)
+    {
+        proc_mems_list->head = proc_mem;
+    }
+    else
+    {
+        proc_mems_list->tail->next = proc_mem;
+    }
+    proc_mems_list->tail = proc_mem;
+
+    return;
+}
+
+void add_process_memory_to_process_memories_index(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    int i, mask;
+
+    // Grow index first if it would be more than half full.
+    if (2 * (proc_mems_list->index_len + 1) > proc_mems_list->index_max_len)
+    {
+        grow_process_memories_index(proc_mems_list);
+    }
+
+    // Take the first empty entry of its probe sequence.
+    mask = proc_mems_list->index_max_len - 1;
+    i = get_process_id_hash(proc_mem->process_id, proc_mems_list);
+    while (proc_mems_list->index[i] != NULL)
+    {
+        i = (i + 1) & mask;
+    }
+    proc_mems_list->index[i] = proc_mem;
+    proc_mems_list->index_len++;
+
+    return;
+}
+
+void remove_process_memory_from_process_memories_index(
+    process_memory_t *proc_mem, process_memories_list_t *proc_mems_list)
+{
+    process_memory_t **index = proc_mems_list->index;
+    int hole, i, home, mask = proc_mems_list->index_max_len - 1;
+
+    // Find its entry along its probe sequence.
+    hole = get_process_id_hash(proc_mem->process_id, proc_mems_list);
+    while (index[hole] != proc_mem)
+    {
+        hole = (hole + 1) & mask;
+    }
+
+    /* Move back each later entry of the run whose probe sequence starts at or
+     * before the hole, so every entry stays reachable from where its probe
+     * sequence starts (and entries of the same process id keep their order).
+     */
+    for (i = (hole + 1) & mask; index[i] != NULL; i = (i + 1) & mask)
+    {
+        home = get_process_id_hash(index[i]->process_id, proc_mems_list);
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            index[hole] = index[i];
+            hole = i;
+        }
+    }
+    index[hole] = NULL;
+    proc_mems_list->index_len--;
+
+    return;
+}
+
+void grow_process_memories_index(process_memories_list_t *proc_mems_list)
+{
+    process_memory_t *proc_mem;
+
+    // Allocate a larger, empty index and error check.
+    free(proc_mems_list->index);
+    proc_mems_list->index_max_len *= PROCESS_MEMORIES_INDEX_GROW_FACTOR;
+    proc_mems_list->index = (process_memory_t**)calloc(proc_mems_list->index_max_len, sizeof(process_memory_t*));
+    if (proc_mems_list->index == NULL)
+    {
+        perror("calloc");
+        exit(1);
+    }
+
+    // Re-add process memories in list order, the order they were added.
+    proc_mems_list->index_len = 0;
+    for (proc_mem = proc_mems_list->head; proc_mem != NULL; proc_mem = proc_mem->next)
+    {
+        add_process_memory_to_process_memories_index(proc_mem, proc_mems_list);
+    }
+
+    return;
+}
+
+int get_process_id_hash(int process_id, process_memories_list_t *proc_mems_list)
+{
+    unsigned int hash = (unsigned int)process_id * PROCESS_ID_HASH_MULTIPLIER;
+    hash ^= hash >> 16;
+    return hash & (proc_mems_list->index_max_len - 1);
+}
+
+void add_new_process_memory_to_process_memories_list(int size, int process_id,
+    process_memories_list_t *proc_mems_list)
+{
+    process_memory_t *proc_mem = new_process_memory(size, process_id, proc_mems_list);
+    add_process_memory_to_process_memories_list(proc_mem, proc_mems_list);
+    return;
+}
+
+int get_process_memory_end_address(process_memory_t *proc_mem)
+{
+    return proc_mem->start_address - proc_mem->size;
+}
+
+int is_process_memory_in_disk(process_memory_t *proc_mem)
+{
+    return (proc_mem->start_address == IN_DISK);
+}
+
+void remove_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    // Unlink from its neighbours, reassigning list's head or tail if it is one.
+    if (proc_mem->prev == NULL)
+    {
+        proc_mems_list->head = proc_mem->next;
+    }
+    else
+    {
+        proc_mem->prev->next = proc_mem->next;
+    }
+    if (proc_mem->next == NULL)
+    {
+        proc_mems_list->tail = proc_mem->prev;
+    }
+    else
+    {
+        proc_mem->next->prev = proc_mem->prev;
+    }
+    remove_process_memory_from_process_memories_index(proc_mem, proc_mems_list);
+
+    // Release its page frames and page table, if paged.
+    if (proc_mems_list->page_frames != NULL)
+    {
+        swap_out_paged_process_memory(proc_mem, proc_mems_list);
+        free(proc_mem->page_table);
+        proc_mem->page_table = NULL;
+    }
+    /* Add free memory segment to list in sorted descending start address
+     * order.
+     */
+    else if (!is_process_memory_in_disk(proc_mem))
+    {
+        unpin_process_memory(proc_mem, proc_mems_list);
+        proc_mems_list->eviction_policy->remove(proc_mem, proc_mems_list);
+        add_new_free_memory_segment_to_free_memory_segments_list(
+            proc_mem->start_address,
+            proc_mem->size,
+            mem_segs_list
+            );
+        proc_mems_list->resident_count--;
+        proc_mems_list->resident_size -= proc_mem->size;
+        log_holes_count(proc_mems_list->event_log, mem_segs_list->count);
+    }
+
+    // Release memory.
+    release_to_object_pool(proc_mem, proc_mems_list->proc_mem_pool);
+
+    return;
+}
+
+int remove_process_memory_by_process_id(int process_id,
+    process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    process_memory_t *proc_mem;
+
+    // Find process in list, and remove it if found.
+    proc_mem = get_process_memory_by_process_id(process_id, proc_mems_list);
+    if (proc_mem == NULL)
+    {
+        return 0;
+    }
+    remove_process_memory(proc_mem, proc_mems_list, mem_segs_list);
+
+    return 1;
+}
+
+process_memory_t *get_process_memory_by_process_id(int process_id,
+    process_memories_list_t *proc_mems_list)
+{
+    process_memory_t **index = proc_mems_list->index;
+    int i, mask = proc_mems_list->index_max_len - 1;
+
+    // Probe the index from the process id's hash until found or empty.
+    for (i = get_process_id_hash(process_id, proc_mems_list); index[i] != NULL; i = (i + 1) & mask)
+    {
+        if (index[i]->process_id == process_id)
+        {
+            return index[i];
+        }
+    }
+
+    return NULL;
+}
+
+int swap_in_process_memory(process_memory_t *proc_mem, int time,
+    process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list)
+{
+    // Paged process memories are swapped in a page at a time, on demand.
+    if (proc_mems_list->page_frames != NULL)
+    {
+        swap_in_paged_process_memory(proc_mem, time, proc_mems_list);
+        return 1;
+    }
+
+    while (is_process_memory_in_disk(proc_mem))
+    {
+        // Take free memory with fittable size by the list's fit policy.
+        proc_mem->start_address = take_fitting_free_memory(
+            proc_mem->size, mem_segs_list
+            );
+        if (!is_process_memory_in_disk(proc_mem))
+        {
+            // Occupy free memory.
+            proc_mem->swap_in_time = time;
+            proc_mem->swap_count++;
+            proc_mems_list->eviction_policy->add(proc_mem, proc_mems_list);
+            proc_mems_list->resident_count++;
+            proc_mems_list->resident_size += proc_mem->size;
+
+            log_simulation_event(proc_mems_list->event_log, swap_in_event,
+                proc_mem->process_id, proc_mem->start_address, proc_mem->size);
+            log_holes_count(proc_mems_list->event_log, mem_segs_list->count);
+
+            return 1;
+        }
+
+        /* Free memory is enough but too fragmented, so compact it into one
+         * free memory segment rather than swap out.
+         */
+        if (is_compaction_needed(proc_mem->size, proc_mems_list, mem_segs_list))
+        {
+            compact_main_memory(proc_mems_list, mem_segs_list);
+            continue;
+        }
+
+        /* No process memory left to swap out, so it can never fit, unless some
+         * are pinned. Counted rather than asked of the eviction policy, as
+         * choosing a victim moves the clock hand and the inflation.
+         */
+        if (proc_mems_list->resident_count - proc_mems_list->pinned_count == 0)
+        {
+            if (proc_mems_list->pinned_count > 0)
+            {
+                return 0;
+            }
+            // Blocks are at most the largest power of two in main memory.
+            if (mem_segs_list->buddy != NULL)
+            {
+                fprintf(stderr, "Process memory larger than largest buddy block\n");
+                exit(1);
+            }
+            fprintf(stderr, "Process memory larger than main memory\n");
+            exit(1);
+        }
+        swap_out_process_memory(proc_mems_list, mem_segs_list);
+    }
+
+    return 1;
+}
+
+void pin_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    // Pages are replaced one at a time instead, so are never pinned.
+    if (proc_mems_list->page_frames == NULL &&
+        !is_process_memory_in_disk(proc_mem) && !proc_mem->pinned)
+    {
+        proc_mem->pinned = 1;
+        proc_mems_list->pinned_count++;
+    }
+    return;
+}
+
+void unpin_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    if (proc_mem->pinned)
+    {
+        proc_mem->pinned = 0;
+        proc_mems_list->pinned_count--;
+        // Its process was running, so it counts as used.
+        proc_mems_list->eviction_policy->access(proc_mem, proc_mems_list);
+    }
     return;
 }
 
-int get_free_memory_segment_end_address(free_memory_segment_t *mem_seg)
+void access_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
 {
-    return mem_seg->start_address - mem_seg->size;
+    // Pages in frames are marked as used when touched instead, if paged.
+    if (proc_mems_list->page_frames == NULL && !is_process_memory_in_disk(proc_mem))
+    {
+        proc_mems_list->eviction_policy->access(proc_mem, proc_mems_list);
+    }
+    return;
 }
 
-void consolidate_free_memory_segments_list(
+void swap_out_process_memory(process_memories_list_t *proc_mems_list,
     free_memory_segments_list_t *mem_segs_list)
 {
-    free_memory_segment_t *curr_mem_seg = mem_segs_list->head, *next_mem_seg;
-    int curr_mem_seg_end_add;
+    process_memory_t *proc_mem;
 
-    // Iterate over list and consolidate contiguous free memory segments.
-    while (curr_mem_seg != NULL)
+    // Let the clock choose a page to swap out, if paged.
+    if (proc_mems_list->page_frames != NULL)
     {
-        // No more memory segments to consolidate.
-        next_mem_seg = curr_mem_seg->next;
-        if (next_mem_seg == NULL)
-        {
-            break;
-        }
-
-        // Memory segment ends where next memory segment starts, so consolidate.
-        curr_mem_seg_end_add = get_free_memory_segment_end_address(curr_mem_seg);
-        if (curr_mem_seg_end_add == next_mem_seg->start_address)
-        {
-            curr_mem_seg->next = next_mem_seg->next;
-            curr_mem_seg->size += next_mem_seg->size;
-
-            // Release memory.
-            free(next_mem_seg);
+        swap_out_page_by_clock(proc_mems_list);
+        return;
+    }
 
-            /* Don't go to next iteration, might be more contiguous memory to
-             * consolidate.
-             */
-            next_mem_seg = curr_mem_seg->next;
-        }
-        else
-        {
-            curr_mem_seg = next_mem_seg;
-            next_mem_seg = curr_mem_seg->next;
-        }
+    // Let the eviction policy choose process memory to swap out.
+    proc_mem = proc_mems_list->eviction_policy->get_victim(proc_mems_list);
+    if (proc_mem != NULL)
+    {
+        swap_out_process_memory_by_process_memory(
+            proc_mem, proc_mems_list, mem_segs_list
+            );
     }
 
     return;
 }
 
-int get_free_memory_segments_list_count(
+void swap_out_process_memory_by_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list,
     free_memory_segments_list_t *mem_segs_list)
 {
-    int count = 0;
+    // Swap out each of its pages, if paged.
+    if (proc_mems_list->page_frames != NULL)
+    {
+        swap_out_paged_process_memory(proc_mem, proc_mems_list);
+    }
+    // Can only swap out processes in memory (not disk).
+    else if (!is_process_memory_in_disk(proc_mem))
+    {
+        unpin_process_memory(proc_mem, proc_mems_list);
+        proc_mems_list->eviction_policy->remove(proc_mem, proc_mems_list);
 
-    free_memory_segment_t *mem_seg = mem_segs_list->head;
+        // Add memory occupied by process back as free memory segment into list.
+        add_new_free_memory_segment_to_free_memory_segments_list(
+            proc_mem->start_address,
+            proc_mem->size,
+            mem_segs_list);
 
-    // Iterate over list and count.
-    while (mem_seg != NULL)
-    {
-        count++;
+        log_simulation_event(proc_mems_list->event_log, swap_out_event,
+            proc_mem->process_id, proc_mem->start_address, proc_mem->size);
+        log_holes_count(proc_mems_list->event_log, mem_segs_list->count);
 
-        mem_seg = mem_seg->next;
+        // Update process memory attributes.
+        proc_mem->start_address = IN_DISK;
+        proc_mem->swap_in_time = 0;
+        proc_mems_list->resident_count--;
+        proc_mems_list->resident_size -= proc_mem->size;
     }
 
-    return count;
+    return;
 }
 
-process_memories_list_t *new_process_memories_list()
+int is_compaction_needed(int size, process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list)
 {
-    process_memories_list_t *proc_mems_list;
+    int free_size = mem_segs_list->size - proc_mems_list->resident_size;
+    int largest_hole_size = (mem_segs_list->address_root != NULL) ?
+        mem_segs_list->address_root->max_subtree_size : 0;
 
-    // Allocate memory for process memories list and error check.
-    proc_mems_list = (process_memories_list_t*)malloc(sizeof(process_memories_list_t));
-    if (proc_mems_list == NULL)
+    // Buddy blocks are aligned, so cannot be slid together.
+    if (mem_segs_list->compaction_threshold == NO_COMPACTION ||
+        mem_segs_list->buddy != NULL || free_size < size)
     {
-        perror("malloc");
-        exit(1);
+        return 0;
     }
 
-    // Set process memories list.
-    proc_mems_list->head = NULL;
-
-    return proc_mems_list;
+    // External fragmentation as a percentage, rounded up like memory usage.
+    return (100L * (free_size - largest_hole_size) + free_size - 1) / free_size >=
+        mem_segs_list->compaction_threshold;
 }
 
-process_memory_t *new_process_memory(int size, int process_id)
+void compact_main_memory(process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list)
 {
-    process_memory_t *proc_mem;
-
-    // Allocate memory for process memory and error check.
-    proc_mem = (process_memory_t*)malloc(sizeof(process_memory_t));
-    if (proc_mem == NULL)
+    process_memory_t **resident, *proc_mem;
+    free_memory_segment_t *mem_seg, *next_mem_seg;
+    int i, len, start_address;
+    long moved_size = 0;
+
+    // Allocate memory for the process memories in main memory and error check.
+    resident = (process_memory_t**)malloc(
+        sizeof(process_memory_t*) * (proc_mems_list->resident_count + 1)
+        );
+    if (resident == NULL)
     {
         perror("malloc");
         exit(1);
     }
 
-    // Set process memory.
-    proc_mem->next = NULL;
-    proc_mem->start_address = IN_DISK;
-    proc_mem->size = size;
-    proc_mem->swap_in_time = 0;
-    proc_mem->process_id = process_id;
-
-    return proc_mem;
-}
-
-void add_process_memory_to_process_memories_list(process_memory_t *new_proc_mem,
-    process_memories_list_t *proc_mems_list)
-{
-    process_memory_t *curr_proc_mem, *next_proc_mem;
-
-    // If list is empty, add process as head/first element of list.
-    if (proc_mems_list->head == NULL)
+    /* Collect process memories in main memory from the eviction policy's
+     * resident heap or list, which also hold pinned ones, highest addressed
+     * first.
+     */
+    len = 0;
+    if (proc_mems_list->eviction_policy->is_evicted_before != NULL)
     {
-        proc_mems_list->head = new_proc_mem;
+        for (i = 0; i < proc_mems_list->resident_heap_len; i++)
+        {
+            resident[len++] = proc_mems_list->resident_heap[i];
+        }
     }
-    // Append process to end of list.
     else
     {
-        // Iterate to end of list.
-        curr_proc_mem = proc_mems_list->head;
-        next_proc_mem = curr_proc_mem->next;
-        while (next_proc_mem != NULL)
+        for (proc_mem = proc_mems_list->resident_head; proc_mem != NULL;
+            proc_mem = proc_mem->resident_next)
         {
-            curr_proc_mem = next_proc_mem;
-            next_proc_mem = curr_proc_mem->next;
+            resident[len++] = proc_mem;
         }
+    }
+    qsort(resident, len, sizeof(process_memory_t*),
+        compare_process_memories_by_start_address);
 
-        curr_proc_mem->next = new_proc_mem;
+    // Slide each up against the one above it, rewriting its start address.
+    start_address = mem_segs_list->size;
+    for (i = 0; i < len; i++)
+    {
+        if (resident[i]->start_address != start_address)
+        {
+            resident[i]->start_address = start_address;
+            moved_size += resident[i]->size;
+        }
+        start_address -= resident[i]->size;
     }
+    free(resident);
 
-    return;
-}
+    // Replace every free memory segment with the one left at the bottom.
+    mem_seg = mem_segs_list->head;
+    while (mem_seg != NULL)
+    {
+        next_mem_seg = mem_seg->next;
+        release_to_object_pool(mem_seg, mem_segs_list->mem_seg_pool);
+        mem_seg = next_mem_seg;
+    }
+    mem_segs_list->head = NULL;
+    mem_segs_list->address_root = NULL;
+    mem_segs_list->size_root = NULL;
+    mem_segs_list->count = 0;
+    if (start_address > 0)
+    {
+        insert_free_memory_segment(
+            new_free_memory_segment(start_address, start_address, mem_segs_list),
+            mem_segs_list
+            );
+    }
+    mem_segs_list->compactions++;
+    mem_segs_list->compacted_size += moved_size;
+
+    log_simulation_event(proc_mems_list->event_log, compact_event,
+        NO_EVENT_VALUE, NO_EVENT_VALUE, (int)moved_size);
+    log_holes_count(proc_mems_list->event_log, mem_segs_list->count);
 
-void add_new_process_memory_to_process_memories_list(int size, int process_id,
-    process_memories_list_t *proc_mems_list)
-{
-    process_memory_t *proc_mem = new_process_memory(size, process_id);
-    add_process_memory_to_process_memories_list(proc_mem, proc_mems_list);
     return;
 }
 
-int get_process_memory_end_address(process_memory_t *proc_mem)
+int compare_process_memories_by_start_address(const void *a, const void *b)
 {
-    return proc_mem->start_address - proc_mem->size;
+    int x = (*(process_memory_t* const*)a)->start_address;
+    int y = (*(process_memory_t* const*)b)->start_address;
+    return (x < y) - (x > y);
 }
 
-int is_process_memory_in_disk(process_memory_t *proc_mem)
+int is_process_memory_swapped_out_before(process_memory_t *proc_mem,
+    process_memory_t *other_proc_mem)
 {
-    return (proc_mem->start_address == IN_DISK);
+    /* Larger first, then swapped in earlier, then later in the process
+     * memories list.
+     */
+    if (proc_mem->size != other_proc_mem->size)
+    {
+        return (proc_mem->size > other_proc_mem->size);
+    }
+    if (proc_mem->swap_in_time != other_proc_mem->swap_in_time)
+    {
+        return (proc_mem->swap_in_time < other_proc_mem->swap_in_time);
+    }
+    return (proc_mem->sequence > other_proc_mem->sequence);
 }
 
-int remove_process_memory_by_process_id(int process_id,
-    process_memories_list_t *proc_mems_list,
-    free_memory_segments_list_t *mem_segs_list)
+void add_process_memory_to_resident_heap(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
 {
-    int result = 0;
-
-    process_memory_t *prev_proc_mem, *curr_proc_mem;
-
-    // List is empty, don't do anything.
-    if (proc_mems_list->head == NULL)
-    {
-    }
-    // Find process in list.
-    else
+    // Grow heap array first if necessary.
+    if (proc_mems_list->resident_heap_len == proc_mems_list->resident_heap_max_len)
     {
-        // Iterate towards end of list.
-        prev_proc_mem = NULL;
-        curr_proc_mem = proc_mems_list->head;
-        while (curr_proc_mem != NULL)
+        proc_mems_list->resident_heap_max_len *= RESIDENT_HEAP_GROW_FACTOR;
+        proc_mems_list->resident_heap = (process_memory_t**)realloc(proc_mems_list->resident_heap, sizeof(process_memory_t*) * proc_mems_list->resident_heap_max_len);
+        if (proc_mems_list->resident_heap == NULL)
         {
-            /* Remove process memory from list, add free memory segments (if
-             * process memory is in RAM), and free memory.
-             */
-            if (curr_proc_mem->process_id == process_id)
-            {
-                result = 1;  // Found process memory matching process id.
-
-                // Remove and reassign list's head.
-                if (curr_proc_mem == proc_mems_list->head)
-                {
-                    proc_mems_list->head = curr_proc_mem->next;
-                }
-                // Remove process memory from list.
-                else
-                {
-                    prev_proc_mem->next = curr_proc_mem->next;
-                }
-
-                /* Add free memory segment to list in sorted descending start
-                 * address order.
-                 */
-                if (!is_process_memory_in_disk(curr_proc_mem))
-                {
-                    add_new_free_memory_segment_to_free_memory_segments_list(
-                        curr_proc_mem->start_address,
-                        curr_proc_mem->size,
-                        mem_segs_list
-                        );
-                }
-
-                // Free memory.
-                free(curr_proc_mem);
-
-                break;
-            }
-
-            prev_proc_mem = curr_proc_mem;
-            curr_proc_mem = curr_proc_mem->next;
+            perror("realloc");
+            exit(1);
         }
     }
 
-    return result;
+    // Add to bottom of heap and move up to position.
+    proc_mem->heap_index = proc_mems_list->resident_heap_len;
+    proc_mems_list->resident_heap[proc_mem->heap_index] = proc_mem;
+    proc_mems_list->resident_heap_len++;
+    sift_up_resident_heap(proc_mem->heap_index, proc_mems_list);
+
+    return;
 }
 
-process_memory_t *get_process_memory_by_process_id(int process_id,
+void remove_process_memory_from_resident_heap(process_memory_t *proc_mem,
     process_memories_list_t *proc_mems_list)
 {
-    process_memory_t *proc_mem;
+    int i = proc_mem->heap_index;
+    process_memory_t *last_proc_mem;
 
-    // Iterate over list and find process memory by process id.
-    proc_mem = proc_mems_list->head;
-    while (proc_mem != NULL)
+    // Not in heap, don't do anything.
+    if (i == NOT_IN_HEAP)
     {
-        if (proc_mem->process_id == process_id)
-        {
-            break;
-        }
+        return;
+    }
 
-        proc_mem = proc_mem->next;
+    // Move last process memory into the hole and restore heap order.
+    proc_mems_list->resident_heap_len--;
+    last_proc_mem = proc_mems_list->resident_heap[proc_mems_list->resident_heap_len];
+    if (last_proc_mem != proc_mem)
+    {
+        proc_mems_list->resident_heap[i] = last_proc_mem;
+        last_proc_mem->heap_index = i;
+        sift_up_resident_heap(i, proc_mems_list);
+        sift_down_resident_heap(last_proc_mem->heap_index, proc_mems_list);
     }
+    proc_mem->heap_index = NOT_IN_HEAP;
 
-    return proc_mem;
+    return;
 }
 
-void swap_in_process_memory(process_memory_t *proc_mem, int time,
-    process_memories_list_t *proc_mems_list,
-    free_memory_segments_list_t *mem_segs_list)
+void sift_up_resident_heap(int i, process_memories_list_t *proc_mems_list)
 {
-    free_memory_segment_t *prev_mem_seg, *curr_mem_seg;
+    process_memory_t **heap = proc_mems_list->resident_heap, *proc_mem = heap[i];
+    int parent;
 
-    while (is_process_memory_in_disk(proc_mem))
+    // Move up while ordered before parent.
+    while (i > 0)
     {
-        // Iterate over list and find memory segment with fittable size.
-        prev_mem_seg = NULL;
-        curr_mem_seg = mem_segs_list->head;
-        while (curr_mem_seg != NULL)
+        parent = (i - 1) / 2;
+        if (!proc_mems_list->eviction_policy->is_evicted_before(proc_mem, heap[parent]))
         {
-            // Find free memory segment with size greater than process.
-            if (proc_mem->size <= curr_mem_seg->size)
-            {
-                // Occupy free memory segment.
-                proc_mem->start_address = curr_mem_seg->start_address;
-                proc_mem->swap_in_time = time;
-
-                // Shrink free memory segment (unused by process).
-                curr_mem_seg->start_address = get_process_memory_end_address(proc_mem);
-                curr_mem_seg->size -= proc_mem->size;
-
-                // Delete free memory segment, because memory segment size is 0.
-                if (curr_mem_seg->size == 0)
-                {
-                    // Remove and reassign list's head.
-                    if (curr_mem_seg == mem_segs_list->head)
-                    {
-                        mem_segs_list->head = curr_mem_seg->next;
-                    }
-                    // Remove memory segment from list.
-                    else
-                    {
-                        prev_mem_seg->next = curr_mem_seg->next;
-                    }
-
-                    free(curr_mem_seg);
-                }
-
-                return;
-            }
-
-            prev_mem_seg = curr_mem_seg;
-            curr_mem_seg = curr_mem_seg->next;
+            break;
         }
-
-        swap_out_process_memory(proc_mems_list, mem_segs_list);
+        heap[i] = heap[parent];
+        heap[i]->heap_index = i;
+        i = parent;
     }
+    heap[i] = proc_mem;
+    proc_mem->heap_index = i;
 
     return;
 }
 
-void swap_out_process_memory(process_memories_list_t *proc_mems_list,
-    free_memory_segments_list_t *mem_segs_list)
+void sift_down_resident_heap(int i, process_memories_list_t *proc_mems_list)
 {
-    process_memory_t *swap_out_proc_mem, *proc_mem;
+    process_memory_t **heap = proc_mems_list->resident_heap, *proc_mem = heap[i];
+    int len = proc_mems_list->resident_heap_len, child;
 
-    /* Initialise swap_out_proc_mem with a process that can be swapped out to be
-     * compared against.
-     */
-    proc_mem = proc_mems_list->head;
-    while (proc_mem != NULL)
+    // Move down while a child is ordered before.
+    while ((child = 2 * i + 1) < len)
     {
-        if (!is_process_memory_in_disk(proc_mem))
+        if (child + 1 < len &&
+            proc_mems_list->eviction_policy->is_evicted_before(heap[child + 1], heap[child]))
         {
-            swap_out_proc_mem = proc_mem;
-            break;
+            child++;
         }
-        proc_mem = proc_mem->next;
-    }
-
-    // Iterate over list and find best process memory to swap out.
-    while (proc_mem != NULL)
-    {
-        // Can only swap out processes in memory (not disk).
-        if (!is_process_memory_in_disk(proc_mem))
+        if (!proc_mems_list->eviction_policy->is_evicted_before(heap[child], proc_mem))
         {
-            // Find largest process memory.
-            if (proc_mem->size > swap_out_proc_mem->size)
-            {
-                swap_out_proc_mem = proc_mem;
-            }
-            // If both largest, find process swapped in earlier.
-            else if (proc_mem->size == swap_out_proc_mem->size &&
-                proc_mem->swap_in_time <= swap_out_proc_mem->swap_in_time)
-            {
-                swap_out_proc_mem = proc_mem;
-            }
+            break;
         }
-        proc_mem = proc_mem->next;
+        heap[i] = heap[child];
+        heap[i]->heap_index = i;
+        i = child;
     }
-
-    // Add memory occupied by process back as free memory segment into list2.
-    add_new_free_memory_segment_to_free_memory_segments_list(
-        swap_out_proc_mem->start_address,
-        swap_out_proc_mem->size,
-        mem_segs_list);
-
-    // Update process memory attributes.
-    swap_out_proc_mem->start_address = IN_DISK;
-    swap_out_proc_mem->swap_in_time = 0;
+    heap[i] = proc_mem;
+    proc_mem->heap_index = i;
 
     return;
 }
 
-void swap_out_process_memory_by_process_memory(process_memory_t *proc_mem,
-    free_memory_segments_list_t *mem_segs_list)
+process_memory_t *get_unpinned_process_memory_from_resident_heap(int i,
+    process_memories_list_t *proc_mems_list)
 {
-    // Can only swap out processes in memory (not disk).
-    if (!is_process_memory_in_disk(proc_mem))
+    process_memory_t **heap = proc_mems_list->resident_heap, *proc_mem, *right_proc_mem;
+
+    if (i >= proc_mems_list->resident_heap_len)
     {
-        // Add memory occupied by process back as free memory segment into list.
-        add_new_free_memory_segment_to_free_memory_segments_list(
-            proc_mem->start_address,
-            proc_mem->size,
-            mem_segs_list);
+        return NULL;
+    }
 
-        // Update process memory attributes.
-        proc_mem->start_address = IN_DISK;
-        proc_mem->swap_in_time = 0;
+    /* Ordered before everything below it, so only search below pinned process
+     * memories.
+     */
+    if (!heap[i]->pinned)
+    {
+        return heap[i];
+    }
+    proc_mem = get_unpinned_process_memory_from_resident_heap(2 * i + 1, proc_mems_list);
+    right_proc_mem = get_unpinned_process_memory_from_resident_heap(2 * i + 2, proc_mems_list);
+    if (proc_mem == NULL || (right_proc_mem != NULL &&
+        proc_mems_list->eviction_policy->is_evicted_before(right_proc_mem, proc_mem)))
+    {
+        return right_proc_mem;
     }
 
-    return;
+    return proc_mem;
 }
 
 void print_process_memories_list(process_memories_list_t *proc_mems_list)
@@ -502,6 +1479,13 @@ void print_free_memory_segments_list(free_memory_segments_list_t *mem_segs_list)
 {
     free_memory_segment_t *mem_seg;
 
+    // Print the buddy allocator's free blocks instead, with buddy fit.
+    if (mem_segs_list->buddy != NULL)
+    {
+        print_buddy_allocator(mem_segs_list->buddy);
+        return;
+    }
+
     // Iterate over list and print information.
     mem_seg = mem_segs_list->head;
     printf("{\n");
@@ -521,17 +1505,22 @@ void print_free_memory_segments_list(free_memory_segments_list_t *mem_segs_list)
 
 void free_process_memories_list(process_memories_list_t *proc_mems_list)
 {
-    process_memory_t *curr_proc_mem, *next_proc_mem;
+    process_memory_t *proc_mem;
 
-    // Iterate over list and free each process memory.
-    curr_proc_mem = (proc_mems_list != NULL) ? proc_mems_list->head : NULL;
-    while (curr_proc_mem != NULL)
+    /* Free all process memories at once with their pool, after the page
+     * tables of those left (when a run is stopped before it finishes).
+     */
+    if (proc_mems_list != NULL)
     {
-        next_proc_mem = curr_proc_mem->next;
-        free(curr_proc_mem);
-        curr_proc_mem = next_proc_mem;
+        for (proc_mem = proc_mems_list->head; proc_mem != NULL; proc_mem = proc_mem->next)
+        {
+            free(proc_mem->page_table);
+        }
+        free_object_pool(proc_mems_list->proc_mem_pool);
+        free(proc_mems_list->resident_heap);
+        free(proc_mems_list->index);
+        free_page_frames(proc_mems_list->page_frames);
     }
-
     free(proc_mems_list);
 
     return;
@@ -539,15 +1528,11 @@ void free_process_memories_list(process_memories_list_t *proc_mems_list)
 
 void free_free_memory_segments_list(free_memory_segments_list_t *mem_segs_list)
 {
-    free_memory_segment_t *curr_mem_seg, *next_mem_seg;
-
-    // Iterate over list and free each memory segment.
-    curr_mem_seg = (mem_segs_list != NULL) ? mem_segs_list->head : NULL;
-    while (curr_mem_seg != NULL)
+    // Free all memory segments at once with their pool.
+    if (mem_segs_list != NULL)
     {
-        next_mem_seg = curr_mem_seg->next;
-        free(curr_mem_seg);
-        curr_mem_seg = next_mem_seg;
+        free_object_pool(mem_segs_list->mem_seg_pool);
+        free_buddy_allocator(mem_segs_list->buddy);
     }
 
     free(mem_segs_list);
@@ -555,48 +1540,67 @@ void free_free_memory_segments_list(free_memory_segments_list_t *mem_segs_list)
     return;
 }
 
-int get_process_memories_list_not_in_disk_count(
-    process_memories_list_t *proc_mems_list)
+void get_memory_stats(process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list, memory_stats_t *stats)
 {
-    int count = 0;
+    /* Any free page frame fits a page, so paged memory has no external
+     * fragmentation (and the unused end of last pages is not counted).
+     */
+    if (proc_mems_list->page_frames != NULL)
+    {
+        stats->resident_count = proc_mems_list->resident_count;
+        stats->resident_size = proc_mems_list->resident_size;
+        stats->holes_count = proc_mems_list->page_frames->free_runs;
+        stats->free_size = proc_mems_list->page_frames->free_len *
+            proc_mems_list->page_frames->page_size;
+        stats->largest_hole_size = stats->free_size;
+        stats->internal_size = 0;
+    }
+    else
+    {
+        get_segments_memory_stats(proc_mems_list->resident_count,
+            proc_mems_list->resident_size, mem_segs_list, stats);
+    }
+    return;
+}
 
-    process_memory_t *proc_mem;
+void get_segments_memory_stats(int resident_count, int resident_size,
+    free_memory_segments_list_t *mem_segs_list, memory_stats_t *stats)
+{
+    stats->resident_count = resident_count;
+    stats->resident_size = resident_size;
+    stats->free_size = mem_segs_list->size - resident_size;
+    stats->holes_count = mem_segs_list->count;
 
-    // Iterate over list and count processes that are not in disk.
-    proc_mem = proc_mems_list->head;
-    while (proc_mem != NULL)
+    // Blocks are rounded up to a power of two, with buddy fit.
+    if (mem_segs_list->buddy != NULL)
     {
-        if (!is_process_memory_in_disk(proc_mem))
-        {
-            count++;
-        }
-
-        proc_mem = proc_mem->next;
+        stats->internal_size = mem_segs_list->buddy->allocated_block_size -
+            mem_segs_list->buddy->allocated_size;
+        stats->free_size -= stats->internal_size;
+        stats->largest_hole_size = get_largest_free_buddy_block_size(
+            mem_segs_list->buddy
+            );
+    }
+    else
+    {
+        stats->largest_hole_size = (mem_segs_list->address_root != NULL) ?
+            mem_segs_list->address_root->max_subtree_size : 0;
+        stats->internal_size = 0;
     }
+    return;
+}
 
-    return count;
+int get_process_memories_list_not_in_disk_count(
+    process_memories_list_t *proc_mems_list)
+{
+    return proc_mems_list->resident_count;
 }
 
 int get_process_memories_list_not_in_disk_size(
     process_memories_list_t *proc_mems_list)
 {
-    int size = 0;
-
-    process_memory_t *proc_mem;
-
-    // Iterate over list and sum processes' sizes that are not in disk.
-    proc_mem = proc_mems_list->head;
-    while (proc_mem != NULL)
-    {
-        if (!is_process_memory_in_disk(proc_mem))
-        {
-            size += proc_mem->size;
-        }
-
-        proc_mem = proc_mem->next;
-    }
-
-    return size;
+    return proc_mems_list->resident_size;
 }
 
 /* Test code. *//*
@@ -614,14 +1618,14 @@ int main(int argc, char *argv[])
 
         proc_mems_list = new_process_memories_list();
 
-        pm1 = new_process_memory(20, 1);
-        pm2 = new_process_memory(20, 2);
-        pm3 = new_process_memory(20, 3);
-        pm4 = new_process_memory(30, 4);
-        pm5 = new_process_memory(30, 5);
-        pm6 = new_process_memory(40, 6);
-        pm7 = new_process_memory(60, 7);
-        pm8 = new_process_memory(90, 8);
+        pm1 = new_process_memory(20, 1, proc_mems_list);
+        pm2 = new_process_memory(20, 2, proc_mems_list);
+        pm3 = new_process_memory(20, 3, proc_mems_list);
+        pm4 = new_process_memory(30, 4, proc_mems_list);
+        pm5 = new_process_memory(30, 5, proc_mems_list);
+        pm6 = new_process_memory(40, 6, proc_mems_list);
+        pm7 = new_process_memory(60, 7, proc_mems_list);
+        pm8 = new_process_memory(90, 8, proc_mems_list);
 
         add_process_memory_to_process_memories_list(pm1, proc_mems_list);
         add_process_memory_to_process_memories_list(pm2, proc_mems_list);
@@ -679,14 +1683,14 @@ int main(int argc, char *argv[])
         //remove_process_memory_by_process_id(6, proc_mems_list, mem_segs_list);
         //remove_process_memory_by_process_id(7, proc_mems_list, mem_segs_list);
         //remove_process_memory_by_process_id(8, proc_mems_list, mem_segs_list);
-        swap_out_process_memory_by_process_memory(pm1, mem_segs_list);
-        swap_out_process_memory_by_process_memory(pm2, mem_segs_list);
-        swap_out_process_memory_by_process_memory(pm3, mem_segs_list);
-        swap_out_process_memory_by_process_memory(pm4, mem_segs_list);
-        swap_out_process_memory_by_process_memory(pm5, mem_segs_list);
-        swap_out_process_memory_by_process_memory(pm6, mem_segs_list);
-        swap_out_process_memory_by_process_memory(pm7, mem_segs_list);
-        swap_out_process_memory_by_process_memory(pm8, mem_segs_list);
+        swap_out_process_memory_by_process_memory(pm1, proc_mems_list, mem_segs_list);
+        swap_out_process_memory_by_process_memory(pm2, proc_mems_list, mem_segs_list);
+        swap_out_process_memory_by_process_memory(pm3, proc_mems_list, mem_segs_list);
+        swap_out_process_memory_by_process_memory(pm4, proc_mems_list, mem_segs_list);
+        swap_out_process_memory_by_process_memory(pm5, proc_mems_list, mem_segs_list);
+        swap_out_process_memory_by_process_memory(pm6, proc_mems_list, mem_segs_list);
+        swap_out_process_memory_by_process_memory(pm7, proc_mems_list, mem_segs_list);
+        swap_out_process_memory_by_process_memory(pm8, proc_mems_list, mem_segs_list);
 
         printf("\n======================================================\n");
         print_process_memories_list(proc_mems_list);
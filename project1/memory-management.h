@@ -9,45 +9,189 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Used in start_address when the process memory is in disk.
 #define IN_DISK -1
+// Used in heap_index when the process memory is not in the resident heap.
+#define NOT_IN_HEAP -1
+#define INITIAL_RESIDENT_HEAP_MAX_LEN 4
+#define RESIDENT_HEAP_GROW_FACTOR 2
+// Number of objects allocated at a time by the object pools.
+#define FREE_MEMORY_SEGMENTS_PER_SLAB 256
+#define PROCESS_MEMORIES_PER_SLAB 256
+/* Initial length of the index of process memories by process id, a power of
+ * two, doubled whenever it would become more than half full.
+ */
+#define INITIAL_PROCESS_MEMORIES_INDEX_MAX_LEN 16
+#define PROCESS_MEMORIES_INDEX_GROW_FACTOR 2
+// Multiplier of the (Fibonacci) hash of process ids into the index.
+#define PROCESS_ID_HASH_MULTIPLIER 2654435769u
+// Seed for the pseudo-random priorities of the free memory segment trees.
+#define TREE_PRIORITY_SEED 2463534242u
+// Used in compaction_threshold when main memory is never compacted.
+#define NO_COMPACTION -1
 
 ////////////////////////////////////////////////////////////////////////////////
 // Data structures. ////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
-/* Data structure to hold information of a free memory segment. */
+/* Policies to choose the free memory segment a process memory is swapped into.
+ * First fit takes the highest addressed segment that fits, best fit the
+ * smallest and worst fit the largest (highest addressed if equal). Buddy fit
+ * takes a block from a binary buddy allocator instead of free memory segments.
+ */
+enum fit_policy_t { first_fit, best_fit, worst_fit, buddy_fit };
+
+/* Data structure to hold information of a free memory segment. Besides the
+ * list, free memory segments are indexed by two treaps: one ordered by start
+ * address (tracking the largest size in each subtree), one ordered by size.
+ */
 typedef struct free_memory_segment_t
 {
     struct free_memory_segment_t *next;
+    struct free_memory_segment_t *prev;
     int start_address;
     int size;
+    struct free_memory_segment_t *address_left;
+    struct free_memory_segment_t *address_right;
+    struct free_memory_segment_t *size_left;
+    struct free_memory_segment_t *size_right;
+    unsigned int tree_priority;
+    int max_subtree_size;  // Largest size in its address subtree.
 } free_memory_segment_t;
 
-/* Data structure to hold information of a list of free memory segments. */
+/* Data structure to hold information of a list of free memory segments. The
+ * list is in descending start address order. Free memory segments are
+ * allocated from the list's object pool. With buddy fit, main memory is held
+ * by the buddy allocator instead, and the list is empty.
+ */
 typedef struct free_memory_segments_list_t
 {
     free_memory_segment_t *head;
+    free_memory_segment_t *address_root;
+    free_memory_segment_t *size_root;
+    enum fit_policy_t fit_policy;
+    unsigned int tree_seed;
+    object_pool_t *mem_seg_pool;
+    int count;  // Free memory segments (or blocks, with buddy fit).
+    int size;   // Main memory size.
+    struct buddy_allocator_t *buddy;  // Buddy allocator, NULL if not buddy fit.
+    /* External fragmentation percentage main memory is compacted at, when no
+     * free memory segment fits, and what compaction has moved so far.
+     */
+    int compaction_threshold;
+    int compactions;
+    long compacted_size;
 } free_memory_segments_list_t;
 
 /* Data structure to hold information of a process memory. */
 typedef struct process_memory_t
 {
     struct process_memory_t *next;
+    struct process_memory_t *prev;
     int start_address;
     int size;
     int swap_in_time;
     int process_id;
+    int sequence;    // Position it was added to the process memories list.
+    int heap_index;  // Position in the resident heap.
+    int swap_count;  // Times swapped into main memory.
+    int pinned;      // Skipped by the eviction policy, so not swapped out.
+    // Page table and pages in frames, if paged.
+    int *page_table;
+    int pages;
+    int resident_pages;
+    int next_page;   // Page touched next.
+    // Eviction policy state while in main memory.
+    struct process_memory_t *resident_prev;
+    struct process_memory_t *resident_next;
+    int referenced;
+    double eviction_value;
 } process_memory_t;
 
-/* Data structure to hold information of a list of process memories. */
+/* Data structure to hold an eviction policy, which chooses the process memory
+ * to swap out of main memory. Process memories are added when swapped in,
+ * removed when swapped out, and accessed when loaded while in main memory.
+ * Pinned process memories stay added, in their place, but are never chosen.
+ */
+struct process_memories_list_t;
+typedef struct eviction_policy_t
+{
+    char *name;
+    void (*add)(process_memory_t *proc_mem,
+        struct process_memories_list_t *proc_mems_list);
+    void (*remove)(process_memory_t *proc_mem,
+        struct process_memories_list_t *proc_mems_list);
+    void (*access)(process_memory_t *proc_mem,
+        struct process_memories_list_t *proc_mems_list);
+    process_memory_t *(*get_victim)(
+        struct process_memories_list_t *proc_mems_list);
+    // Resident heap order, if the policy uses the resident heap.
+    int (*is_evicted_before)(process_memory_t *proc_mem,
+        process_memory_t *other_proc_mem);
+} eviction_policy_t;
+
+/* Data structure to hold information of a list of process memories, doubly
+ * linked in the order they were added, and indexed by process id in an open
+ * addressing (linear probing) hash table. Process memories in main memory are
+ * also kept, depending on the eviction policy, in a binary heap in the order
+ * they would be swapped out, or in a doubly linked resident list. Process
+ * memories are allocated from the list's object pool.
+ */
 typedef struct process_memories_list_t
 {
     process_memory_t *head;
+    process_memory_t *tail;
+    process_memory_t **index;  // By process id, NULL where empty.
+    int index_len;
+    int index_max_len;
+    int next_sequence;
+    const eviction_policy_t *eviction_policy;
+    process_memory_t **resident_heap;
+    int resident_heap_len;
+    int resident_heap_max_len;
+    process_memory_t *resident_head;
+    process_memory_t *resident_tail;
+    process_memory_t *clock_hand;
+    double eviction_inflation;
+    object_pool_t *proc_mem_pool;
+    // Process memories in main memory (not disk), kept as they are swapped.
+    int resident_count;
+    int resident_size;
+    event_log_t *event_log;  // Where swaps are logged, NULL for nowhere.
+    int pinned_count;
+    // Main memory page frames if paged, NULL for contiguous memory segments.
+    struct page_frames_t *page_frames;
 } process_memories_list_t;
 
+/* Data structure to hold a snapshot of main memory use. */
+typedef struct memory_stats_t
+{
+    int resident_count;  // Process memories in main memory.
+    int resident_size;   // Total size of process memories in main memory.
+    int holes_count;     // Free memory segments (or runs of page frames).
+    int free_size;       // Total size of free memory.
+    int largest_hole_size;  // Size of the largest free memory segment.
+    int internal_size;   // Size allocated to but unused by process memories.
+} memory_stats_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Function prototypes. ////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 /* Allocate memory for and initialise a new free memory segments list. */
 free_memory_segments_list_t *new_free_memory_segments_list(int size);
+/* Set the policy used to choose a free memory segment to swap into. Must be
+ * set while all of main memory is free.
+ */
+void set_free_memory_segments_list_fit_policy(
+    free_memory_segments_list_t *mem_segs_list, enum fit_policy_t fit_policy);
+/* Set the external fragmentation percentage at or above which main memory is
+ * compacted, rather than a process memory swapped out, when no free memory
+ * segment fits. NO_COMPACTION for never.
+ */
+void set_free_memory_segments_list_compaction_threshold(
+    free_memory_segments_list_t *mem_segs_list, int compaction_threshold);
+/* Allocate memory for and initialise a new free memory segment, not yet in the
+ * free memory segments list.
+ */
+free_memory_segment_t *new_free_memory_segment(int start_address, int size,
+    free_memory_segments_list_t *mem_segs_list);
 /* Allocate memory for and initialise a new free memory segment and add it, in
  * proper order, to the free memory segments list.
  */
@@ -63,13 +207,114 @@ void consolidate_free_memory_segments_list(
 /* Get the count of free memory segments in the free memory segments list. */
 int get_free_memory_segments_list_count(
     free_memory_segments_list_t *mem_segs_list);
+/* Insert a free memory segment into the free memory segments list and its
+ * trees, without consolidating.
+ */
+void insert_free_memory_segment(free_memory_segment_t *mem_seg,
+    free_memory_segments_list_t *mem_segs_list);
+/* Remove a free memory segment from the free memory segments list and its
+ * trees, without freeing it.
+ */
+void remove_free_memory_segment(free_memory_segment_t *mem_seg,
+    free_memory_segments_list_t *mem_segs_list);
+/* Get the free memory segment with the lowest start address above, or the
+ * highest start address below, an address.
+ */
+free_memory_segment_t *get_free_memory_segment_above(int address,
+    free_memory_segments_list_t *mem_segs_list);
+free_memory_segment_t *get_free_memory_segment_below(int address,
+    free_memory_segments_list_t *mem_segs_list);
+/* Take the free memory a process memory of a size is swapped into off the free
+ * memory segments list, chosen by the list's fit policy. Returns the start
+ * address of the process memory, or IN_DISK if none fit.
+ */
+int take_fitting_free_memory(int size,
+    free_memory_segments_list_t *mem_segs_list);
+/* Get the free memory segment to swap a process memory of a size into, chosen
+ * by the list's fit policy, or NULL if none fit.
+ */
+free_memory_segment_t *get_fitting_free_memory_segment(int size,
+    free_memory_segments_list_t *mem_segs_list);
+/* Get the highest addressed free memory segment of at least a size. */
+free_memory_segment_t *get_highest_free_memory_segment_of_size(int size,
+    free_memory_segments_list_t *mem_segs_list);
+/* Recalculate the largest size in a free memory segment's address subtree. */
+void update_free_memory_segment_max_subtree_size(free_memory_segment_t *mem_seg);
+/* Check if a free memory segment is ordered before another in the size tree,
+ * by size then descending start address.
+ */
+int is_free_memory_segment_before_by_size(free_memory_segment_t *mem_seg,
+    free_memory_segment_t *other_mem_seg);
+/* Insert into or remove from a free memory segments address tree, returning its
+ * new root.
+ */
+free_memory_segment_t *insert_into_free_memory_segments_address_tree(
+    free_memory_segment_t *mem_seg, free_memory_segment_t *root);
+free_memory_segment_t *remove_from_free_memory_segments_address_tree(
+    free_memory_segment_t *mem_seg, free_memory_segment_t *root);
+/* Split a free memory segments address tree into segments below and at or
+ * above a start address, or merge two such trees back.
+ */
+void split_free_memory_segments_address_tree(free_memory_segment_t *root,
+    int start_address, free_memory_segment_t **lower,
+    free_memory_segment_t **upper);
+free_memory_segment_t *merge_free_memory_segments_address_trees(
+    free_memory_segment_t *lower, free_memory_segment_t *upper);
+/* Insert into or remove from a free memory segments size tree, returning its
+ * new root.
+ */
+free_memory_segment_t *insert_into_free_memory_segments_size_tree(
+    free_memory_segment_t *mem_seg, free_memory_segment_t *root);
+free_memory_segment_t *remove_from_free_memory_segments_size_tree(
+    free_memory_segment_t *mem_seg, free_memory_segment_t *root);
+/* Split a free memory segments size tree into segments ordered before and from
+ * a key free memory segment, or merge two such trees back.
+ */
+void split_free_memory_segments_size_tree(free_memory_segment_t *root,
+    free_memory_segment_t *key_mem_seg, free_memory_segment_t **lower,
+    free_memory_segment_t **upper);
+free_memory_segment_t *merge_free_memory_segments_size_trees(
+    free_memory_segment_t *lower, free_memory_segment_t *upper);
 /* Allocate memory for and initialise a new process memories list. */
 process_memories_list_t *new_process_memories_list();
+/* Set the policy used to choose a process memory to swap out. Must be set while
+ * no process memory is in main memory.
+ */
+void set_process_memories_list_eviction_policy(
+    process_memories_list_t *proc_mems_list,
+    const eviction_policy_t *eviction_policy);
+/* Set the event log swaps are logged to, NULL for none. */
+void set_process_memories_list_event_log(
+    process_memories_list_t *proc_mems_list, event_log_t *event_log);
 /* Allocate memory for and initialise a new process memory. */
-process_memory_t *new_process_memory(int size, int process_id);
-/* Append a process memory to the end of the process memories list. */
+process_memory_t *new_process_memory(int size, int process_id,
+    process_memories_list_t *proc_mems_list);
+/* Number a process memory and append it to the end of the process memories
+ * list.
+ */
 void add_process_memory_to_process_memories_list(process_memory_t *new_proc_mem,
     process_memories_list_t *proc_mems_list);
+/* Append an already numbered process memory to the end of the process
+ * memories list and its index.
+ */
+void append_process_memory_to_process_memories_list(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+/* Add a process memory to, or remove it from, the index of process memories
+ * by process id. A removed process memory's entry is filled by later entries
+ * of its probe sequence, so the index never holds deleted entries.
+ */
+void add_process_memory_to_process_memories_index(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void remove_process_memory_from_process_memories_index(
+    process_memory_t *proc_mem, process_memories_list_t *proc_mems_list);
+/* Grow the index of process memories by process id, re-adding them in list
+ * order.
+ */
+void grow_process_memories_index(process_memories_list_t *proc_mems_list);
+/* Get the position of a process id's probe sequence in the index of process
+ * memories to start at.
+ */
+int get_process_id_hash(int process_id, process_memories_list_t *proc_mems_list);
 /* Allocate memory for and initialise a new process memory and append it to the
  * end of the process memories list.
  */
@@ -81,27 +326,86 @@ int get_process_memory_end_address(process_memory_t *proc_mem);
  * name because it would be even confusing for is_proc_mem_in_mem().
  */
 int is_process_memory_in_disk(process_memory_t *proc_mem);
+/* Remove a process memory from the process memories list, release its
+ * occupied memory segment and free it.
+ */
+void remove_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list);
 /* Remove a process memory from the process memories list and releases occupied
  * free memory segment.
  */
 int remove_process_memory_by_process_id(int process_id,
     process_memories_list_t *proc_mems_list,
     free_memory_segments_list_t *mem_segs_list);
-/* Get the process memory from the process memories list by process id. */
+/* Get the process memory from the process memories list by process id, the
+ * first added if there are several.
+ */
 process_memory_t *get_process_memory_by_process_id(int process_id,
     process_memories_list_t *proc_mems_list);
-/* Swaps in a process memory into a free memory segment, occupying it. */
-void swap_in_process_memory(process_memory_t *proc_mem, int time,
+/* Swaps in a process memory into a free memory segment, occupying it, and
+ * compacting main memory rather than swapping out if it is fragmented enough.
+ * Returns 0 if it cannot fit until pinned process memories are unpinned.
+ */
+int swap_in_process_memory(process_memory_t *proc_mem, int time,
     process_memories_list_t *proc_mems_list,
     free_memory_segments_list_t *mem_segs_list);
-/* Swaps out the largest (and if equal largest, longest in memory) process
- * memory and releases occupied free memory segment.
+/* Pin a process memory in main memory, so it is not swapped out (while its
+ * process runs on a CPU), or unpin it, accessing it as just used. It keeps its
+ * place in the eviction policy's order either way.
+ */
+void pin_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void unpin_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+/* Tell the eviction policy a process memory in main memory is being used. */
+void access_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+/* Swaps out the process memory chosen by the eviction policy (by default the
+ * largest, and if equal largest, longest in memory) and releases occupied free
+ * memory segment.
  */
 void swap_out_process_memory(process_memories_list_t *proc_mems_list,
     free_memory_segments_list_t *mem_segs_list);
 /* Swaps out the process memory and releases occupied free memory segment. */
 void swap_out_process_memory_by_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list);
+/* Check if main memory should be compacted to fit a process memory of a size
+ * that no free memory segment fits: there is enough free memory in total, and
+ * external fragmentation is at least the compaction threshold.
+ */
+int is_compaction_needed(int size, process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list);
+/* Compact main memory, sliding process memories towards the high addresses
+ * in one sweep down, leaving one free memory segment at the bottom.
+ */
+void compact_main_memory(process_memories_list_t *proc_mems_list,
     free_memory_segments_list_t *mem_segs_list);
+/* Compare process memories for qsort, by descending start address. */
+int compare_process_memories_by_start_address(const void *a, const void *b);
+/* Check if a process memory is swapped out before another: larger first, then
+ * swapped in earlier, then later in the process memories list.
+ */
+int is_process_memory_swapped_out_before(process_memory_t *proc_mem,
+    process_memory_t *other_proc_mem);
+/* Add a process memory to, or remove it from, the resident heap, ordered by
+ * the eviction policy.
+ */
+void add_process_memory_to_resident_heap(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+void remove_process_memory_from_resident_heap(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+/* Restore the resident heap order by moving the process memory at an index up
+ * or down.
+ */
+void sift_up_resident_heap(int i, process_memories_list_t *proc_mems_list);
+void sift_down_resident_heap(int i, process_memories_list_t *proc_mems_list);
+/* Get the process memory first swapped out of the resident heap, below and
+ * including an index, that is not pinned, or NULL if all are.
+ */
+process_memory_t *get_unpinned_process_memory_from_resident_heap(int i,
+    process_memories_list_t *proc_mems_list);
 /* Print information about the process memories list. */
 void print_process_memories_list(process_memories_list_t *proc_mems_list);
 /* Print information about the free memory segments list. */
@@ -110,6 +414,16 @@ void print_free_memory_segments_list(free_memory_segments_list_t *mem_segs_list)
 void free_process_memories_list(process_memories_list_t *proc_mems_list);
 /* Free all memory allocated for free memory segments list. */
 void free_free_memory_segments_list(free_memory_segments_list_t *mem_segs_list);
+/* Get a snapshot of main memory use, in constant time (logarithmic in the
+ * main memory size with buddy fit).
+ */
+void get_memory_stats(process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list, memory_stats_t *stats);
+/* Get a snapshot of main memory use by process memories of a count and total
+ * size, held in free memory segments (or buddy blocks) rather than page frames.
+ */
+void get_segments_memory_stats(int resident_count, int resident_size,
+    free_memory_segments_list_t *mem_segs_list, memory_stats_t *stats);
 /* Get the count of process memories that is not in disk in the process memories
  * list.
  */
@@ -0,0 +1,117 @@
+/*
+ * object-pool.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include "object-pool.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+object_pool_t *new_object_pool(size_t object_size, int objects_per_slab)
+{
+    object_pool_t *pool;
+
+    // Allocate memory for pool and error check.
+    pool = (object_pool_t*)malloc(sizeof(object_pool_t));
+    if (pool == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Released objects must be able to hold the free list link.
+    if (object_size < sizeof(object_pool_free_object_t))
+    {
+        object_size = sizeof(object_pool_free_object_t);
+    }
+
+    // Set pool.
+    pool->object_size = (object_size + OBJECT_POOL_ALIGNMENT - 1) /
+        OBJECT_POOL_ALIGNMENT * OBJECT_POOL_ALIGNMENT;
+    pool->objects_per_slab = (objects_per_slab > 0) ?
+        objects_per_slab : DEFAULT_OBJECTS_PER_SLAB;
+    pool->slabs = NULL;
+    pool->slab_next = NULL;
+    pool->slab_end = NULL;
+    pool->free_objects = NULL;
+
+    return pool;
+}
+
+void *allocate_from_object_pool(object_pool_t *pool)
+{
+    object_pool_slab_t *slab;
+    void *object;
+
+    // Reuse the most recently released object.
+    if (pool->free_objects != NULL)
+    {
+        object = pool->free_objects;
+        pool->free_objects = pool->free_objects->next;
+        return object;
+    }
+
+    // Newest slab is used up, allocate another and error check.
+    if (pool->slab_next == pool->slab_end)
+    {
+        slab = (object_pool_slab_t*)malloc(
+            OBJECT_POOL_ALIGNMENT + pool->object_size * pool->objects_per_slab
+            );
+        if (slab == NULL)
+        {
+            perror("malloc");
+            exit(1);
+        }
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+
+        // Objects start after the (aligned) slab header.
+        pool->slab_next = (char*)slab + OBJECT_POOL_ALIGNMENT;
+        pool->slab_end = pool->slab_next + pool->object_size * pool->objects_per_slab;
+    }
+
+    object = pool->slab_next;
+    pool->slab_next += pool->object_size;
+
+    return object;
+}
+
+void release_to_object_pool(void *object, object_pool_t *pool)
+{
+    object_pool_free_object_t *free_object = (object_pool_free_object_t*)object;
+
+    if (object == NULL)
+    {
+        return;
+    }
+
+    free_object->next = pool->free_objects;
+    pool->free_objects = free_object;
+
+    return;
+}
+
+void free_object_pool(object_pool_t *pool)
+{
+    object_pool_slab_t *curr_slab, *next_slab;
+
+    // Iterate over slabs and free each.
+    curr_slab = (pool != NULL) ? pool->slabs : NULL;
+    while (curr_slab != NULL)
+    {
+        next_slab = curr_slab->next;
+        free(curr_slab);
+        curr_slab = next_slab;
+    }
+
+    free(pool);
+
+    return;
+}
@@ -0,0 +1,55 @@
+/*
+ * object-pool.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Alignment of objects, enough for any of the pooled data structures.
+#define OBJECT_POOL_ALIGNMENT 16
+#define DEFAULT_OBJECTS_PER_SLAB 256
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Data structure to hold a slab, a contiguous block of objects following its
+ * header.
+ */
+typedef struct object_pool_slab_t
+{
+    struct object_pool_slab_t *next;
+} object_pool_slab_t;
+
+/* Data structure to hold a released object, linked through its own memory. */
+typedef struct object_pool_free_object_t
+{
+    struct object_pool_free_object_t *next;
+} object_pool_free_object_t;
+
+/* Data structure to hold an object pool, which hands out objects of a single
+ * size from slabs. Released objects are reused before new slabs are allocated,
+ * and all slabs are freed at once when the pool is.
+ */
+typedef struct object_pool_t
+{
+    size_t object_size;  // Rounded up to the alignment.
+    int objects_per_slab;
+    object_pool_slab_t *slabs;
+    char *slab_next;  // Next never used object of the newest slab.
+    char *slab_end;
+    object_pool_free_object_t *free_objects;
+} object_pool_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Allocate memory for and initialise a new object pool. */
+object_pool_t *new_object_pool(size_t object_size, int objects_per_slab);
+/* Allocate an object from the pool, allocating a new slab if necessary. */
+void *allocate_from_object_pool(object_pool_t *pool);
+/* Release an object back to the pool for reuse. */
+void release_to_object_pool(void *object, object_pool_t *pool);
+/* Free the pool and all objects allocated from it. */
+void free_object_pool(object_pool_t *pool);
@@ -0,0 +1,389 @@
+/*
+ * paged-memory.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include "object-pool.h"
+#include "event-log.h"
+#include "memory-management.h"
+#include "paged-memory.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+page_frames_t *new_page_frames(int size, int page_size)
+{
+    page_frames_t *page_frames;
+    int i;
+
+    if (page_size < 1 || size / page_size < 1)
+    {
+        fprintf(stderr, "Page size larger than main memory\n");
+        exit(1);
+    }
+
+    // Allocate memory for page frames and error check.
+    page_frames = (page_frames_t*)malloc(sizeof(page_frames_t));
+    if (page_frames == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    page_frames->page_size = page_size;
+    page_frames->len = size / page_size;
+    page_frames->owners = (process_memory_t**)malloc(sizeof(process_memory_t*) * page_frames->len);
+    page_frames->pages = (int*)malloc(sizeof(int) * page_frames->len);
+    page_frames->referenced = (char*)malloc(sizeof(char) * page_frames->len);
+    page_frames->free_frames = (int*)malloc(sizeof(int) * page_frames->len);
+    if (page_frames->owners == NULL || page_frames->pages == NULL ||
+        page_frames->referenced == NULL || page_frames->free_frames == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set page frames, all free and the lowest taken first.
+    for (i = 0; i < page_frames->len; i++)
+    {
+        page_frames->owners[i] = NULL;
+        page_frames->pages[i] = 0;
+        page_frames->referenced[i] = 0;
+        page_frames->free_frames[i] = page_frames->len - 1 - i;
+    }
+    page_frames->free_len = page_frames->len;
+    page_frames->free_runs = 1;
+    page_frames->clock_hand = 0;
+    page_frames->page_faults = 0;
+    page_frames->page_outs = 0;
+
+    return page_frames;
+}
+
+void set_process_memories_list_page_frames(
+    process_memories_list_t *proc_mems_list, page_frames_t *page_frames)
+{
+    proc_mems_list->page_frames = page_frames;
+    return;
+}
+
+int get_process_memory_pages(process_memory_t *proc_mem,
+    page_frames_t *page_frames)
+{
+    int pages = (proc_mem->size + page_frames->page_size - 1) / page_frames->page_size;
+    return (pages < 1) ? 1 : pages;
+}
+
+void swap_in_paged_process_memory(process_memory_t *proc_mem, int time,
+    process_memories_list_t *proc_mems_list)
+{
+    int i;
+
+    // Allocate page table on first swap in, with no page in a frame.
+    if (proc_mem->page_table == NULL)
+    {
+        proc_mem->pages = get_process_memory_pages(
+            proc_mem, proc_mems_list->page_frames
+            );
+        proc_mem->page_table = (int*)malloc(sizeof(int) * proc_mem->pages);
+        if (proc_mem->page_table == NULL)
+        {
+            perror("malloc");
+            exit(1);
+        }
+        for (i = 0; i < proc_mem->pages; i++)
+        {
+            proc_mem->page_table[i] = NO_FRAME;
+        }
+    }
+
+    // Only the page touched first is needed to start running.
+    proc_mem->swap_in_time = time;
+    if (proc_mem->page_table[proc_mem->next_page] == NO_FRAME)
+    {
+        swap_in_page(proc_mem, proc_mem->next_page, proc_mems_list);
+    }
+
+    return;
+}
+
+void swap_out_paged_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list)
+{
+    int i;
+
+    for (i = 0; i < proc_mem->pages && proc_mem->resident_pages > 0; i++)
+    {
+        if (proc_mem->page_table[i] != NO_FRAME)
+        {
+            swap_out_page(proc_mem->page_table[i], proc_mems_list);
+        }
+    }
+    proc_mem->swap_in_time = 0;
+
+    return;
+}
+
+void swap_out_page_by_clock(process_memories_list_t *proc_mems_list)
+{
+    page_frames_t *page_frames = proc_mems_list->page_frames;
+    int victim;
+
+    // Give frames touched since the hand last passed a second chance.
+    while (page_frames->referenced[page_frames->clock_hand])
+    {
+        page_frames->referenced[page_frames->clock_hand] = 0;
+        page_frames->clock_hand = (page_frames->clock_hand + 1) % page_frames->len;
+    }
+    victim = page_frames->clock_hand;
+    page_frames->clock_hand = (page_frames->clock_hand + 1) % page_frames->len;
+
+    page_frames->page_outs++;
+    swap_out_page(victim, proc_mems_list);
+
+    return;
+}
+
+void swap_in_page(process_memory_t *proc_mem, int page,
+    process_memories_list_t *proc_mems_list)
+{
+    page_frames_t *page_frames = proc_mems_list->page_frames;
+    int frame;
+
+    // Make a frame free first if none are.
+    if (page_frames->free_len == 0)
+    {
+        swap_out_page_by_clock(proc_mems_list);
+    }
+    frame = take_free_frame(page_frames);
+
+    // Occupy frame.
+    page_frames->owners[frame] = proc_mem;
+    page_frames->pages[frame] = page;
+    page_frames->referenced[frame] = 1;
+    page_frames->page_faults++;
+    proc_mem->page_table[page] = frame;
+    proc_mem->swap_count++;
+
+    // In main memory from its first page in a frame, addressed by that frame.
+    if (proc_mem->resident_pages == 0)
+    {
+        proc_mem->start_address = frame * page_frames->page_size;
+        proc_mems_list->resident_count++;
+    }
+    proc_mem->resident_pages++;
+    proc_mems_list->resident_size += page_frames->page_size;
+
+    log_simulation_event(proc_mems_list->event_log, swap_in_event,
+        proc_mem->process_id, frame * page_frames->page_size,
+        page_frames->page_size);
+    log_holes_count(proc_mems_list->event_log, page_frames->free_runs);
+
+    return;
+}
+
+void swap_out_page(int frame, process_memories_list_t *proc_mems_list)
+{
+    page_frames_t *page_frames = proc_mems_list->page_frames;
+    process_memory_t *proc_mem = page_frames->owners[frame];
+
+    // Release frame.
+    proc_mem->page_table[page_frames->pages[frame]] = NO_FRAME;
+    page_frames->owners[frame] = NULL;
+    page_frames->referenced[frame] = 0;
+    put_free_frame(frame, page_frames);
+
+    // In disk once its last page is out of a frame.
+    proc_mem->resident_pages--;
+    proc_mems_list->resident_size -= page_frames->page_size;
+    if (proc_mem->resident_pages == 0)
+    {
+        proc_mem->start_address = IN_DISK;
+        proc_mems_list->resident_count--;
+    }
+
+    log_simulation_event(proc_mems_list->event_log, swap_out_event,
+        proc_mem->process_id, frame * page_frames->page_size,
+        page_frames->page_size);
+    log_holes_count(proc_mems_list->event_log, page_frames->free_runs);
+
+    return;
+}
+
+int take_free_frame(page_frames_t *page_frames)
+{
+    int frame = page_frames->free_frames[--page_frames->free_len];
+    int below = is_frame_free(frame - 1, page_frames);
+    int above = is_frame_free(frame + 1, page_frames);
+
+    /* Taking a frame splits its run of free frames in two, shrinks it, or if
+     * it was the only free frame in the run removes it.
+     */
+    page_frames->free_runs += (below && above) - (!below && !above);
+
+    return frame;
+}
+
+void put_free_frame(int frame, page_frames_t *page_frames)
+{
+    int below = is_frame_free(frame - 1, page_frames);
+    int above = is_frame_free(frame + 1, page_frames);
+
+    /* Freeing a frame merges the runs of free frames either side, grows one,
+     * or if neither side is free starts a new one.
+     */
+    page_frames->free_runs += (!below && !above) - (below && above);
+    page_frames->free_frames[page_frames->free_len++] = frame;
+
+    return;
+}
+
+int is_frame_free(int frame, page_frames_t *page_frames)
+{
+    return (frame >= 0 && frame < page_frames->len && page_frames->owners[frame] == NULL);
+}
+
+void touch_process_memory_page(process_memory_t *proc_mem, tlb_t *tlb,
+    process_memories_list_t *proc_mems_list)
+{
+    int page = proc_mem->next_page;
+    int frame;
+
+    proc_mem->next_page = (page + 1) % proc_mem->pages;
+
+    // On a tlb miss walk the page table, swapping in the page on a fault.
+    frame = look_up_tlb(tlb, proc_mem, page);
+    if (frame == NO_FRAME)
+    {
+        if (proc_mem->page_table[page] == NO_FRAME)
+        {
+            swap_in_page(proc_mem, page, proc_mems_list);
+        }
+        add_to_tlb(tlb, proc_mem, page);
+        frame = proc_mem->page_table[page];
+    }
+    proc_mems_list->page_frames->referenced[frame] = 1;
+
+    return;
+}
+
+tlb_t *new_tlb(int entries, int ways)
+{
+    tlb_t *tlb;
+    int i;
+
+    // Allocate memory for tlb and error check.
+    tlb = (tlb_t*)malloc(sizeof(tlb_t));
+    if (tlb == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    tlb->entries = (tlb_entry_t*)malloc(sizeof(tlb_entry_t) * entries);
+    if (tlb->entries == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set tlb, every entry empty.
+    tlb->ways = ways;
+    tlb->sets = entries / ways;
+    for (i = 0; i < entries; i++)
+    {
+        tlb->entries[i].process_id = 0;
+        tlb->entries[i].page = 0;
+        tlb->entries[i].frame = NO_FRAME;
+        tlb->entries[i].last_used = 0;
+    }
+    tlb->clock = 0;
+    tlb->hits = 0;
+    tlb->misses = 0;
+
+    return tlb;
+}
+
+int look_up_tlb(tlb_t *tlb, process_memory_t *proc_mem, int page)
+{
+    tlb_entry_t *set;
+    int i;
+
+    set = &tlb->entries[((unsigned int)page + (unsigned int)proc_mem->process_id * 31u) % tlb->sets * tlb->ways];
+    for (i = 0; i < tlb->ways; i++)
+    {
+        // Hit only if the page is still in the frame it was cached with.
+        if (set[i].frame != NO_FRAME && set[i].process_id == proc_mem->process_id &&
+            set[i].page == page && proc_mem->page_table[page] == set[i].frame)
+        {
+            set[i].last_used = ++tlb->clock;
+            tlb->hits++;
+            return set[i].frame;
+        }
+    }
+    tlb->misses++;
+
+    return NO_FRAME;
+}
+
+void add_to_tlb(tlb_t *tlb, process_memory_t *proc_mem, int page)
+{
+    tlb_entry_t *set, *entry;
+    int i;
+
+    set = &tlb->entries[((unsigned int)page + (unsigned int)proc_mem->process_id * 31u) % tlb->sets * tlb->ways];
+
+    /* Replace a stale entry of the same page, otherwise an empty one,
+     * otherwise the least recently used one.
+     */
+    entry = &set[0];
+    for (i = 0; i < tlb->ways; i++)
+    {
+        if (set[i].frame != NO_FRAME && set[i].process_id == proc_mem->process_id &&
+            set[i].page == page)
+        {
+            entry = &set[i];
+            break;
+        }
+        if (entry->frame != NO_FRAME &&
+            (set[i].frame == NO_FRAME || set[i].last_used < entry->last_used))
+        {
+            entry = &set[i];
+        }
+    }
+    entry->process_id = proc_mem->process_id;
+    entry->page = page;
+    entry->frame = proc_mem->page_table[page];
+    entry->last_used = ++tlb->clock;
+
+    return;
+}
+
+void free_tlb(tlb_t *tlb)
+{
+    if (tlb != NULL)
+    {
+        free(tlb->entries);
+    }
+    free(tlb);
+
+    return;
+}
+
+void free_page_frames(page_frames_t *page_frames)
+{
+    if (page_frames != NULL)
+    {
+        free(page_frames->owners);
+        free(page_frames->pages);
+        free(page_frames->referenced);
+        free(page_frames->free_frames);
+    }
+    free(page_frames);
+
+    return;
+}
@@ -0,0 +1,114 @@
+/*
+ * paged-memory.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Used in page tables and tlb entries when a page is not in a page frame.
+#define NO_FRAME -1
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Data structure to hold main memory divided into page frames, when process
+ * memories are paged rather than in contiguous memory segments. Each frame
+ * holds one page of a process memory, and frames are replaced by the clock
+ * (second chance) algorithm once none are free.
+ */
+typedef struct page_frames_t
+{
+    int              page_size;
+    int              len;           // Number of frames.
+    process_memory_t **owners;      // Process memory of each frame's page.
+    int              *pages;        // Page number held in each frame.
+    char             *referenced;   // Touched since the clock hand passed.
+    int              clock_hand;
+    int              *free_frames;  // Stack of free frames, lowest on top.
+    int              free_len;
+    int              free_runs;     // Runs of contiguous free frames.
+    long             page_faults;
+    long             page_outs;
+} page_frames_t;
+
+/* Data structure to hold an entry of a tlb. */
+typedef struct tlb_entry_t
+{
+    int          process_id;
+    int          page;
+    int          frame;
+    unsigned int last_used;
+} tlb_entry_t;
+
+/* Data structure to hold a set associative tlb (translation lookaside buffer)
+ * of a CPU, caching page to frame translations by process, least recently used
+ * entry of a set replaced first. Entries are checked against the page table on
+ * a hit, so pages replaced by other CPUs need no shootdown.
+ */
+typedef struct tlb_t
+{
+    int          sets;
+    int          ways;
+    tlb_entry_t  *entries;  // Each set's ways are next to each other.
+    unsigned int clock;
+    long         hits;
+    long         misses;
+} tlb_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Allocate memory for and initialise main memory of a size divided into page
+ * frames of a page size, all free.
+ */
+page_frames_t *new_page_frames(int size, int page_size);
+/* Page the process memories of the list into page frames, rather than
+ * contiguous memory segments, which are then freed with the list. Must be set
+ * while no process memory is in main memory.
+ */
+void set_process_memories_list_page_frames(
+    process_memories_list_t *proc_mems_list, page_frames_t *page_frames);
+/* Get the number of pages of a process memory, which is at least one. */
+int get_process_memory_pages(process_memory_t *proc_mem,
+    page_frames_t *page_frames);
+/* Swap in a paged process memory on demand: only the page it touches next. */
+void swap_in_paged_process_memory(process_memory_t *proc_mem, int time,
+    process_memories_list_t *proc_mems_list);
+/* Swap out every page of a paged process memory. */
+void swap_out_paged_process_memory(process_memory_t *proc_mem,
+    process_memories_list_t *proc_mems_list);
+/* Swap out the page in the frame chosen by the clock algorithm. */
+void swap_out_page_by_clock(process_memories_list_t *proc_mems_list);
+/* Swap a page of a process memory into a (free, if need be made so) frame. */
+void swap_in_page(process_memory_t *proc_mem, int page,
+    process_memories_list_t *proc_mems_list);
+/* Swap out the page in a frame, freeing the frame. */
+void swap_out_page(int frame, process_memories_list_t *proc_mems_list);
+/* Take a free frame off, or put a freed frame back on, the free frames. */
+int take_free_frame(page_frames_t *page_frames);
+void put_free_frame(int frame, page_frames_t *page_frames);
+/* Check if a frame is in main memory and free. */
+int is_frame_free(int frame, page_frames_t *page_frames);
+/* Touch the page a process memory touches next, through a CPU's tlb, and swap
+ * it in on a page fault. Pages are touched one per time step, in order and
+ * wrapping around.
+ */
+void touch_process_memory_page(process_memory_t *proc_mem, tlb_t *tlb,
+    process_memories_list_t *proc_mems_list);
+/* Allocate memory for and initialise a new empty tlb of a number of entries in
+ * sets of a number of ways.
+ */
+tlb_t *new_tlb(int entries, int ways);
+/* Look up the frame of a page of a process memory in a tlb, counting a hit or
+ * miss. Returns NO_FRAME on a miss.
+ */
+int look_up_tlb(tlb_t *tlb, process_memory_t *proc_mem, int page);
+/* Add the translation of a page of a process memory to a tlb, replacing the
+ * least recently used entry of its set.
+ */
+void add_to_tlb(tlb_t *tlb, process_memory_t *proc_mem, int page);
+/* Free all memory allocated for a tlb or page frames. */
+void free_tlb(tlb_t *tlb);
+void free_page_frames(page_frames_t *page_frames);
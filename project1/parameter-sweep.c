@@ -0,0 +1,312 @@
+/*
+ * parameter-sweep.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "object-pool.h"
+#include "event-log.h"
+#include "memory-management.h"
+#include "eviction-policy.h"
+#include "process-data-file-parser.h"
+#include "scheduled-process-source.h"
+#include "process-metrics.h"
+#include "process-scheduler.h"
+#include "scheduling-policy.h"
+#include "parameter-sweep.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+parameter_sweep_t *new_parameter_sweep(scheduled_processes_table_t *sps,
+    char algorithms[], char memsizes[], char quanta[], char fit_policies[],
+    char eviction_policies[], scheduler_options_t *options)
+{
+    parameter_sweep_t *sweep;
+    char **algs, **mems, **qs, **fits, **evicts;
+    int a, m, q, f, e, len[5] = { 0, 0, 0, 0, 0 }, i;
+    sweep_run_t *run;
+
+    // Allocate memory for parameter sweep and error check.
+    sweep = (parameter_sweep_t*)malloc(sizeof(parameter_sweep_t));
+    if (sweep == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Split arguments into values.
+    algs = split_sweep_values(
+        (algorithms != NULL) ? algorithms : SWEEP_DEFAULT_ALGORITHMS,
+        SWEEP_VALUE_DELIMITER);
+    mems = split_sweep_values(
+        (memsizes != NULL) ? memsizes : "", SWEEP_VALUE_DELIMITER);
+    qs = split_sweep_values(
+        (quanta != NULL) ? quanta : SWEEP_DEFAULT_QUANTA,
+        SWEEP_QUANTA_DELIMITER);
+    fits = split_sweep_values(
+        (fit_policies != NULL) ? fit_policies : SWEEP_DEFAULT_FITS,
+        SWEEP_VALUE_DELIMITER);
+    evicts = split_sweep_values(
+        (eviction_policies != NULL) ? eviction_policies : SWEEP_DEFAULT_EVICTIONS,
+        SWEEP_VALUE_DELIMITER);
+    sweep->values[0] = algs;
+    sweep->values[1] = mems;
+    sweep->values[2] = qs;
+    sweep->values[3] = fits;
+    sweep->values[4] = evicts;
+    for (i = 0; i < 5; i++)
+    {
+        while (sweep->values[i][len[i]] != NULL)
+        {
+            len[i]++;
+        }
+        if (len[i] == 0)
+        {
+            fprintf(stderr, "Missing sweep argument\n");
+            exit(1);
+        }
+    }
+
+    // Allocate array for every combination of values and error check.
+    sweep->scheduled_processes = sps;
+    sweep->runs_len = len[0] * len[1] * len[2] * len[3] * len[4];
+    sweep->runs = (sweep_run_t*)malloc(sizeof(sweep_run_t) * sweep->runs_len);
+    if (sweep->runs == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    sweep->next_run = 0;
+    pthread_mutex_init(&sweep->next_run_lock, NULL);
+
+    // Set each run.
+    run = sweep->runs;
+    for (a = 0; a < len[0]; a++)
+    for (m = 0; m < len[1]; m++)
+    for (q = 0; q < len[2]; q++)
+    for (f = 0; f < len[3]; f++)
+    for (e = 0; e < len[4]; e++)
+    {
+        run->algorithm_name = algs[a];
+        run->quanta_name = qs[q];
+        run->fit_policy_name = fits[f];
+        run->options = *options;
+
+        run->options.scheduling_policy = get_scheduling_policy_by_name(algs[a]);
+        if (run->options.scheduling_policy == NULL)
+        {
+            fprintf(stderr, "Invalid algorithm argument\n");
+            exit(1);
+        }
+        run->options.memsize = atoi(mems[m]);
+        if (run->options.memsize < 1)
+        {
+            fprintf(stderr, "Invalid memory size argument\n");
+            exit(1);
+        }
+        run->options.levels = parse_quanta(qs[q], &run->options.quanta);
+        if (run->options.levels == 0)
+        {
+            fprintf(stderr, "Invalid quanta argument\n");
+            exit(1);
+        }
+        if (!parse_fit_policy(fits[f], &run->options.fit_policy))
+        {
+            fprintf(stderr, "Invalid fit policy argument\n");
+            exit(1);
+        }
+        run->options.eviction_policy = get_eviction_policy_by_name(evicts[e]);
+        if (run->options.eviction_policy == NULL)
+        {
+            fprintf(stderr, "Invalid eviction policy argument\n");
+            exit(1);
+        }
+        run->options.output = NULL;
+        run->options.event_log = NULL;
+        run->options.metrics = NULL;
+
+        run++;
+    }
+
+    return sweep;
+}
+
+char **split_sweep_values(char str[], char delimiter)
+{
+    char **values;
+    int values_len = 0, i;
+    char *start, *end;
+
+    // Allocate array for at most one value per character and error check.
+    values = (char**)malloc(sizeof(char*) * (strlen(str) + 2));
+    if (values == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Copy each non-empty value.
+    start = str;
+    while (*start != '\0')
+    {
+        end = start;
+        while (*end != '\0' && *end != delimiter)
+        {
+            end++;
+        }
+        if (end != start)
+        {
+            values[values_len] = (char*)malloc(end - start + 1);
+            if (values[values_len] == NULL)
+            {
+                perror("malloc");
+                exit(1);
+            }
+            for (i = 0; i < end - start; i++)
+            {
+                values[values_len][i] = start[i];
+            }
+            values[values_len][end - start] = '\0';
+            values_len++;
+        }
+        start = (*end == delimiter) ? end + 1 : end;
+    }
+
+    // Null-pointer terminate the array.
+    values[values_len] = NULL;
+
+    return values;
+}
+
+void free_sweep_values(char **values)
+{
+    int i;
+    for (i = 0; values[i] != NULL; i++)
+    {
+        free(values[i]);
+    }
+    free(values);
+    return;
+}
+
+void run_parameter_sweep(parameter_sweep_t *sweep, int threads)
+{
+    pthread_t *workers;
+    int i;
+
+    // Allocate array for worker threads and error check.
+    workers = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    if (workers == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Start worker threads and wait for them to run every configuration.
+    for (i = 0; i < threads; i++)
+    {
+        if (pthread_create(&workers[i], NULL, parameter_sweep_worker, sweep) != 0)
+        {
+            perror("pthread_create");
+            exit(1);
+        }
+    }
+    for (i = 0; i < threads; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+
+    free(workers);
+
+    return;
+}
+
+void *parameter_sweep_worker(void *sweep_arg)
+{
+    parameter_sweep_t *sweep = (parameter_sweep_t*)sweep_arg;
+    sweep_run_t *run;
+    scheduled_process_source_t *source;
+
+    while (1)
+    {
+        // Take next configuration to run, if any left.
+        pthread_mutex_lock(&sweep->next_run_lock);
+        run = (sweep->next_run < sweep->runs_len) ?
+            &sweep->runs[sweep->next_run++] : NULL;
+        pthread_mutex_unlock(&sweep->next_run_lock);
+        if (run == NULL)
+        {
+            break;
+        }
+
+        // Each run reads the shared scheduled processes from its own source.
+        source = new_table_source(sweep->scheduled_processes, 0);
+        scheduler_run(source, &run->options, &run->summary);
+        free_scheduled_process_source(source);
+    }
+
+    return NULL;
+}
+
+void print_parameter_sweep(parameter_sweep_t *sweep, FILE *fp)
+{
+    sweep_run_t *run;
+    int i;
+
+    fprintf(fp, "algorithm,memsize,quanta,fit,eviction,context_switches,"
+        "max_processes,max_holes,max_memusage,finish_time,max_internal_frag,"
+        "max_external_frag,compactions\n");
+    for (i = 0; i < sweep->runs_len; i++)
+    {
+        run = &sweep->runs[i];
+        fprintf(fp, "%s,%d,\"%s\",%s,%s,%d,%d,%d,%d,%d,%d,%d,%d\n",
+            run->algorithm_name,
+            run->options.memsize,
+            run->quanta_name,
+            run->fit_policy_name,
+            run->options.eviction_policy->name,
+            run->summary.context_switches,
+            run->summary.max_processes,
+            run->summary.max_holes,
+            run->summary.max_memusage,
+            run->summary.finish_time,
+            run->summary.max_internal_frag,
+            run->summary.max_external_frag,
+            run->summary.compactions
+            );
+    }
+
+    return;
+}
+
+void free_parameter_sweep(parameter_sweep_t *sweep)
+{
+    int i;
+
+    if (sweep == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < sweep->runs_len; i++)
+    {
+        free(sweep->runs[i].options.quanta);
+    }
+    for (i = 0; i < 5; i++)
+    {
+        free_sweep_values(sweep->values[i]);
+    }
+    pthread_mutex_destroy(&sweep->next_run_lock);
+    free(sweep->runs);
+    free(sweep);
+
+    return;
+}
@@ -0,0 +1,73 @@
+/*
+ * parameter-sweep.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Separators of values, and of quanta sets, in sweep arguments.
+#define SWEEP_VALUE_DELIMITER  ','
+#define SWEEP_QUANTA_DELIMITER '/'
+// Values swept over when not given.
+#define SWEEP_DEFAULT_ALGORITHMS "fcfs,multi"
+#define SWEEP_DEFAULT_QUANTA     "2,4,8"
+#define SWEEP_DEFAULT_FITS       "first"
+#define SWEEP_DEFAULT_EVICTIONS  "largest"
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Data structure to hold one configuration of a parameter sweep and, once run,
+ * its summary.
+ */
+typedef struct sweep_run_t
+{
+    char                 *algorithm_name;
+    char                 *quanta_name;
+    char                 *fit_policy_name;
+    scheduler_options_t  options;
+    simulation_summary_t summary;
+} sweep_run_t;
+
+/* Data structure to hold a parameter sweep: every combination of the given
+ * algorithms, memory sizes, quanta, fit and eviction policies, run over the
+ * same (shared, read only) scheduled processes.
+ */
+typedef struct parameter_sweep_t
+{
+    scheduled_processes_table_t *scheduled_processes;
+    sweep_run_t         *runs;
+    int                 runs_len;
+    int                 next_run;  // Next run for a worker thread to take.
+    pthread_mutex_t     next_run_lock;
+    char                **values[5];  // Split arguments, freed with sweep.
+} parameter_sweep_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Allocate memory for and initialise a new parameter sweep over the comma
+ * separated algorithms, memory sizes, fit and eviction policies, and the slash
+ * separated quanta sets (e.g. "2,4,8/5,10,15"). NULL arguments take their
+ * defaults, except memory sizes. Every run takes its other options (e.g. boost
+ * interval and CPUs) from the given ones. Exits if an argument is invalid.
+ */
+parameter_sweep_t *new_parameter_sweep(scheduled_processes_table_t *sps,
+    char algorithms[], char memsizes[], char quanta[], char fit_policies[],
+    char eviction_policies[], scheduler_options_t *options);
+/* Split a string by a delimiter into a newly allocated, NULL terminated array
+ * of newly allocated strings.
+ */
+char **split_sweep_values(char str[], char delimiter);
+/* Free a split array of strings. */
+void free_sweep_values(char **values);
+/* Run every configuration of the parameter sweep using a pool of threads. */
+void run_parameter_sweep(parameter_sweep_t *sweep, int threads);
+/* Worker thread: take and run configurations until there are none left. */
+void *parameter_sweep_worker(void *sweep);
+/* Print one summary row per configuration, in sweep order. */
+void print_parameter_sweep(parameter_sweep_t *sweep, FILE *fp);
+/* Free all memory allocated for the parameter sweep. */
+void free_parameter_sweep(parameter_sweep_t *sweep);
@@ -0,0 +1,934 @@
+/*
+ * pcb-table.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "object-pool.h"
+#include "event-log.h"
+#include "memory-management.h"
+#include "eviction-policy.h"
+#include "process-data-file-parser.h"
+#include "scheduled-process-source.h"
+#include "process-metrics.h"
+#include "process-scheduler.h"
+#include "scheduling-policy.h"
+#include "pcb-table.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+pcb_table_t *new_pcb_table()
+{
+    pcb_table_t *table;
+
+    // Allocate memory for pcb table and error check.
+    table = (pcb_table_t*)malloc(sizeof(pcb_table_t));
+    if (table == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set pcb table, with no slots until grown.
+    table->capacity = 0;
+    table->process_ids = NULL;
+    table->priorities = NULL;
+    table->job_times = NULL;
+    table->burst_times = NULL;
+    table->cpu_times = NULL;
+    table->cpus = NULL;
+    table->metrics = NULL;
+    table->memory_sizes = NULL;
+    table->start_addresses = NULL;
+    table->swap_in_times = NULL;
+    table->sequences = NULL;
+    table->heap_indexes = NULL;
+    table->swap_counts = NULL;
+    table->pinned = NULL;
+    table->free_slots = NULL;
+    table->free_len = 0;
+    table->resident_heap = NULL;
+    table->resident_heap_len = 0;
+    table->next_sequence = 0;
+    table->resident_count = 0;
+    table->resident_size = 0;
+    table->pinned_count = 0;
+    grow_pcb_table(table);
+
+    return table;
+}
+
+void grow_pcb_table(pcb_table_t *table)
+{
+    int i, capacity;
+
+    capacity = (table->capacity == 0) ?
+        INITIAL_PCB_TABLE_CAPACITY : table->capacity * PCB_TABLE_GROW_FACTOR;
+
+    // Reallocate every array and error check.
+    table->process_ids = (int*)realloc(table->process_ids, sizeof(int) * capacity);
+    table->priorities = (int*)realloc(table->priorities, sizeof(int) * capacity);
+    table->job_times = (int*)realloc(table->job_times, sizeof(int) * capacity);
+    table->burst_times = (int*)realloc(table->burst_times, sizeof(int) * capacity);
+    table->cpu_times = (int*)realloc(table->cpu_times, sizeof(int) * capacity);
+    table->cpus = (int*)realloc(table->cpus, sizeof(int) * capacity);
+    table->metrics = (process_metrics_t*)realloc(table->metrics, sizeof(process_metrics_t) * capacity);
+    table->memory_sizes = (int*)realloc(table->memory_sizes, sizeof(int) * capacity);
+    table->start_addresses = (int*)realloc(table->start_addresses, sizeof(int) * capacity);
+    table->swap_in_times = (int*)realloc(table->swap_in_times, sizeof(int) * capacity);
+    table->sequences = (int*)realloc(table->sequences, sizeof(int) * capacity);
+    table->heap_indexes = (int*)realloc(table->heap_indexes, sizeof(int) * capacity);
+    table->swap_counts = (int*)realloc(table->swap_counts, sizeof(int) * capacity);
+    table->pinned = (int*)realloc(table->pinned, sizeof(int) * capacity);
+    table->free_slots = (int*)realloc(table->free_slots, sizeof(int) * capacity);
+    table->resident_heap = (int*)realloc(table->resident_heap, sizeof(int) * capacity);
+    if (table->process_ids == NULL || table->priorities == NULL ||
+        table->job_times == NULL || table->burst_times == NULL ||
+        table->cpu_times == NULL || table->cpus == NULL ||
+        table->metrics == NULL || table->memory_sizes == NULL ||
+        table->start_addresses == NULL || table->swap_in_times == NULL ||
+        table->sequences == NULL || table->heap_indexes == NULL ||
+        table->swap_counts == NULL || table->pinned == NULL ||
+        table->free_slots == NULL || table->resident_heap == NULL)
+    {
+        perror("realloc");
+        exit(1);
+    }
+
+    // Add new slots as free, the lowest taken first.
+    for (i = capacity - 1; i >= table->capacity; i--)
+    {
+        table->free_slots[table->free_len] = i;
+        table->free_len++;
+    }
+    table->capacity = capacity;
+
+    return;
+}
+
+int add_scheduled_process_to_pcb_table(scheduled_process_t *sp,
+    pcb_table_t *table)
+{
+    int slot;
+
+    // Take a free slot, growing the table first if there is none.
+    if (table->free_len == 0)
+    {
+        grow_pcb_table(table);
+    }
+    table->free_len--;
+    slot = table->free_slots[table->free_len];
+
+    // Set pcb fields.
+    table->process_ids[slot] = sp->process_id;
+    table->priorities[slot] = 1;
+    table->job_times[slot] = sp->job_time;
+    table->burst_times[slot] = 0;
+    table->cpu_times[slot] = 0;
+    table->cpus[slot] = NO_CPU;
+    reset_process_metrics(&table->metrics[slot], sp->start_time);
+
+    // Set process memory fields, numbered in the order added.
+    table->memory_sizes[slot] = sp->memory_size;
+    table->start_addresses[slot] = IN_DISK;
+    table->swap_in_times[slot] = 0;
+    table->sequences[slot] = table->next_sequence;
+    table->next_sequence++;
+    table->heap_indexes[slot] = NOT_IN_HEAP;
+    table->swap_counts[slot] = 0;
+    table->pinned[slot] = 0;
+
+    return slot;
+}
+
+void free_pcb_table(pcb_table_t *table)
+{
+    free(table->process_ids);
+    free(table->priorities);
+    free(table->job_times);
+    free(table->burst_times);
+    free(table->cpu_times);
+    free(table->cpus);
+    free(table->metrics);
+    free(table->memory_sizes);
+    free(table->start_addresses);
+    free(table->swap_in_times);
+    free(table->sequences);
+    free(table->heap_indexes);
+    free(table->swap_counts);
+    free(table->pinned);
+    free(table->free_slots);
+    free(table->resident_heap);
+    free(table);
+
+    return;
+}
+
+void init_slot_ring(slot_ring_t *ring)
+{
+    // Allocate memory for slots and error check.
+    ring->slots = (int*)malloc(sizeof(int) * INITIAL_SLOT_RING_CAPACITY);
+    if (ring->slots == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    ring->mask = INITIAL_SLOT_RING_CAPACITY - 1;
+    ring->head = 0;
+    ring->len = 0;
+
+    return;
+}
+
+void push_back_slot_ring(int slot, slot_ring_t *ring)
+{
+    if (ring->len > ring->mask)
+    {
+        grow_slot_ring(ring);
+    }
+    ring->slots[(ring->head + ring->len) & ring->mask] = slot;
+    ring->len++;
+    return;
+}
+
+void push_front_slot_ring(int slot, slot_ring_t *ring)
+{
+    if (ring->len > ring->mask)
+    {
+        grow_slot_ring(ring);
+    }
+    ring->head = (ring->head - 1) & ring->mask;
+    ring->slots[ring->head] = slot;
+    ring->len++;
+    return;
+}
+
+int pop_front_slot_ring(slot_ring_t *ring)
+{
+    int slot;
+
+    if (ring->len == 0)
+    {
+        return NO_SLOT;
+    }
+    slot = ring->slots[ring->head];
+    ring->head = (ring->head + 1) & ring->mask;
+    ring->len--;
+
+    return slot;
+}
+
+void grow_slot_ring(slot_ring_t *ring)
+{
+    unsigned int capacity = ring->mask + 1;
+
+    ring->slots = (int*)realloc(ring->slots, sizeof(int) * capacity * 2);
+    if (ring->slots == NULL)
+    {
+        perror("realloc");
+        exit(1);
+    }
+
+    // Move the slots that wrapped around to the start after the old end.
+    if (ring->head + ring->len > capacity)
+    {
+        memcpy(&ring->slots[capacity], ring->slots,
+            sizeof(int) * (ring->head + ring->len - capacity));
+    }
+    ring->mask = capacity * 2 - 1;
+
+    return;
+}
+
+void free_slot_ring(slot_ring_t *ring)
+{
+    free(ring->slots);
+    ring->slots = NULL;
+
+    return;
+}
+
+int is_slot_swapped_out_before(int slot, int other_slot,
+    pcb_table_t *table)
+{
+    /* Larger first, then swapped in earlier, then added later, as
+     * is_process_memory_swapped_out_before.
+     */
+    if (table->memory_sizes[slot] != table->memory_sizes[other_slot])
+    {
+        return (table->memory_sizes[slot] > table->memory_sizes[other_slot]);
+    }
+    if (table->swap_in_times[slot] != table->swap_in_times[other_slot])
+    {
+        return (table->swap_in_times[slot] < table->swap_in_times[other_slot]);
+    }
+    return (table->sequences[slot] > table->sequences[other_slot]);
+}
+
+void add_slot_to_resident_heap(int slot, pcb_table_t *table)
+{
+    // Add to bottom of heap, which has room for every slot, and move up.
+    table->heap_indexes[slot] = table->resident_heap_len;
+    table->resident_heap[table->resident_heap_len] = slot;
+    table->resident_heap_len++;
+    sift_up_slot_resident_heap(table->heap_indexes[slot], table);
+
+    return;
+}
+
+void remove_slot_from_resident_heap(int slot, pcb_table_t *table)
+{
+    int i = table->heap_indexes[slot];
+    int last_slot;
+
+    // Not in heap, don't do anything.
+    if (i == NOT_IN_HEAP)
+    {
+        return;
+    }
+
+    // Move last slot into the hole and restore heap order.
+    table->resident_heap_len--;
+    last_slot = table->resident_heap[table->resident_heap_len];
+    if (last_slot != slot)
+    {
+        table->resident_heap[i] = last_slot;
+        table->heap_indexes[last_slot] = i;
+        sift_up_slot_resident_heap(i, table);
+        sift_down_slot_resident_heap(table->heap_indexes[last_slot], table);
+    }
+    table->heap_indexes[slot] = NOT_IN_HEAP;
+
+    return;
+}
+
+void sift_up_slot_resident_heap(int i, pcb_table_t *table)
+{
+    int *heap = table->resident_heap, slot = heap[i];
+    int parent;
+
+    // Move up while ordered before parent.
+    while (i > 0)
+    {
+        parent = (i - 1) / 2;
+        if (!is_slot_swapped_out_before(slot, heap[parent], table))
+        {
+            break;
+        }
+        heap[i] = heap[parent];
+        table->heap_indexes[heap[i]] = i;
+        i = parent;
+    }
+    heap[i] = slot;
+    table->heap_indexes[slot] = i;
+
+    return;
+}
+
+void sift_down_slot_resident_heap(int i, pcb_table_t *table)
+{
+    int *heap = table->resident_heap, slot = heap[i];
+    int len = table->resident_heap_len, child;
+
+    // Move down while a child is ordered before.
+    while ((child = 2 * i + 1) < len)
+    {
+        if (child + 1 < len &&
+            is_slot_swapped_out_before(heap[child + 1], heap[child], table))
+        {
+            child++;
+        }
+        if (!is_slot_swapped_out_before(heap[child], slot, table))
+        {
+            break;
+        }
+        heap[i] = heap[child];
+        table->heap_indexes[heap[i]] = i;
+        i = child;
+    }
+    heap[i] = slot;
+    table->heap_indexes[slot] = i;
+
+    return;
+}
+
+int swap_in_slot(int slot, int time, pcb_table_t *table,
+    free_memory_segments_list_t *mem_segs_list, scheduler_options_t *options)
+{
+    while (table->start_addresses[slot] == IN_DISK)
+    {
+        // Take free memory with fittable size by the list's fit policy.
+        table->start_addresses[slot] = take_fitting_free_memory(
+            table->memory_sizes[slot], mem_segs_list
+            );
+        if (table->start_addresses[slot] != IN_DISK)
+        {
+            // Occupy free memory.
+            table->swap_in_times[slot] = time;
+            table->swap_counts[slot]++;
+            add_slot_to_resident_heap(slot, table);
+            table->resident_count++;
+            table->resident_size += table->memory_sizes[slot];
+
+            log_simulation_event(options->event_log, swap_in_event,
+                table->process_ids[slot], table->start_addresses[slot],
+                table->memory_sizes[slot]);
+            log_holes_count(options->event_log, mem_segs_list->count);
+
+            return 1;
+        }
+
+        /* No process memory left to swap out, so it can never fit, unless some
+         * are pinned.
+         */
+        if (table->resident_heap_len == 0)
+        {
+            if (table->pinned_count > 0)
+            {
+                return 0;
+            }
+            // Blocks are at most the largest power of two in main memory.
+            if (mem_segs_list->buddy != NULL)
+            {
+                fprintf(stderr, "Process memory larger than largest buddy block\n");
+                exit(1);
+            }
+            fprintf(stderr, "Process memory larger than main memory\n");
+            exit(1);
+        }
+        swap_out_slot(table->resident_heap[0], table, mem_segs_list, options);
+    }
+
+    return 1;
+}
+
+void swap_out_slot(int slot, pcb_table_t *table,
+    free_memory_segments_list_t *mem_segs_list, scheduler_options_t *options)
+{
+    // Can only swap out processes in memory (not disk).
+    if (table->start_addresses[slot] == IN_DISK)
+    {
+        return;
+    }
+    unpin_slot(slot, table);
+    remove_slot_from_resident_heap(slot, table);
+
+    // Add memory occupied by process back as free memory segment into list.
+    add_new_free_memory_segment_to_free_memory_segments_list(
+        table->start_addresses[slot],
+        table->memory_sizes[slot],
+        mem_segs_list);
+
+    log_simulation_event(options->event_log, swap_out_event,
+        table->process_ids[slot], table->start_addresses[slot],
+        table->memory_sizes[slot]);
+    log_holes_count(options->event_log, mem_segs_list->count);
+
+    // Update process memory fields.
+    table->start_addresses[slot] = IN_DISK;
+    table->swap_in_times[slot] = 0;
+    table->resident_count--;
+    table->resident_size -= table->memory_sizes[slot];
+
+    return;
+}
+
+void pin_slot(int slot, pcb_table_t *table)
+{
+    if (table->start_addresses[slot] != IN_DISK && !table->pinned[slot])
+    {
+        remove_slot_from_resident_heap(slot, table);
+        table->pinned[slot] = 1;
+        table->pinned_count++;
+    }
+    return;
+}
+
+void unpin_slot(int slot, pcb_table_t *table)
+{
+    if (table->pinned[slot])
+    {
+        table->pinned[slot] = 0;
+        table->pinned_count--;
+        add_slot_to_resident_heap(slot, table);
+    }
+    return;
+}
+
+table_cpu_t *new_table_cpus(int len, int levels)
+{
+    int i, j;
+    table_cpu_t *cpus;
+
+    // Allocate memory for CPUs and error check.
+    cpus = (table_cpu_t*)malloc(sizeof(table_cpu_t) * len);
+    if (cpus == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set CPUs, each with one ready ring per priority level.
+    for (i = 0; i < len; i++)
+    {
+        cpus[i].id = i;
+        cpus[i].running = NO_SLOT;
+        cpus[i].waiting = 0;
+        cpus[i].levels = levels;
+        cpus[i].migration_time = 0;
+        cpus[i].ready_rings = (slot_ring_t*)malloc(sizeof(slot_ring_t) * levels);
+        if (cpus[i].ready_rings == NULL)
+        {
+            perror("malloc");
+            exit(1);
+        }
+        for (j = 0; j < levels; j++)
+        {
+            init_slot_ring(&cpus[i].ready_rings[j]);
+        }
+    }
+
+    return cpus;
+}
+
+void free_table_cpus(table_cpu_t cpus[], int len)
+{
+    int i, j;
+
+    for (i = 0; i < len; i++)
+    {
+        for (j = 0; j < cpus[i].levels; j++)
+        {
+            free_slot_ring(&cpus[i].ready_rings[j]);
+        }
+        free(cpus[i].ready_rings);
+    }
+    free(cpus);
+
+    return;
+}
+
+void enqueue_slot_on_table_cpu(int slot, table_cpu_t *cpu,
+    pcb_table_t *table)
+{
+    push_back_slot_ring(slot, &cpu->ready_rings[table->priorities[slot] - 1]);
+    cpu->waiting++;
+    return;
+}
+
+void put_back_slot_on_table_cpu(int slot, table_cpu_t *cpu,
+    pcb_table_t *table)
+{
+    push_front_slot_ring(slot, &cpu->ready_rings[table->priorities[slot] - 1]);
+    cpu->waiting++;
+    return;
+}
+
+int get_table_cpu_load(table_cpu_t *cpu)
+{
+    return (cpu->running != NO_SLOT) + cpu->waiting;
+}
+
+table_cpu_t *get_least_loaded_table_cpu(table_cpu_t cpus[], int len)
+{
+    int i;
+    table_cpu_t *least = &cpus[0];
+    int least_load = get_table_cpu_load(least);
+
+    for (i = 1; i < len && least_load > 0; i++)
+    {
+        if (get_table_cpu_load(&cpus[i]) < least_load)
+        {
+            least = &cpus[i];
+            least_load = get_table_cpu_load(least);
+        }
+    }
+
+    return least;
+}
+
+int pop_next_slot_from_table_cpu(table_cpu_t *cpu)
+{
+    int i;
+
+    if (cpu->waiting == 0)
+    {
+        return NO_SLOT;
+    }
+    cpu->waiting--;
+
+    // First process of the highest priority level with any.
+    for (i = 0; cpu->ready_rings[i].len == 0; i++)
+    {
+        continue;
+    }
+
+    return pop_front_slot_ring(&cpu->ready_rings[i]);
+}
+
+int steal_slot_for_table_cpu(table_cpu_t *cpu, table_cpu_t cpus[],
+    int len, table_cpu_t **from_cpu)
+{
+    int i;
+    int most_waiting = 0;
+
+    // Find the other CPU with the most waiting processes.
+    *from_cpu = NULL;
+    for (i = 0; i < len; i++)
+    {
+        if (&cpus[i] != cpu && cpus[i].waiting > most_waiting)
+        {
+            *from_cpu = &cpus[i];
+            most_waiting = cpus[i].waiting;
+        }
+    }
+
+    return (*from_cpu != NULL) ? pop_next_slot_from_table_cpu(*from_cpu) : NO_SLOT;
+}
+
+void boost_table_cpu(table_cpu_t *cpu, pcb_table_t *table)
+{
+    int i;
+    int slot;
+
+    /* Move slots of each lower priority level, in level order, to the end of
+     * the highest priority level ring.
+     */
+    for (i = 1; i < cpu->levels; i++)
+    {
+        while ((slot = pop_front_slot_ring(&cpu->ready_rings[i])) != NO_SLOT)
+        {
+            table->priorities[slot] = 1;
+            push_back_slot_ring(slot, &cpu->ready_rings[0]);
+        }
+    }
+
+    return;
+}
+
+void check_scheduled_processes_for_pcb_table(scheduled_process_source_t *source,
+    int time, table_cpu_t cpus[], pcb_table_t *table,
+    scheduler_options_t *options)
+{
+    scheduled_process_t *sp;
+
+    // Add each scheduled process that has arrived to a slot and enqueue it.
+    while ((sp = peek_scheduled_process(source)) != NULL && sp->start_time <= time)
+    {
+        enqueue_slot_on_table_cpu(
+            add_scheduled_process_to_pcb_table(sp, table),
+            get_least_loaded_table_cpu(cpus, options->cpus), table);
+
+        take_scheduled_process(source, NULL);
+    }
+
+    return;
+}
+
+void dispatch_table_cpu(table_cpu_t *cpu, table_cpu_t cpus[], int time,
+    pcb_table_t *table, free_memory_segments_list_t *mem_segs_list,
+    scheduler_options_t *options, simulation_summary_t *summary)
+{
+    table_cpu_t *from_cpu = cpu;
+    int slot;
+    memory_stats_t stats;
+
+    // Run its own next process, otherwise steal one from a busier CPU.
+    slot = pop_next_slot_from_table_cpu(cpu);
+    if (slot == NO_SLOT)
+    {
+        slot = steal_slot_for_table_cpu(cpu, cpus, options->cpus, &from_cpu);
+    }
+    if (slot == NO_SLOT)
+    {
+        return;
+    }
+
+    /* Memory is held by processes running on other CPUs, so put it back first
+     * in line and wait for one of them to stop. Largest eviction does nothing
+     * when a process is used again while in main memory.
+     */
+    if (table->start_addresses[slot] == IN_DISK &&
+        !swap_in_slot(slot, time, table, mem_segs_list, options))
+    {
+        put_back_slot_on_table_cpu(slot, from_cpu, table);
+        return;
+    }
+    table->burst_times[slot] = 0;
+    if (table->metrics[slot].first_run_time == NOT_RUN)
+    {
+        table->metrics[slot].first_run_time = time;
+    }
+
+    // Moving in a process that last ran on another CPU takes time.
+    cpu->migration_time = (table->cpus[slot] != NO_CPU && table->cpus[slot] != cpu->id) ?
+        options->migration_cost : 0;
+    table->cpus[slot] = cpu->id;
+    cpu->running = slot;
+
+    // Keep its memory from being swapped out by other CPUs while it runs.
+    if (options->cpus > 1)
+    {
+        pin_slot(slot, table);
+    }
+
+    log_simulation_event(options->event_log, load_event,
+        table->process_ids[slot], table->start_addresses[slot],
+        table->priorities[slot]);
+    get_segments_memory_stats(table->resident_count, table->resident_size,
+        mem_segs_list, &stats);
+    print_simulation_status_by_stats(time, table->process_ids[slot], cpu->id,
+        &stats, options, summary);
+
+    return;
+}
+
+int get_table_cpu_tick(table_cpu_t *cpu, pcb_table_t *table,
+    scheduler_options_t *options)
+{
+    int level, remaining;
+
+    // Never preempted with first come first served.
+    if (options->scheduling_policy == &fcfs_scheduling_policy)
+    {
+        return INT_MAX;
+    }
+
+    /* Quantum of its priority level (the lowest if beyond), or of the highest
+     * for every process with round robin.
+     */
+    level = table->priorities[cpu->running];
+    level = (level > options->levels) ? options->levels : level;
+    if (options->scheduling_policy == &rr_scheduling_policy)
+    {
+        level = 1;
+    }
+    remaining = options->quanta[level - 1] - table->burst_times[cpu->running];
+
+    return (remaining < 0) ? 0 : remaining;
+}
+
+int get_remaining_time_by_table_cpu(table_cpu_t *cpu, pcb_table_t *table,
+    scheduler_options_t *options)
+{
+    // Always runs for at least one time step once loaded.
+    int steps = table->job_times[cpu->running] - table->cpu_times[cpu->running];
+    int slice = get_table_cpu_tick(cpu, table, options);
+    steps = (steps < 1) ? 1 : steps;
+    return cpu->migration_time + ((slice < steps) ? slice : steps);
+}
+
+void run_table_cpu_for(table_cpu_t *cpu, pcb_table_t *table, int steps)
+{
+    // Finish moving the process in before running it.
+    int moving = (cpu->migration_time < steps) ? cpu->migration_time : steps;
+    cpu->migration_time -= moving;
+    if (steps > moving)
+    {
+        table->burst_times[cpu->running] += steps - moving;
+        table->cpu_times[cpu->running] += steps - moving;
+    }
+    return;
+}
+
+void preempt_table_cpu(table_cpu_t *cpu, pcb_table_t *table,
+    scheduler_options_t *options)
+{
+    int slot = cpu->running;
+
+    // Hand its memory back to the eviction policy.
+    unpin_slot(slot, table);
+
+    // Lower priority with multi-level queues, down to the lowest level.
+    if (options->scheduling_policy == &multi_scheduling_policy &&
+        table->priorities[slot] < options->levels)
+    {
+        table->priorities[slot]++;
+    }
+    table->burst_times[slot] = 0;
+
+    // Re-add it to wait.
+    log_simulation_event(options->event_log, preempt_event,
+        table->process_ids[slot], NO_EVENT_VALUE, table->priorities[slot]);
+    enqueue_slot_on_table_cpu(slot, cpu, table);
+    cpu->running = NO_SLOT;
+
+    return;
+}
+
+void terminate_table_cpu(table_cpu_t *cpu, int time, pcb_table_t *table,
+    free_memory_segments_list_t *mem_segs_list, scheduler_options_t *options)
+{
+    int slot = cpu->running;
+    process_metrics_t *metrics = &table->metrics[slot];
+
+    log_simulation_event(options->event_log, terminate_event,
+        table->process_ids[slot], NO_EVENT_VALUE, table->cpu_times[slot]);
+    swap_out_slot(slot, table, mem_segs_list, options);
+
+    // Waiting whenever not running from arrival to completion.
+    metrics->completion_time = time;
+    metrics->wait_time = time - metrics->arrival_time - table->cpu_times[slot];
+    metrics->swap_count = table->swap_counts[slot];
+    record_process_metrics(metrics, options->metrics);
+
+    // Release slot, to be reused by the next process to arrive.
+    table->free_slots[table->free_len] = slot;
+    table->free_len++;
+    cpu->running = NO_SLOT;
+
+    return;
+}
+
+int is_pcb_table_supported(scheduler_options_t *options)
+{
+    return (options->page_size == 0 &&
+        options->compaction_threshold == NO_COMPACTION &&
+        options->eviction_policy == &largest_eviction_policy &&
+        (options->scheduling_policy == &fcfs_scheduling_policy ||
+        options->scheduling_policy == &rr_scheduling_policy ||
+        options->scheduling_policy == &multi_scheduling_policy));
+}
+
+void scheduler_run_pcb_table(scheduled_process_source_t *source,
+    scheduler_options_t *options, simulation_summary_t *summary)
+{
+    int i;
+
+    int time = 0;  // Time steps.
+    int steps;     // Time steps until the next event.
+    int idle;      // Whether any CPU is idle.
+    int boosts = (options->scheduling_policy->boost != NULL &&
+        options->boost_interval > 0);
+    int next_boost_time = options->boost_interval;  // Time of next boost.
+    int running;
+    table_cpu_t *cpus;
+    pcb_table_t *table;
+    free_memory_segments_list_t *free_list;
+
+    // CPUs, pcb table and free memory segments list.
+    cpus = new_table_cpus(options->cpus, options->levels);
+    table = new_pcb_table();
+    free_list = new_free_memory_segments_list(options->memsize);
+    set_free_memory_segments_list_fit_policy(free_list, options->fit_policy);
+    reset_simulation_summary(summary);
+
+    // Events in the same order as run_scheduler_state, none preempting on arrival.
+    while (1)
+    {
+        set_event_log_time(options->event_log, time);
+
+        // Boost waiting processes back to the highest priority.
+        if (boosts && time >= next_boost_time)
+        {
+            for (i = 0; i < options->cpus; i++)
+            {
+                boost_table_cpu(&cpus[i], table);
+            }
+            next_boost_time = (time / options->boost_interval + 1) * options->boost_interval;
+        }
+
+        // Create and add new processes from scheduled processes if need be.
+        check_scheduled_processes_for_pcb_table(source, time, cpus, table, options);
+
+        // Load the next process on each CPU without a currently executing one.
+        for (i = 0; i < options->cpus; i++)
+        {
+            if (cpus[i].running == NO_SLOT)
+            {
+                dispatch_table_cpu(&cpus[i], cpus, time, table, free_list,
+                    options, summary);
+            }
+        }
+
+        // Execute processes until the next event on any CPU.
+        steps = INT_MAX;
+        idle = 0;
+        for (i = 0; i < options->cpus; i++)
+        {
+            if (cpus[i].running == NO_SLOT)
+            {
+                idle = 1;
+            }
+            else if (get_remaining_time_by_table_cpu(&cpus[i], table, options) < steps)
+            {
+                steps = get_remaining_time_by_table_cpu(&cpus[i], table, options);
+            }
+        }
+
+        // No process running and no more incoming, or skip to the next one.
+        if (steps == INT_MAX && peek_scheduled_process(source) == NULL)
+        {
+            break;
+        }
+        else if (steps == INT_MAX)
+        {
+            time = peek_scheduled_process(source)->start_time;
+            continue;
+        }
+
+        if (boosts && next_boost_time - time < steps)
+        {
+            steps = next_boost_time - time;
+        }
+        if (idle && peek_scheduled_process(source) != NULL &&
+            peek_scheduled_process(source)->start_time - time < steps)
+        {
+            steps = peek_scheduled_process(source)->start_time - time;
+        }
+
+        // Processes that arrive before then are added to the queues first.
+        check_scheduled_processes_for_pcb_table(
+            source, time + steps - 1, cpus, table, options
+            );
+        for (i = 0; i < options->cpus; i++)
+        {
+            if (cpus[i].running != NO_SLOT)
+            {
+                run_table_cpu_for(&cpus[i], table, steps);
+            }
+        }
+
+        // Next event time.
+        time += steps;
+        set_event_log_time(options->event_log, time);
+
+        for (i = 0; i < options->cpus; i++)
+        {
+            running = cpus[i].running;
+            if (running == NO_SLOT || cpus[i].migration_time > 0)
+            {
+                continue;
+            }
+
+            // Finished, or preempted by the scheduling policy.
+            if (table->cpu_times[running] >= table->job_times[running])
+            {
+                terminate_table_cpu(&cpus[i], time, table, free_list, options);
+            }
+            else if (get_table_cpu_tick(&cpus[i], table, options) == 0)
+            {
+                preempt_table_cpu(&cpus[i], table, options);
+            }
+        }
+    }
+
+    // Print end simulation message.
+    summary->compactions = free_list->compactions;
+    summary->compacted_size = free_list->compacted_size;
+    print_simulation_finished(time, options, summary);
+
+    free_table_cpus(cpus, options->cpus);
+    free_pcb_table(table);
+    free_free_memory_segments_list(free_list);
+
+    return;
+}
@@ -0,0 +1,202 @@
+/*
+ * pcb-table.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Used in running when a CPU has no currently executing process.
+#define NO_SLOT                      -1
+#define INITIAL_PCB_TABLE_CAPACITY   64
+#define PCB_TABLE_GROW_FACTOR        2
+// Must be a power of two, as ring capacities are kept as a mask.
+#define INITIAL_SLOT_RING_CAPACITY   16
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Data structure to hold the process control blocks and process memories of a
+ * run as parallel arrays of each field, indexed by slot, rather than as linked
+ * objects. Slots of terminated processes are reused, so the arrays stay as
+ * long as the most processes alive at once. Process memories in main memory
+ * are kept in a binary heap of slots, in the order largest eviction would
+ * swap them out.
+ */
+typedef struct pcb_table_t
+{
+    int               capacity;
+    // Process control block fields.
+    int               *process_ids;
+    int               *priorities;   // Determines the queue its in.
+    int               *job_times;    // Total time to finish process.
+    int               *burst_times;  // Time ran continuously on CPU.
+    int               *cpu_times;    // Total time ran on CPU.
+    int               *cpus;         // CPU it last ran on.
+    process_metrics_t *metrics;
+    // Process memory fields.
+    int               *memory_sizes;
+    int               *start_addresses;  // IN_DISK if not in main memory.
+    int               *swap_in_times;
+    int               *sequences;    // Order it was added, to break ties.
+    int               *heap_indexes; // Position in the resident heap.
+    int               *swap_counts;  // Times swapped into main memory.
+    int               *pinned;       // Kept from being swapped out.
+    // Slots not in use, taken from the end.
+    int               *free_slots;
+    int               free_len;
+    // Slots in main memory and not pinned.
+    int               *resident_heap;
+    int               resident_heap_len;
+    int               next_sequence;
+    int               resident_count;
+    int               resident_size;
+    int               pinned_count;
+} pcb_table_t;
+
+/* Data structure to hold a queue of slots as a ring buffer, doubled when full,
+ * so adding to either end and removing from the front are constant time.
+ */
+typedef struct slot_ring_t
+{
+    int          *slots;
+    unsigned int mask;  // Capacity less one.
+    unsigned int head;
+    unsigned int len;
+} slot_ring_t;
+
+/* Data structure to hold a (simulated) CPU of a pcb table run, with one ready
+ * ring per priority level.
+ */
+typedef struct table_cpu_t
+{
+    int         id;
+    int         running;  // Slot of currently executing process, or NO_SLOT.
+    int         waiting;  // Number of waiting processes.
+    slot_ring_t *ready_rings;
+    int         levels;
+    int         migration_time;  // Time left moving a process in.
+} table_cpu_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Allocate memory for and initialise a new, empty pcb table. */
+pcb_table_t *new_pcb_table();
+/* Grow the arrays of a pcb table, adding the new slots as free. */
+void grow_pcb_table(pcb_table_t *table);
+/* Take a free slot of the pcb table and set it to a newly arrived scheduled
+ * process, in disk. Returns the slot.
+ */
+int add_scheduled_process_to_pcb_table(scheduled_process_t *sp,
+    pcb_table_t *table);
+/* Free all memory allocated for the pcb table. */
+void free_pcb_table(pcb_table_t *table);
+/* Initialise an empty slot ring. */
+void init_slot_ring(slot_ring_t *ring);
+/* Add a slot to the end, or the front, of the slot ring. */
+void push_back_slot_ring(int slot, slot_ring_t *ring);
+void push_front_slot_ring(int slot, slot_ring_t *ring);
+/* Get and remove the first slot of the slot ring, or NO_SLOT if empty. */
+int pop_front_slot_ring(slot_ring_t *ring);
+/* Double the capacity of a full slot ring, keeping its order. */
+void grow_slot_ring(slot_ring_t *ring);
+/* Free all memory allocated for the slots of the slot ring. */
+void free_slot_ring(slot_ring_t *ring);
+/* Check if the process memory of a slot would be swapped out before another's,
+ * by the largest eviction policy's order.
+ */
+int is_slot_swapped_out_before(int slot, int other_slot,
+    pcb_table_t *table);
+/* Add or remove the slot to or from the resident heap, and move the slot at i
+ * to its position in it.
+ */
+void add_slot_to_resident_heap(int slot, pcb_table_t *table);
+void remove_slot_from_resident_heap(int slot, pcb_table_t *table);
+void sift_up_slot_resident_heap(int i, pcb_table_t *table);
+void sift_down_slot_resident_heap(int i, pcb_table_t *table);
+/* Swap the process memory of a slot into main memory, swapping out others as
+ * needed. Returns 0 if it cannot fit until processes running on other CPUs
+ * are stopped.
+ */
+int swap_in_slot(int slot, int time, pcb_table_t *table,
+    free_memory_segments_list_t *mem_segs_list, scheduler_options_t *options);
+/* Swap the process memory of a slot out of main memory, if in it. */
+void swap_out_slot(int slot, pcb_table_t *table,
+    free_memory_segments_list_t *mem_segs_list, scheduler_options_t *options);
+/* Keep the process memory of a slot from being swapped out, or allow it
+ * again.
+ */
+void pin_slot(int slot, pcb_table_t *table);
+void unpin_slot(int slot, pcb_table_t *table);
+/* Allocate memory for and initialise CPUs, each with empty ready rings. */
+table_cpu_t *new_table_cpus(int len, int levels);
+/* Free all memory allocated for CPUs and their ready rings. */
+void free_table_cpus(table_cpu_t cpus[], int len);
+/* Enqueue a waiting process at the end of its priority level's ready ring of
+ * a CPU, or put it back at the front to be picked again first.
+ */
+void enqueue_slot_on_table_cpu(int slot, table_cpu_t *cpu,
+    pcb_table_t *table);
+void put_back_slot_on_table_cpu(int slot, table_cpu_t *cpu,
+    pcb_table_t *table);
+/* Get the number of processes running on or waiting for a CPU. */
+int get_table_cpu_load(table_cpu_t *cpu);
+/* Get the CPU with the least load, the lowest numbered one on ties. */
+table_cpu_t *get_least_loaded_table_cpu(table_cpu_t cpus[], int len);
+/* Get and remove the first waiting process of the highest priority level of a
+ * CPU, or NO_SLOT if none wait.
+ */
+int pop_next_slot_from_table_cpu(table_cpu_t *cpu);
+/* Steal the next waiting process of the CPU with the most waiting processes
+ * (the lowest numbered one on ties), or NO_SLOT if none wait. from_cpu is set
+ * to the CPU it was stolen from.
+ */
+int steal_slot_for_table_cpu(table_cpu_t *cpu, table_cpu_t cpus[],
+    int len, table_cpu_t **from_cpu);
+/* Move every waiting process of a CPU to the highest priority level ring. */
+void boost_table_cpu(table_cpu_t *cpu, pcb_table_t *table);
+/* Create, on arrival of, new processes and enqueue them on the least loaded
+ * CPU.
+ */
+void check_scheduled_processes_for_pcb_table(scheduled_process_source_t *source,
+    int time, table_cpu_t cpus[], pcb_table_t *table,
+    scheduler_options_t *options);
+/* Dispatch the next process, its own or a stolen one, to an idle CPU and load
+ * it. The CPU stays idle if there is none or it cannot be loaded yet.
+ */
+void dispatch_table_cpu(table_cpu_t *cpu, table_cpu_t cpus[], int time,
+    pcb_table_t *table, free_memory_segments_list_t *mem_segs_list,
+    scheduler_options_t *options, simulation_summary_t *summary);
+/* Get the time steps the running process of a CPU has left before the
+ * scheduling policy preempts it.
+ */
+int get_table_cpu_tick(table_cpu_t *cpu, pcb_table_t *table,
+    scheduler_options_t *options);
+/* Get the time steps left until the running process of a CPU finishes or is
+ * preempted, including moving it in first.
+ */
+int get_remaining_time_by_table_cpu(table_cpu_t *cpu, pcb_table_t *table,
+    scheduler_options_t *options);
+/* Run a CPU for a number of time steps, moving its running process in first. */
+void run_table_cpu_for(table_cpu_t *cpu, pcb_table_t *table, int steps);
+/* Stop the running process of a CPU and enqueue it again. */
+void preempt_table_cpu(table_cpu_t *cpu, pcb_table_t *table,
+    scheduler_options_t *options);
+/* Terminate the running process of a CPU, release its memory and slot, and
+ * record its metrics.
+ */
+void terminate_table_cpu(table_cpu_t *cpu, int time, pcb_table_t *table,
+    free_memory_segments_list_t *mem_segs_list, scheduler_options_t *options);
+/* Check if a pcb table run supports the options: contiguous memory without
+ * compaction, largest eviction, and a scheduling policy of first come first
+ * served, round robin or multi-level queues. Other options need the linked
+ * pcbs of scheduler_run.
+ */
+int is_pcb_table_supported(scheduler_options_t *options);
+/* Run the process scheduler as scheduler_run does, with the same output, but
+ * keeping processes in a pcb table and queues of slots.
+ */
+void scheduler_run_pcb_table(scheduled_process_source_t *source,
+    scheduler_options_t *options, simulation_summary_t *summary);
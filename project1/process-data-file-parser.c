@@ -10,6 +10,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "process-data-file-parser.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -43,13 +48,10 @@ scheduled_process_t **parse_process_data_file(FILE *fp)
     int scheduled_procs_len = 0,
         scheduled_procs_max_len = INITIAL_SCHEDULED_PROCS_MAX_LEN;
 
-    scheduled_process_t *proc;
+    scheduled_process_t *proc, parsed_proc;
 
     char line[LINE_MAX_LEN];
 
-    char *tokens[TOKENS_LEN];
-    int tokens_count;
-
     // Allocate array for scheduled processes and error check.
     scheduled_procs = (scheduled_process_t**)malloc(sizeof(scheduled_process_t*) * (scheduled_procs_max_len + 1));
     if (scheduled_procs == NULL)
@@ -61,30 +63,18 @@ scheduled_process_t **parse_process_data_file(FILE *fp)
     // Read in line from file.
     while (fgets(line, LINE_MAX_LEN, fp) != NULL)
     {
-        // Get tokens.
-        tokens_count = 0;
-        tokens[tokens_count] = strtok(line, TOKEN_DELIMITER);
-        tokens_count++;
-        while (tokens[tokens_count - 1] != NULL && tokens_count < TOKENS_LEN)
-        {
-            tokens[tokens_count] = strtok(NULL, TOKEN_DELIMITER);
-            tokens_count++;
-        }
-
-        // Verify enough tokens.
-        if (tokens_count != TOKENS_LEN)
+        // Parse line, skipping it if invalid.
+        if (!parse_process_data_line(line, &parsed_proc))
         {
             continue;
-            /*fprintf(stderr, "Invalid file input\n");
-            exit(1);*/
         }
 
         // Create new scheduled process.
         proc = new_scheduled_process(
-            atoi(tokens[0]),  // Start time.
-            atoi(tokens[1]),  // Process id.
-            atoi(tokens[2]),  // Memory size.
-            atoi(tokens[3])   // Job time.
+            parsed_proc.start_time,
+            parsed_proc.process_id,
+            parsed_proc.memory_size,
+            parsed_proc.job_time
             );
 
         /* Add scheduled process to scheduled processes, realloc'ing first if
@@ -110,6 +100,347 @@ scheduled_process_t **parse_process_data_file(FILE *fp)
     return scheduled_procs;
 }
 
+int parse_process_data_line(char line[], scheduled_process_t *sp)
+{
+    char *tokens[TOKENS_LEN];
+    int tokens_count;
+    char *saveptr;
+
+    // Get tokens.
+    tokens_count = 0;
+    tokens[tokens_count] = strtok_r(line, TOKEN_DELIMITER, &saveptr);
+    tokens_count++;
+    while (tokens[tokens_count - 1] != NULL && tokens_count < TOKENS_LEN)
+    {
+        tokens[tokens_count] = strtok_r(NULL, TOKEN_DELIMITER, &saveptr);
+        tokens_count++;
+    }
+
+    // Verify enough tokens.
+    if (tokens_count != TOKENS_LEN || tokens[TOKENS_LEN - 1] == NULL)
+    {
+        return 0;
+    }
+
+    // Set scheduled process.
+    sp->start_time = atoi(tokens[0]);
+    sp->process_id = atoi(tokens[1]);
+    sp->memory_size = atoi(tokens[2]);
+    sp->job_time = atoi(tokens[3]);
+
+    return 1;
+}
+
+scheduled_process_t **parse_process_data_file_by_name(char filename[])
+{
+    FILE *fp;
+    scheduled_process_t **scheduled_procs;
+
+    // Open file and error check.
+    fp = fopen(filename, "r");
+    if (fp == NULL)
+    {
+        perror("fopen");
+        exit(1);
+    }
+
+    scheduled_procs = parse_process_data_file(fp);
+    fclose(fp);
+
+    return scheduled_procs;
+}
+
+scheduled_processes_table_t *new_scheduled_processes_table(int max_len)
+{
+    scheduled_processes_table_t *table;
+
+    // Allocate memory for table and error check.
+    table = (scheduled_processes_table_t*)malloc(sizeof(scheduled_processes_table_t));
+    if (table == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Allocate arrays of each field and error check.
+    table->len = 0;
+    table->max_len = max_len;
+    table->start_times = (int*)malloc(sizeof(int) * (max_len + 1));
+    table->process_ids = (int*)malloc(sizeof(int) * (max_len + 1));
+    table->memory_sizes = (int*)malloc(sizeof(int) * (max_len + 1));
+    table->job_times = (int*)malloc(sizeof(int) * (max_len + 1));
+    if (table->start_times == NULL || table->process_ids == NULL ||
+        table->memory_sizes == NULL || table->job_times == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    return table;
+}
+
+void append_to_scheduled_processes_table(scheduled_process_t *sp,
+    scheduled_processes_table_t *table)
+{
+    // Grow arrays first if necessary.
+    if (table->len == table->max_len)
+    {
+        table->max_len = (table->max_len < INITIAL_SCHEDULED_PROCS_MAX_LEN) ?
+            INITIAL_SCHEDULED_PROCS_MAX_LEN : table->max_len * SCHEDULED_PROCS_MAX_LEN_GROW_FACTOR;
+        table->start_times = (int*)realloc(table->start_times, sizeof(int) * (table->max_len + 1));
+        table->process_ids = (int*)realloc(table->process_ids, sizeof(int) * (table->max_len + 1));
+        table->memory_sizes = (int*)realloc(table->memory_sizes, sizeof(int) * (table->max_len + 1));
+        table->job_times = (int*)realloc(table->job_times, sizeof(int) * (table->max_len + 1));
+        if (table->start_times == NULL || table->process_ids == NULL ||
+            table->memory_sizes == NULL || table->job_times == NULL)
+        {
+            perror("realloc");
+            exit(1);
+        }
+    }
+
+    // Set row.
+    table->start_times[table->len] = sp->start_time;
+    table->process_ids[table->len] = sp->process_id;
+    table->memory_sizes[table->len] = sp->memory_size;
+    table->job_times[table->len] = sp->job_time;
+    table->len++;
+
+    return;
+}
+
+scheduled_processes_table_t *map_process_data_file(char filename[], int threads)
+{
+    scheduled_processes_table_t *table;
+    process_data_chunk_t chunks[MAX_LOADER_THREADS];
+    pthread_t loaders[MAX_LOADER_THREADS];
+    int fd, i, max_len = 0;
+    struct stat file_stat;
+    const char *data = NULL, *p;
+    size_t size;
+
+    // Open and map file and error check.
+    fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        perror("open");
+        exit(1);
+    }
+    if (fstat(fd, &file_stat) < 0)
+    {
+        perror("fstat");
+        exit(1);
+    }
+    size = (size_t)file_stat.st_size;
+    if (size > 0)
+    {
+        data = (const char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            perror("mmap");
+            exit(1);
+        }
+        madvise((void*)data, size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    // Split file into a chunk per thread, ending each on a line boundary.
+    threads = (threads < 1) ? 1 : (threads > MAX_LOADER_THREADS) ? MAX_LOADER_THREADS : threads;
+    p = data;
+    for (i = 0; i < threads; i++)
+    {
+        chunks[i].start = p;
+        if (i == threads - 1)
+        {
+            p = data + size;
+        }
+        else
+        {
+            p = (data + size / threads * (i + 1) > p) ? data + size / threads * (i + 1) : p;
+            while (p < data + size && *p != '\n')
+            {
+                p++;
+            }
+            p = (p < data + size) ? p + 1 : p;
+        }
+        chunks[i].end = p;
+    }
+
+    // Count lines in each chunk, which bounds its number of rows.
+    for (i = 0; i < threads; i++)
+    {
+        if (pthread_create(&loaders[i], NULL, count_process_data_chunk, &chunks[i]) != 0)
+        {
+            perror("pthread_create");
+            exit(1);
+        }
+    }
+    for (i = 0; i < threads; i++)
+    {
+        pthread_join(loaders[i], NULL);
+        chunks[i].offset = max_len;
+        max_len += chunks[i].len;
+    }
+
+    // Parse each chunk straight into its rows of the table.
+    table = new_scheduled_processes_table(max_len);
+    for (i = 0; i < threads; i++)
+    {
+        chunks[i].table = table;
+        if (pthread_create(&loaders[i], NULL, parse_process_data_chunk, &chunks[i]) != 0)
+        {
+            perror("pthread_create");
+            exit(1);
+        }
+    }
+    for (i = 0; i < threads; i++)
+    {
+        pthread_join(loaders[i], NULL);
+    }
+
+    // Close gaps left by skipped lines, keeping file order.
+    for (i = 0; i < threads; i++)
+    {
+        if (chunks[i].offset != table->len)
+        {
+            memmove(&table->start_times[table->len], &table->start_times[chunks[i].offset], sizeof(int) * chunks[i].len);
+            memmove(&table->process_ids[table->len], &table->process_ids[chunks[i].offset], sizeof(int) * chunks[i].len);
+            memmove(&table->memory_sizes[table->len], &table->memory_sizes[chunks[i].offset], sizeof(int) * chunks[i].len);
+            memmove(&table->job_times[table->len], &table->job_times[chunks[i].offset], sizeof(int) * chunks[i].len);
+        }
+        table->len += chunks[i].len;
+    }
+
+    if (data != NULL)
+    {
+        munmap((void*)data, size);
+    }
+
+    return table;
+}
+
+void *count_process_data_chunk(void *chunk_arg)
+{
+    process_data_chunk_t *chunk = (process_data_chunk_t*)chunk_arg;
+    const char *p = chunk->start;
+
+    // Count line ends, and a last line without one.
+    chunk->len = 0;
+    while (p < chunk->end &&
+        (p = (const char*)memchr(p, '\n', chunk->end - p)) != NULL)
+    {
+        chunk->len++;
+        p++;
+    }
+    if (chunk->end > chunk->start && chunk->end[-1] != '\n')
+    {
+        chunk->len++;
+    }
+
+    return NULL;
+}
+
+void *parse_process_data_chunk(void *chunk_arg)
+{
+    process_data_chunk_t *chunk = (process_data_chunk_t*)chunk_arg;
+    scheduled_processes_table_t *table = chunk->table;
+    const char *p = chunk->start, *end = chunk->end;
+    int tokens[TOKENS_LEN], tokens_count, value, row = chunk->offset;
+
+    while (p < end)
+    {
+        /* Parse tokens of line, split on spaces only like strtok in
+         * parse_process_data_line, so a line end after a space is a token too.
+         */
+        tokens_count = 0;
+        while (p < end)
+        {
+            if (*p == ' ')
+            {
+                p++;
+                continue;
+            }
+
+            // Extra tokens are ignored.
+            value = parse_process_data_int(&p, end);
+            if (tokens_count < TOKENS_LEN)
+            {
+                tokens[tokens_count] = value;
+            }
+            tokens_count++;
+
+            // Token ended the line.
+            if (p < end && *p == '\n')
+            {
+                p++;
+                break;
+            }
+        }
+
+        // Verify enough tokens.
+        if (tokens_count < TOKENS_LEN)
+        {
+            continue;
+        }
+
+        // Set row.
+        table->start_times[row] = tokens[0];
+        table->process_ids[row] = tokens[1];
+        table->memory_sizes[row] = tokens[2];
+        table->job_times[row] = tokens[3];
+        row++;
+    }
+    chunk->len = row - chunk->offset;
+
+    return NULL;
+}
+
+int parse_process_data_int(const char **p, const char *end)
+{
+    const char *q = *p;
+    int value = 0, sign = 1;
+
+    // Leading whitespace is skipped, up to the end of the line.
+    while (q < end && (*q == '\t' || *q == '\r' || *q == '\v' || *q == '\f'))
+    {
+        q++;
+    }
+
+    // Optional sign then digits, anything else ends the number.
+    if (q < end && (*q == '-' || *q == '+'))
+    {
+        sign = (*q == '-') ? -1 : 1;
+        q++;
+    }
+    while (q < end && *q >= '0' && *q <= '9')
+    {
+        value = value * 10 + (*q - '0');
+        q++;
+    }
+
+    // Skip rest of token, up to a space or the end of the line.
+    while (q < end && *q != ' ' && *q != '\n')
+    {
+        q++;
+    }
+    *p = q;
+
+    return sign * value;
+}
+
+void free_scheduled_processes_table(scheduled_processes_table_t *table)
+{
+    if (table != NULL)
+    {
+        free(table->start_times);
+        free(table->process_ids);
+        free(table->memory_sizes);
+        free(table->job_times);
+    }
+    free(table);
+    return;
+}
+
 void print_scheduled_process(scheduled_process_t *sp)
 {
     printf(
@@ -17,6 +17,7 @@
 #define LINE_MAX_LEN    100
 #define TOKEN_DELIMITER " "
 #define TOKENS_LEN      4
+#define MAX_LOADER_THREADS 64
 
 ////////////////////////////////////////////////////////////////////////////////
 // Data structures. ////////////////////////////////////////////////////////////
@@ -30,6 +31,31 @@ typedef struct scheduled_process_t
     int job_time;
 } scheduled_process_t;
 
+/* Data structure to hold a table of scheduled processes, in file order, as
+ * contiguous arrays of each field.
+ */
+typedef struct scheduled_processes_table_t
+{
+    int len;
+    int max_len;
+    int *start_times;
+    int *process_ids;
+    int *memory_sizes;
+    int *job_times;
+} scheduled_processes_table_t;
+
+/* Data structure to hold the part of a mapped file that one loader thread
+ * parses, and where its scheduled processes go in the table.
+ */
+typedef struct process_data_chunk_t
+{
+    const char                  *start;
+    const char                  *end;
+    int                         offset;  // First row of table to fill.
+    int                         len;     // Rows counted, then rows filled.
+    scheduled_processes_table_t *table;
+} process_data_chunk_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Function prototypes. ////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -38,6 +64,36 @@ scheduled_process_t *new_scheduled_process(int start_time, int process_id,
     int memory_size, int job_time);
 /* Parse a file and create an array of scheduled processes. */
 scheduled_process_t **parse_process_data_file(FILE *fp);
+/* Parse a line of four numbers into a scheduled process. Returns 0 if the line
+ * is invalid.
+ */
+int parse_process_data_line(char line[], scheduled_process_t *sp);
+/* Open and parse a file by its name and create an array of scheduled
+ * processes.
+ */
+scheduled_process_t **parse_process_data_file_by_name(char filename[]);
+/* Allocate memory for and initialise a new scheduled processes table with room
+ * for a number of scheduled processes.
+ */
+scheduled_processes_table_t *new_scheduled_processes_table(int max_len);
+/* Add a scheduled process to the end of the table, realloc'ing if necessary. */
+void append_to_scheduled_processes_table(scheduled_process_t *sp,
+    scheduled_processes_table_t *table);
+/* Memory map a file and parse it, split on line boundaries between a number of
+ * threads, straight into a scheduled processes table. Lines without four
+ * numbers are skipped.
+ */
+scheduled_processes_table_t *map_process_data_file(char filename[], int threads);
+/* Loader thread: count the lines of a chunk. */
+void *count_process_data_chunk(void *chunk);
+/* Loader thread: parse the lines of a chunk into its rows of the table. */
+void *parse_process_data_chunk(void *chunk);
+/* Parse a number like atoi does at the start of a space separated token,
+ * moving the pointer to the end of the token: the next space or line end.
+ */
+int parse_process_data_int(const char **p, const char *end);
+/* Free all memory allocated for a scheduled processes table. */
+void free_scheduled_processes_table(scheduled_processes_table_t *table);
 /* Print information about the scheduled process. */
 void print_scheduled_process(scheduled_process_t *sp);
 /* Print information about each scheduled process in the array. */
@@ -0,0 +1,164 @@
+/*
+ * process-metrics.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include "process-metrics.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void reset_process_metrics(process_metrics_t *metrics, int arrival_time)
+{
+    metrics->arrival_time = arrival_time;
+    metrics->first_run_time = NOT_RUN;
+    metrics->completion_time = 0;
+    metrics->wait_time = 0;
+    metrics->swap_count = 0;
+    return;
+}
+
+simulation_metrics_t *new_simulation_metrics()
+{
+    simulation_metrics_t *sim_metrics;
+
+    // Allocate memory for simulation metrics and its arrays and error check.
+    sim_metrics = (simulation_metrics_t*)malloc(sizeof(simulation_metrics_t));
+    if (sim_metrics == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    sim_metrics->max_len = INITIAL_METRICS_MAX_LEN;
+    sim_metrics->turnaround_times = (int*)malloc(sizeof(int) * sim_metrics->max_len);
+    sim_metrics->response_times = (int*)malloc(sizeof(int) * sim_metrics->max_len);
+    if (sim_metrics->turnaround_times == NULL || sim_metrics->response_times == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set simulation metrics.
+    sim_metrics->len = 0;
+    sim_metrics->total_wait_time = 0;
+    sim_metrics->total_swap_count = 0;
+    sim_metrics->max_wait_time = 0;
+    sim_metrics->max_swap_count = 0;
+
+    return sim_metrics;
+}
+
+void record_process_metrics(process_metrics_t *metrics,
+    simulation_metrics_t *sim_metrics)
+{
+    if (sim_metrics == NULL)
+    {
+        return;
+    }
+
+    // Grow arrays first if necessary.
+    if (sim_metrics->len == sim_metrics->max_len)
+    {
+        sim_metrics->max_len *= METRICS_MAX_LEN_GROW_FACTOR;
+        sim_metrics->turnaround_times = (int*)realloc(sim_metrics->turnaround_times, sizeof(int) * sim_metrics->max_len);
+        sim_metrics->response_times = (int*)realloc(sim_metrics->response_times, sizeof(int) * sim_metrics->max_len);
+        if (sim_metrics->turnaround_times == NULL || sim_metrics->response_times == NULL)
+        {
+            perror("realloc");
+            exit(1);
+        }
+    }
+
+    sim_metrics->turnaround_times[sim_metrics->len] = metrics->completion_time - metrics->arrival_time;
+    sim_metrics->response_times[sim_metrics->len] = metrics->first_run_time - metrics->arrival_time;
+    sim_metrics->len++;
+    sim_metrics->total_wait_time += metrics->wait_time;
+    sim_metrics->total_swap_count += metrics->swap_count;
+    if (metrics->wait_time > sim_metrics->max_wait_time)
+    {
+        sim_metrics->max_wait_time = metrics->wait_time;
+    }
+    if (metrics->swap_count > sim_metrics->max_swap_count)
+    {
+        sim_metrics->max_swap_count = metrics->swap_count;
+    }
+
+    return;
+}
+
+void print_simulation_metrics(simulation_metrics_t *sim_metrics,
+    int finish_time, FILE *fp)
+{
+    int len = sim_metrics->len;
+
+    fprintf(fp, "processes=%d, throughput=%.6f\n",
+        len, (finish_time > 0) ? (double)len / finish_time : 0.0);
+    print_times_distribution("turnaround", sim_metrics->turnaround_times, len, fp);
+    print_times_distribution("response", sim_metrics->response_times, len, fp);
+    fprintf(fp, "wait mean=%.2f max=%d\n",
+        (len > 0) ? (double)sim_metrics->total_wait_time / len : 0.0,
+        sim_metrics->max_wait_time);
+    fprintf(fp, "swaps mean=%.2f max=%d\n",
+        (len > 0) ? (double)sim_metrics->total_swap_count / len : 0.0,
+        sim_metrics->max_swap_count);
+
+    return;
+}
+
+void print_times_distribution(char name[], int *times, int len, FILE *fp)
+{
+    long long total = 0;
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        total += times[i];
+    }
+    qsort(times, len, sizeof(int), compare_times);
+
+    fprintf(fp, "%s mean=%.2f p50=%d p95=%d p99=%d max=%d\n",
+        name,
+        (len > 0) ? (double)total / len : 0.0,
+        get_times_percentile(times, len, 50),
+        get_times_percentile(times, len, 95),
+        get_times_percentile(times, len, 99),
+        (len > 0) ? times[len - 1] : 0
+        );
+
+    return;
+}
+
+int get_times_percentile(int *sorted_times, int len, int percentile)
+{
+    // Smallest time at least percentile % of times are at or below.
+    int rank = (int)(((long long)percentile * len + 99) / 100);
+
+    if (len == 0)
+    {
+        return 0;
+    }
+    return sorted_times[(rank > 0) ? rank - 1 : 0];
+}
+
+int compare_times(const void *a, const void *b)
+{
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+void free_simulation_metrics(simulation_metrics_t *sim_metrics)
+{
+    if (sim_metrics != NULL)
+    {
+        free(sim_metrics->turnaround_times);
+        free(sim_metrics->response_times);
+    }
+    free(sim_metrics);
+    return;
+}
@@ -0,0 +1,69 @@
+/*
+ * process-metrics.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Used in first run time when the process has not run yet.
+#define NOT_RUN -1
+#define INITIAL_METRICS_MAX_LEN 64
+#define METRICS_MAX_LEN_GROW_FACTOR 2
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Data structure to hold the latency metrics of a process. */
+typedef struct process_metrics_t
+{
+    int arrival_time;     // Time it was scheduled to start.
+    int first_run_time;   // Time it was first loaded to run.
+    int completion_time;  // Time it finished.
+    int wait_time;        // Total time waiting in a ready queue.
+    int swap_count;       // Times its memory was swapped in.
+} process_metrics_t;
+
+/* Data structure to hold the metrics of every finished process in a
+ * simulation, as turnaround (completion - arrival) and response (first run -
+ * arrival) times for percentiles, and totals for means.
+ */
+typedef struct simulation_metrics_t
+{
+    int       *turnaround_times;
+    int       *response_times;
+    int       len;
+    int       max_len;
+    long long total_wait_time;
+    long long total_swap_count;
+    int       max_wait_time;
+    int       max_swap_count;
+} simulation_metrics_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Initialise the metrics of a process arriving at a time. */
+void reset_process_metrics(process_metrics_t *metrics, int arrival_time);
+/* Allocate memory for and initialise new simulation metrics. */
+simulation_metrics_t *new_simulation_metrics();
+/* Record the metrics of a finished process. Does nothing if the simulation
+ * metrics are NULL.
+ */
+void record_process_metrics(process_metrics_t *metrics,
+    simulation_metrics_t *sim_metrics);
+/* Print mean, p50, p95, p99 and max turnaround and response times, mean and
+ * max wait time and swap count, and throughput (processes finished per time
+ * unit over the simulation's finish time).
+ */
+void print_simulation_metrics(simulation_metrics_t *sim_metrics,
+    int finish_time, FILE *fp);
+/* Print the distribution of a set of times, sorting them. */
+void print_times_distribution(char name[], int *times, int len, FILE *fp);
+/* Get the nearest rank percentile of sorted times. */
+int get_times_percentile(int *sorted_times, int len, int percentile);
+/* Compare ints for qsort. */
+int compare_times(const void *a, const void *b);
+/* Free all memory allocated for simulation metrics. */
+void free_simulation_metrics(simulation_metrics_t *sim_metrics);
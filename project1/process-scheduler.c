@@ -9,49 +9,67 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "object-pool.h"
+#include "event-log.h"
 #include "memory-management.h"
+#include "eviction-policy.h"
+#include "paged-memory.h"
 #include "process-data-file-parser.h"
+#include "scheduled-process-source.h"
+#include "process-metrics.h"
 #include "process-scheduler.h"
+#include "scheduling-policy.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Function definitions. ///////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 process_control_block_t *new_process_control_block(int process_id,
-    int memory_size, int job_time, process_memories_list_t *proc_mems_list)
+    int memory_size, int job_time, process_memories_list_t *proc_mems_list,
+    object_pool_t *pcb_pool)
 {
     process_control_block_t *pcb;
 
-    // Allocate memory for pcb and error check.
-    pcb = (process_control_block_t*)malloc(sizeof(process_control_block_t));
-    if (pcb == NULL)
-    {
-        perror("malloc");
-        exit(1);
-    }
+    // Allocate pcb from the pool.
+    pcb = (process_control_block_t*)allocate_from_object_pool(pcb_pool);
 
     // Set pcb.
     pcb->next = NULL;
+    pcb->prev = NULL;
     pcb->process_id = process_id;
     pcb->process_state = ready;
-    pcb->process_memory = new_process_memory(memory_size, process_id);
+    pcb->process_memory = new_process_memory(memory_size, process_id, proc_mems_list);
     add_process_memory_to_process_memories_list(pcb->process_memory, proc_mems_list);
     pcb->priority = 1;
     pcb->job_time = job_time;
     pcb->burst_time = 0;
     pcb->cpu_time = 0;
+    pcb->cpu = NO_CPU;
+    reset_process_metrics(&pcb->metrics, 0);
+    pcb->tickets = LOTTERY_TICKETS;
+    pcb->vruntime = 0;
+    pcb->tree_left = NULL;
+    pcb->tree_right = NULL;
+    pcb->tree_parent = NULL;
+    pcb->tree_red = 0;
 
     return pcb;
 }
 
 process_control_block_t *new_process_control_block_by_scheduled_process(
-    scheduled_process_t *sp, process_memories_list_t *proc_mems_list)
+    scheduled_process_t *sp, process_memories_list_t *proc_mems_list,
+    object_pool_t *pcb_pool)
 {
-    return new_process_control_block(
+    process_control_block_t *pcb = new_process_control_block(
         sp->process_id,
         sp->memory_size,
         sp->job_time,
-        proc_mems_list
+        proc_mems_list,
+        pcb_pool
         );
+    pcb->metrics.arrival_time = sp->start_time;
+    return pcb;
 }
 
 pcbs_queue_t *new_pcbs_queue()
@@ -68,6 +86,8 @@ pcbs_queue_t *new_pcbs_queue()
 
     // Set pcb queue.
     pcbs_queue->head = NULL;
+    pcbs_queue->tail = NULL;
+    pcbs_queue->len = 0;
 
     return pcbs_queue;
 }
@@ -79,61 +99,94 @@ pcbs_queue_t *new_pcbs_list()
 
 void add_pcb_to_pcbs_queue(process_control_block_t *pcb, pcbs_queue_t *pcbs_queue)
 {
-    process_control_block_t *prev_pcb, *curr_pcb;
+    process_control_block_t *prev_pcb;
+
+    /* Iterate from end of queue to the last pcb that pcb does not go before,
+     * so appending (the common case) takes constant time.
+     *
+     * pcb goes before prev_pcb if pcb's priority is higher (smaller value)
+     * than prev_pcb's priority, OR if pcb's priority is equal to prev_pcb's
+     * priority AND pcb's process id is higher (smaller value) than prev_pcb's
+     * process id.
+     */
+    prev_pcb = pcbs_queue->tail;
+    while (prev_pcb != NULL &&
+        (pcb->priority < prev_pcb->priority ||
+        (pcb->priority == prev_pcb->priority && pcb->process_id < prev_pcb->process_id)))
+    {
+        prev_pcb = prev_pcb->prev;
+    }
+
+    insert_pcb_after_in_pcbs_queue(pcb, prev_pcb, pcbs_queue);
+
+    return;
+}
 
-    // If queue is empty, add pcb as head.
-    if (pcbs_queue->head == NULL)
+void insert_pcb_after_in_pcbs_queue(process_control_block_t *pcb,
+    process_control_block_t *prev_pcb, pcbs_queue_t *pcbs_queue)
+{
+    // Connect to previous pcb, or reassign queue's head if there is none.
+    pcb->prev = prev_pcb;
+    if (prev_pcb == NULL)
     {
+        pcb->next = pcbs_queue->head;
         pcbs_queue->head = pcb;
     }
-    // Add process to queue according to priority then pid.
     else
     {
-        // Iterate to end of queue.
-        prev_pcb = NULL;
-        curr_pcb = pcbs_queue->head;
-        while (curr_pcb != NULL)
-        {
-            // Add process to sorted position.
-            /* If pcb's priority is higher (smaller value) than curr_pcb's
-             * priority, then insert before curr_pcb.
-             *
-             * OR if pcb's priority is equal to curr_pcb's priority AND if pcb's
-             * process id is higher (smaller value) than curr_pcb's process id,
-             * then insert before curr_pcb.
-             */
-            if (pcb->priority < curr_pcb->priority ||
-                (pcb->priority == curr_pcb->priority && pcb->process_id < curr_pcb->process_id))
-            {
-                // Connect and reassign queue's head.
-                if (curr_pcb == pcbs_queue->head)
-                {
-                    pcbs_queue->head = pcb;
-                    pcb->next = curr_pcb;
-                }
-                // Insert into queue.
-                else
-                {
-                    prev_pcb->next = pcb;
-                    pcb->next = curr_pcb;
-                }
-
-                break;
-            }
+        pcb->next = prev_pcb->next;
+        prev_pcb->next = pcb;
+    }
 
-            prev_pcb = curr_pcb;
-            curr_pcb = curr_pcb->next;
-        }
-        /* Append to end of queue if we iterated through the entire list and
-         * found no pcbs that goes lower than the one we want to insert.
-         */
-        if (curr_pcb == NULL)
-        {
-            prev_pcb->next = pcb;
-            pcb->next = curr_pcb;
-        }
+    // Connect to next pcb, or reassign queue's tail if there is none.
+    if (pcb->next == NULL)
+    {
+        pcbs_queue->tail = pcb;
+    }
+    else
+    {
+        pcb->next->prev = pcb;
+    }
+
+    pcbs_queue->len++;
+
+    return;
+}
+
+void remove_pcb_from_pcbs_queue(process_control_block_t *pcb,
+    pcbs_queue_t *pcbs_queue)
+{
+    // Unlink from previous pcb, reassigning queue's head if first.
+    if (pcb->prev == NULL)
+    {
+        pcbs_queue->head = pcb->next;
+    }
+    else
+    {
+        pcb->prev->next = pcb->next;
+    }
+
+    // Unlink from next pcb, reassigning queue's tail if last.
+    if (pcb->next == NULL)
+    {
+        pcbs_queue->tail = pcb->prev;
+    }
+    else
+    {
+        pcb->next->prev = pcb->prev;
     }
 
+    pcb->next = pcb->prev = NULL;
+    pcbs_queue->len--;
+
+    return;
+}
+
+void move_pcb_to_pcbs_queue(process_control_block_t *pcb,
+    pcbs_queue_t *from_pcbs_queue, pcbs_queue_t *to_pcbs_queue)
+{
+    remove_pcb_from_pcbs_queue(pcb, from_pcbs_queue);
+    append_pcb_to_pcbs_list(pcb, to_pcbs_queue);
     return;
 }
 
@@ -142,35 +195,14 @@ process_control_block_t *pop_front_pcb_from_pcbs_queue(pcbs_queue_t *pcbs_queue)
     process_control_block_t *pcb = pcbs_queue->head;
     if (pcb != NULL)
     {
-        pcbs_queue->head = pcb->next;
+        remove_pcb_from_pcbs_queue(pcb, pcbs_queue);
     }
     return pcb;
 }
 
 void append_pcb_to_pcbs_list(process_control_block_t *pcb, pcbs_queue_t *pcbs_list)
 {
-    process_control_block_t *prev_pcb, *curr_pcb;
-
-    // If list is empty, add pcb as head.
-    if (pcbs_list->head == NULL)
-    {
-        pcbs_list->head = pcb;
-    }
-    // Add process to list.
-    else
-    {
-        // Iterate to end of list.
-        prev_pcb = NULL;
-        curr_pcb = pcbs_list->head;
-        while (curr_pcb != NULL)
-        {
-            prev_pcb = curr_pcb;
-            curr_pcb = curr_pcb->next;
-        }
-        // Append to end of list.
-        prev_pcb->next = pcb;
-        pcb->next = curr_pcb;
-    }
+    insert_pcb_after_in_pcbs_queue(pcb, pcbs_list->tail, pcbs_list);
     return;
 }
 
@@ -179,24 +211,37 @@ process_control_block_t *pop_front_pcb_from_pcbs_list(pcbs_queue_t *pcbs_list)
     return pop_front_pcb_from_pcbs_queue(pcbs_list);
 }
 
-void load_pcb(process_control_block_t *pcb, int time,
+int load_pcb(process_control_block_t *pcb, int time,
     process_memories_list_t *proc_mems_list,
     free_memory_segments_list_t *mem_segs_list)
 {
     // If process is not in main memory, swap it into main memory.
     if (is_process_memory_in_disk(pcb->process_memory))
     {
-        swap_in_process_memory(
+        if (!swap_in_process_memory(
             pcb->process_memory, time, proc_mems_list, mem_segs_list
-            );
+            ))
+        {
+            return 0;
+        }
+    }
+    // Otherwise it is being used again while in main memory.
+    else
+    {
+        access_process_memory(pcb->process_memory, proc_mems_list);
     }
 
     // Set pcb.
     pcb->next = NULL;
+    pcb->prev = NULL;
     pcb->process_state = running;
     pcb->burst_time = 0;
+    if (pcb->metrics.first_run_time == NOT_RUN)
+    {
+        pcb->metrics.first_run_time = time;
+    }
 
-    return;
+    return 1;
 }
 
 void run_pcb(process_control_block_t *pcb)
@@ -207,6 +252,14 @@ void run_pcb(process_control_block_t *pcb)
     return;
 }
 
+void run_pcb_for(process_control_block_t *pcb, int steps)
+{
+    // Set pcb - add time steps to burst time and cpu time.
+    pcb->burst_time += steps;
+    pcb->cpu_time += steps;
+    return;
+}
+
 void preempt_pcb(process_control_block_t *pcb)
 {
     // Set pcb.
@@ -214,28 +267,44 @@ void preempt_pcb(process_control_block_t *pcb)
     return;
 }
 
-void ready_and_decrease_priority_pcb(process_control_block_t *pcb)
+void ready_and_decrease_priority_pcb(process_control_block_t *pcb,
+    scheduler_options_t *options)
 {
-    // Set pcb - lower priority.
-    pcb->priority = (pcb->priority + 1 > MIN_PRIORITY) ? MIN_PRIORITY : pcb->priority + 1;
+    // Set pcb - lower priority, down to the lowest priority level.
+    pcb->priority = (pcb->priority + 1 > options->levels) ? options->levels : pcb->priority + 1;
     pcb->process_state = ready;
     pcb->burst_time = 0;
     return;
 }
 
-void terminate_pcb(process_control_block_t *pcb,
+void terminate_pcb(process_control_block_t *pcb, int time,
+    process_memories_list_t *proc_mems_list,
     free_memory_segments_list_t *mem_segs_list)
 {
     // Swap out mememory.
     if (!is_process_memory_in_disk(pcb->process_memory))
     {
         swap_out_process_memory_by_process_memory(
-            pcb->process_memory, mem_segs_list
+            pcb->process_memory, proc_mems_list, mem_segs_list
             );
     }
 
+    /* A process is waiting whenever it is not running from arrival to
+     * completion, including while it is moved between CPUs.
+     */
+    pcb->metrics.completion_time = time;
+    pcb->metrics.wait_time = time - pcb->metrics.arrival_time - pcb->cpu_time;
+    pcb->metrics.swap_count = pcb->process_memory->swap_count;
+
+    /* Release process memory, so only live processes are kept and memory use
+     * is bounded however long the simulation runs.
+     */
+    remove_process_memory(pcb->process_memory, proc_mems_list, mem_segs_list);
+    pcb->process_memory = NULL;
+
     // Set pcb.
     pcb->next = NULL;
+    pcb->prev = NULL;
     pcb->process_state = terminated;
 
     return;
@@ -247,65 +316,161 @@ int is_pcb_finished(process_control_block_t *pcb)
 }
 
 void print_simulation_status(int time, process_control_block_t *running,
-    process_memories_list_t *process_memories_list,
-    free_memory_segments_list_t *free_list, int memsize)
+    int cpu_id, process_memories_list_t *process_memories_list,
+    free_memory_segments_list_t *free_list, scheduler_options_t *options,
+    simulation_summary_t *summary)
+{
+    memory_stats_t stats;
+    get_memory_stats(process_memories_list, free_list, &stats);
+    print_simulation_status_by_stats(time, running->process_id, cpu_id,
+        &stats, options, summary);
+    return;
+}
+
+void print_simulation_status_by_stats(int time, int process_id, int cpu_id,
+    memory_stats_t *stats, scheduler_options_t *options,
+    simulation_summary_t *summary)
 {
+    int memsize = options->memsize;
+    int numprocesses = stats->resident_count;
+    int numholes = stats->holes_count;
+
     // Calculate memory usage as a percentage.
-    int memusagesize = get_process_memories_list_not_in_disk_size(process_memories_list);
+    int memusagesize = stats->resident_size;
     int memusageproportion = 100 * memusagesize;
     memusageproportion = memusageproportion / memsize + (memusageproportion % memsize != 0);
 
-    printf("time %d, %d running, numprocesses=%d, numholes=%d, memusage=%d%%\n",
-        time,
-        running->process_id,
-        get_process_memories_list_not_in_disk_count(process_memories_list),
-        get_free_memory_segments_list_count(free_list),
-        memusageproportion
-        );
+    // Calculate internal and external fragmentation as percentages.
+    long internalfrag = 100L * stats->internal_size;
+    internalfrag = internalfrag / memsize + (internalfrag % memsize != 0);
+    long externalfrag = 100L * (stats->free_size - stats->largest_hole_size);
+    externalfrag = (stats->free_size > 0) ?
+        externalfrag / stats->free_size + (externalfrag % stats->free_size != 0) : 0;
+
+    // Record in summary.
+    summary->context_switches++;
+    summary->max_processes = (numprocesses > summary->max_processes) ? numprocesses : summary->max_processes;
+    summary->max_holes = (numholes > summary->max_holes) ? numholes : summary->max_holes;
+    summary->max_memusage = (memusageproportion > summary->max_memusage) ? memusageproportion : summary->max_memusage;
+    summary->max_internal_frag = (internalfrag > summary->max_internal_frag) ? internalfrag : summary->max_internal_frag;
+    summary->max_external_frag = (externalfrag > summary->max_external_frag) ? externalfrag : summary->max_external_frag;
+
+    // Only name the CPU if there is more than one.
+    if (options->output != NULL && options->cpus > 1)
+    {
+        fprintf(options->output,
+            "time %d, %d running on cpu %d, numprocesses=%d, numholes=%d, memusage=%d%%\n",
+            time,
+            process_id,
+            cpu_id,
+            numprocesses,
+            numholes,
+            memusageproportion
+            );
+    }
+    else if (options->output != NULL)
+    {
+        fprintf(options->output,
+            "time %d, %d running, numprocesses=%d, numholes=%d, memusage=%d%%\n",
+            time,
+            process_id,
+            numprocesses,
+            numholes,
+            memusageproportion
+            );
+    }
     return;
 }
 
-int check_scheduled_processes(scheduled_process_t *sps[], int spi, int time,
-    pcbs_queue_t *ready_queue, process_memories_list_t *proc_mems_list)
+void print_simulation_finished(int time, scheduler_options_t *options,
+    simulation_summary_t *summary)
 {
-    scheduled_process_t *next_scheduled_process = sps[spi];
+    // Record in summary.
+    summary->finish_time = time;
+
+    if (options->output != NULL)
+    {
+        fprintf(options->output, "time %d, simulation finished.\n", time);
+    }
+    if (options->output != NULL && options->page_size > 0)
+    {
+        fprintf(options->output,
+            "pagefaults=%ld, pageouts=%ld, tlbhits=%ld, tlbmisses=%ld, tlbhitrate=%.2f%%\n",
+            summary->page_faults,
+            summary->page_outs,
+            summary->tlb_hits,
+            summary->tlb_misses,
+            (summary->tlb_hits + summary->tlb_misses > 0) ?
+                100.0 * summary->tlb_hits / (summary->tlb_hits + summary->tlb_misses) : 0.0
+            );
+    }
+    if (options->output != NULL && options->page_size == 0 &&
+        options->compaction_threshold != NO_COMPACTION)
+    {
+        fprintf(options->output,
+            "compactions=%d, compactedsize=%ld\n",
+            summary->compactions,
+            summary->compacted_size
+            );
+    }
+    if (options->output != NULL && options->page_size == 0 &&
+        options->fit_policy == buddy_fit)
+    {
+        fprintf(options->output,
+            "maxinternalfrag=%d%%, maxexternalfrag=%d%%\n",
+            summary->max_internal_frag,
+            summary->max_external_frag
+            );
+    }
+    return;
+}
+
+void reset_simulation_summary(simulation_summary_t *summary)
+{
+    summary->context_switches = 0;
+    summary->max_processes = 0;
+    summary->max_holes = 0;
+    summary->max_memusage = 0;
+    summary->finish_time = 0;
+    summary->max_internal_frag = 0;
+    summary->max_external_frag = 0;
+    summary->compactions = 0;
+    summary->compacted_size = 0;
+    summary->page_faults = 0;
+    summary->page_outs = 0;
+    summary->tlb_hits = 0;
+    summary->tlb_misses = 0;
+    return;
+}
+
+void check_scheduled_processes(scheduled_process_source_t *source,
+    int time, cpu_t cpus[], scheduler_options_t *options,
+    process_memories_list_t *proc_mems_list, object_pool_t *pcb_pool)
+{
+    scheduled_process_t *sp;
 
     /* If next scheduled process exists and it is time to "start/load" process,
      * add it to queue.
      */
-    while (next_scheduled_process != NULL &&
-        next_scheduled_process->start_time <= time)
+    while ((sp = peek_scheduled_process(source)) != NULL && sp->start_time <= time)
     {
-        /* Create a new pcb and add it to pcbs queue and add its process memory
-         * to process memories list.
+        /* Create a new pcb and enqueue it and add its process memory to
+         * process memories list.
          */
-        append_pcb_to_pcbs_list(
+        enqueue_pcb_on_cpu(
             new_process_control_block_by_scheduled_process(
-                next_scheduled_process,
-                proc_mems_list
+                sp, proc_mems_list, pcb_pool
                 ),
-            ready_queue);
+            get_least_loaded_cpu(cpus, options->cpus), options);
 
-        spi++;
-        next_scheduled_process = sps[spi];
+        take_scheduled_process(source, NULL);
     }
 
-    return spi;
+    return;
 }
 
 void free_pcbs_queue(pcbs_queue_t *pcbs_queue)
 {
-    process_control_block_t *curr_pcb, *next_pcb;
-
-    // Iterate over queue and free each pcb.
-    curr_pcb = (pcbs_queue != NULL) ? pcbs_queue->head : NULL;
-    while (curr_pcb != NULL)
-    {
-        next_pcb = curr_pcb->next;
-        free(curr_pcb);
-        curr_pcb = next_pcb;
-    }
-
     free(pcbs_queue);
 
     return;
@@ -317,240 +482,638 @@ void free_pcbs_list(pcbs_queue_t *pcbs_list)
     return;
 }
 
-int get_quantum_by_pcb(process_control_block_t *pcb)
+int get_quantum_by_pcb(process_control_block_t *pcb,
+    scheduler_options_t *options)
 {
-    switch (pcb->priority)
-    {
-        case 1:
-            return Q1_QUANTUM;
-            break;
-        case 2:
-            return Q2_QUANTUM;
-            break;
-        case 3:
-            return Q3_QUANTUM;
-            break;
-        default:
-            return Q3_QUANTUM;
-            break;
-    }
+    // Look up quantum of pcb's priority level, the lowest level if beyond.
+    int level = (pcb->priority > options->levels) ? options->levels : pcb->priority;
+    return options->quanta[level - 1];
 }
 
-int is_quantum_exhausted_by_pcb(process_control_block_t *pcb)
+int is_quantum_exhausted_by_pcb(process_control_block_t *pcb,
+    scheduler_options_t *options)
 {
-    return (pcb->burst_time >= get_quantum_by_pcb(pcb));
+    return (pcb->burst_time >= get_quantum_by_pcb(pcb, options));
 }
 
-void fcfs_scheduler_runner(char filename[], int memsize)
+int get_remaining_job_time_by_pcb(process_control_block_t *pcb)
 {
-    int time = 0;  // Time steps.
+    /* A process always runs for at least one time step once loaded, even if
+     * its job time is zero.
+     */
+    int remaining = pcb->job_time - pcb->cpu_time;
+    return (remaining < 1) ? 1 : remaining;
+}
 
-    // Currently executing process.
-    process_control_block_t *running = NULL;
-    // Processes that need to be executed.
-    pcbs_queue_t *ready_queue = new_pcbs_queue(),
-    // Processes that finished executing.
-        *terminated_list = new_pcbs_list();
+int get_remaining_quantum_by_pcb(process_control_block_t *pcb,
+    scheduler_options_t *options)
+{
+    int remaining = get_quantum_by_pcb(pcb, options) - pcb->burst_time;
+    return (remaining < 1) ? 1 : remaining;
+}
 
-    // Pointer to file holding scheduled processes.
-    FILE *fp;
-    // Scheduled processes.
-    scheduled_process_t **scheduled_processes;
-    // Index of scheduled processes.
-    int spi = 0;
+void boost_pcbs_queues(pcbs_queue_t *ready_qs[], int levels)
+{
+    int i;
 
-    // Load scheduled processes from file.
-    fp = fopen(filename, "r");
-    if (fp == NULL)
+    /* Move pcbs of each lower priority level, in level order, to the end of the
+     * highest priority level queue.
+     */
+    for (i = 1; i < levels; i++)
     {
-        perror("fopen");
-        exit(1);
+        while (ready_qs[i]->head != NULL)
+        {
+            ready_qs[i]->head->priority = 1;
+            move_pcb_to_pcbs_queue(ready_qs[i]->head, ready_qs[i], ready_qs[0]);
+        }
     }
-    scheduled_processes = parse_process_data_file(fp);
-    fclose(fp);
-    fp = NULL;
 
-    // Process memory images list.
-    process_memories_list_t *process_memories_list = new_process_memories_list();
-    // Free memory segments list.
-    free_memory_segments_list_t *free_list = new_free_memory_segments_list(memsize);
+    return;
+}
 
-    while (1)
+cpu_t *new_cpus(int len, int levels)
+{
+    int i, j;
+    cpu_t *cpus;
+
+    // Allocate memory for CPUs and error check.
+    cpus = (cpu_t*)malloc(sizeof(cpu_t) * len);
+    if (cpus == NULL)
     {
-        // Create and add new processes from scheduled processes if need be.
-        spi = check_scheduled_processes(
-            scheduled_processes, spi, time, ready_queue, process_memories_list
-            );
+        perror("malloc");
+        exit(1);
+    }
 
-        // No currently executing process, load next process in queue.
-        if (running == NULL)
+    // Set CPUs, each with one ready queue per priority level.
+    for (i = 0; i < len; i++)
+    {
+        cpus[i].id = i;
+        cpus[i].running = NULL;
+        cpus[i].waiting = 0;
+        cpus[i].levels = levels;
+        cpus[i].ready_heap = NULL;
+        cpus[i].ready_heap_len = 0;
+        cpus[i].ready_heap_max_len = 0;
+        cpus[i].ready_tree = NULL;
+        cpus[i].min_vruntime = 0;
+        cpus[i].tickets = 0;
+        cpus[i].random_state = LOTTERY_SEED + i;
+        cpus[i].lottery_pcbs = NULL;
+        cpus[i].lottery_tree = NULL;
+        cpus[i].lottery_len = 0;
+        cpus[i].lottery_max_len = 0;
+        cpus[i].migration_time = 0;
+        cpus[i].tlb = NULL;
+        cpus[i].ready_qs = (pcbs_queue_t**)malloc(sizeof(pcbs_queue_t*) * levels);
+        if (cpus[i].ready_qs == NULL)
         {
-            running = pop_front_pcb_from_pcbs_queue(ready_queue);
+            perror("malloc");
+            exit(1);
+        }
+        for (j = 0; j < levels; j++)
+        {
+            cpus[i].ready_qs[j] = new_pcbs_queue();
+        }
+    }
 
-            // Load next process.
-            if (running != NULL)
-            {
-                load_pcb(running, time, process_memories_list, free_list);
-                print_simulation_status(time, running, process_memories_list, free_list, memsize);
-            }
-            /* Still no process running. Check if there are more incoming. If
-             * break out of loop and exit.
-             */
-            else if (ready_queue->head == NULL && scheduled_processes[spi] == NULL)
-            {
-                break;
-            }
+    return cpus;
+}
+
+void free_cpus(cpu_t cpus[], int len)
+{
+    int i, j;
+
+    for (i = 0; i < len; i++)
+    {
+        for (j = 0; j < cpus[i].levels; j++)
+        {
+            free_pcbs_queue(cpus[i].ready_qs[j]);
         }
+        free(cpus[i].ready_qs);
+        free(cpus[i].ready_heap);
+        free(cpus[i].lottery_pcbs);
+        free(cpus[i].lottery_tree);
+        free_tlb(cpus[i].tlb);
+    }
+    free(cpus);
+
+    return;
+}
+
+void enqueue_pcb_on_cpu(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    options->scheduling_policy->enqueue(pcb, cpu, options);
+    cpu->waiting++;
+    return;
+}
+
+int get_cpu_load(cpu_t *cpu)
+{
+    return (cpu->running != NULL) + cpu->waiting;
+}
+
+cpu_t *get_least_loaded_cpu(cpu_t cpus[], int len)
+{
+    int i;
+    cpu_t *least = &cpus[0];
+    int least_load = get_cpu_load(least);
 
-        // Execute process for one time step.
-        if (running != NULL)
+    for (i = 1; i < len && least_load > 0; i++)
+    {
+        if (get_cpu_load(&cpus[i]) < least_load)
         {
-            run_pcb(running);
+            least = &cpus[i];
+            least_load = get_cpu_load(least);
         }
+    }
 
-        // Next time step.
-        //sleep(1);
-        time++;
+    return least;
+}
 
-        /* Current executing process finished, terminate it and make it no
-         * currently executing process.
-         */
-        if (running != NULL && is_pcb_finished(running))
+process_control_block_t *pop_next_pcb_from_cpu(cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    if (cpu->waiting == 0)
+    {
+        return NULL;
+    }
+    cpu->waiting--;
+    return options->scheduling_policy->pick_next(cpu, options);
+}
+
+process_control_block_t *steal_pcb_for_cpu(cpu_t *cpu, cpu_t cpus[],
+    scheduler_options_t *options, cpu_t **from_cpu)
+{
+    int i;
+    int most_waiting = 0;
+
+    // Find the other CPU with the most waiting processes.
+    *from_cpu = NULL;
+    for (i = 0; i < options->cpus; i++)
+    {
+        if (&cpus[i] != cpu && cpus[i].waiting > most_waiting)
         {
-            terminate_pcb(running, free_list);
-            append_pcb_to_pcbs_list(running, terminated_list);
-            running = NULL;
+            *from_cpu = &cpus[i];
+            most_waiting = cpus[i].waiting;
         }
     }
 
-    // Print end simulation message.
-    printf("time %d, simulation finished.\n", time);
+    return (*from_cpu != NULL) ? pop_next_pcb_from_cpu(*from_cpu, options) : NULL;
+}
+
+void dispatch_cpu(cpu_t *cpu, cpu_t cpus[], int time,
+    process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list, scheduler_options_t *options,
+    simulation_summary_t *summary)
+{
+    cpu_t *from_cpu = cpu;
+    process_control_block_t *pcb;
+    long compacted_size = mem_segs_list->compacted_size;
+    double compaction_time;
+
+    // Run its own next process, otherwise steal one from a busier CPU.
+    pcb = pop_next_pcb_from_cpu(cpu, options);
+    if (pcb == NULL)
+    {
+        pcb = steal_pcb_for_cpu(cpu, cpus, options, &from_cpu);
+    }
+    if (pcb == NULL)
+    {
+        return;
+    }
+
+    /* Memory is held by processes running on other CPUs, so put it back first
+     * in line and wait for one of them to stop.
+     */
+    if (!load_pcb(pcb, time, proc_mems_list, mem_segs_list))
+    {
+        options->scheduling_policy->put_back(pcb, from_cpu, options);
+        from_cpu->waiting++;
+        return;
+    }
+
+    // Moving in a process that last ran on another CPU takes time.
+    cpu->migration_time = (pcb->cpu != NO_CPU && pcb->cpu != cpu->id) ? options->migration_cost : 0;
+
+    // So does copying memory, if main memory was compacted to fit it.
+    compaction_time = options->compaction_cost *
+        (mem_segs_list->compacted_size - compacted_size);
+    cpu->migration_time += (int)compaction_time + ((int)compaction_time < compaction_time);
+    pcb->cpu = cpu->id;
+    cpu->running = pcb;
+
+    // Keep its memory from being swapped out by other CPUs while it runs.
+    if (options->cpus > 1)
+    {
+        pin_process_memory(pcb->process_memory, proc_mems_list);
+    }
+
+    log_simulation_event(options->event_log, load_event,
+        pcb->process_id, pcb->process_memory->start_address, pcb->priority);
+    print_simulation_status(time, pcb, cpu->id, proc_mems_list, mem_segs_list,
+        options, summary);
+
+    return;
+}
+
+int get_remaining_time_by_cpu(cpu_t *cpu, scheduler_options_t *options)
+{
+    int steps = get_remaining_job_time_by_pcb(cpu->running);
+    int slice = options->scheduling_policy->tick(cpu, options);
+    return cpu->migration_time + ((slice < steps) ? slice : steps);
+}
 
-    // Free allocated memory.
-    free_pcbs_queue(ready_queue);
-    free_pcbs_list(terminated_list);
-    free_scheduled_processes(scheduled_processes);
-    free_free_memory_segments_list(free_list);
-    free_process_memories_list(process_memories_list);
+void run_cpu_for(cpu_t *cpu, int steps)
+{
+    // Finish moving the process in before running it.
+    int moving = (cpu->migration_time < steps) ? cpu->migration_time : steps;
+    cpu->migration_time -= moving;
+    if (steps > moving)
+    {
+        run_pcb_for(cpu->running, steps - moving);
+    }
+    return;
+}
+
+void touch_cpus_pages(cpu_t cpus[], int time, int steps,
+    process_memories_list_t *proc_mems_list, scheduler_options_t *options)
+{
+    int i, step;
+
+    for (step = 0; step < steps; step++)
+    {
+        set_event_log_time(options->event_log, time + step);
+        for (i = 0; i < options->cpus; i++)
+        {
+            // Nothing is touched while the process is still being moved in.
+            if (cpus[i].running != NULL && step >= cpus[i].migration_time)
+            {
+                touch_process_memory_page(
+                    cpus[i].running->process_memory, cpus[i].tlb, proc_mems_list
+                    );
+            }
+        }
+    }
 
     return;
 }
 
-void multi_scheduler_runner(char filename[], int memsize)
+void record_paging_summary(cpu_t cpus[],
+    process_memories_list_t *proc_mems_list, scheduler_options_t *options,
+    simulation_summary_t *summary)
 {
     int i;
 
-    int time = 0;  // Time steps.
+    summary->page_faults = proc_mems_list->page_frames->page_faults;
+    summary->page_outs = proc_mems_list->page_frames->page_outs;
+    for (i = 0; i < options->cpus; i++)
+    {
+        summary->tlb_hits += cpus[i].tlb->hits;
+        summary->tlb_misses += cpus[i].tlb->misses;
+    }
+
+    return;
+}
+
+void preempt_cpu(cpu_t *cpu, process_memories_list_t *proc_mems_list,
+    scheduler_options_t *options)
+{
+    process_control_block_t *pcb = cpu->running;
+
+    // Let its memory be swapped out again and re-add it to wait.
+    unpin_process_memory(pcb->process_memory, proc_mems_list);
+    options->scheduling_policy->on_preempt(pcb, cpu, options);
+    log_simulation_event(options->event_log, preempt_event,
+        pcb->process_id, NO_EVENT_VALUE, pcb->priority);
+    enqueue_pcb_on_cpu(pcb, cpu, options);
+    cpu->running = NULL;
+
+    return;
+}
+
+int parse_quanta(char str[], int **quanta)
+{
+    int levels = 0;
+    char *token, *end;
+
+    // Allocate array for at most one quantum per character and error check.
+    *quanta = (int*)malloc(sizeof(int) * (strlen(str) + 1));
+    if (*quanta == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Parse comma separated quanta, all of which must be positive.
+    token = str;
+    while (*token != '\0')
+    {
+        (*quanta)[levels] = (int)strtol(token, &end, 10);
+        if (end == token || (*quanta)[levels] < 1 || (*end != ',' && *end != '\0'))
+        {
+            free(*quanta);
+            *quanta = NULL;
+            return 0;
+        }
+        levels++;
+        token = (*end == ',') ? end + 1 : end;
+    }
+
+    if (levels == 0)
+    {
+        free(*quanta);
+        *quanta = NULL;
+    }
+
+    return levels;
+}
 
-    // Currently executing process.
-    process_control_block_t *running = NULL;
-    // Processes that need to be executed.
-    pcbs_queue_t *ready_qs[MIN_PRIORITY];
-    for (i = 0; i < MIN_PRIORITY; i++)
+int parse_fit_policy(char str[], enum fit_policy_t *fit_policy)
+{
+    if (strcmp("first", str) == 0)
+    {
+        *fit_policy = first_fit;
+    }
+    else if (strcmp("best", str) == 0)
     {
-        ready_qs[i] = new_pcbs_queue();
+        *fit_policy = best_fit;
     }
-    // Processes that finished executing.
-    pcbs_queue_t *terminated_list = new_pcbs_list();
+    else if (strcmp("worst", str) == 0)
+    {
+        *fit_policy = worst_fit;
+    }
+    else if (strcmp("buddy", str) == 0)
+    {
+        *fit_policy = buddy_fit;
+    }
+    else
+    {
+        return 0;
+    }
+    return 1;
+}
 
-    // Pointer to file holding scheduled processes.
-    FILE *fp;
-    // Scheduled processes.
-    scheduled_process_t **scheduled_processes;
-    // Index of scheduled processes.
-    int spi = 0;
+void scheduler_run(scheduled_process_source_t *source,
+    scheduler_options_t *options, simulation_summary_t *summary)
+{
+    scheduler_state_t *state = new_scheduler_state(options);
+
+    reset_simulation_summary(summary);
+    run_scheduler_state(source, state, NO_STOP_TIME, options, summary);
+    finish_scheduler_state(state, options, summary);
+    free_scheduler_state(state);
+
+    return;
+}
 
-    // Load scheduled processes from file.
-    fp = fopen(filename, "r");
-    if (fp == NULL)
+scheduler_state_t *new_scheduler_state(scheduler_options_t *options)
+{
+    scheduler_state_t *state;
+    int i;
+
+    // Allocate memory for state and error check.
+    state = (scheduler_state_t*)malloc(sizeof(scheduler_state_t));
+    if (state == NULL)
     {
-        perror("fopen");
+        perror("malloc");
         exit(1);
     }
-    scheduled_processes = parse_process_data_file(fp);
-    fclose(fp);
-    fp = NULL;
+    state->time = 0;
+    state->next_boost_time = options->boost_interval;
+
+    // CPUs, each with its executing process and its own ready queues.
+    state->cpus = new_cpus(options->cpus, options->levels);
+    state->cpus_len = options->cpus;
+    // Pool all pcbs are allocated from, freed together at the end.
+    state->pcb_pool = new_object_pool(
+        sizeof(process_control_block_t), PCBS_PER_SLAB
+        );
 
     // Process memory images list.
-    process_memories_list_t *process_memories_list = new_process_memories_list();
+    state->proc_mems_list = new_process_memories_list();
+    set_process_memories_list_eviction_policy(
+        state->proc_mems_list, options->eviction_policy
+        );
+    set_process_memories_list_event_log(state->proc_mems_list, options->event_log);
     // Free memory segments list.
-    free_memory_segments_list_t *free_list = new_free_memory_segments_list(memsize);
+    state->mem_segs_list = new_free_memory_segments_list(options->memsize);
+    set_free_memory_segments_list_fit_policy(
+        state->mem_segs_list, options->fit_policy
+        );
+    set_free_memory_segments_list_compaction_threshold(
+        state->mem_segs_list, options->compaction_threshold
+        );
+    // Or page frames and a tlb for each CPU, if paged.
+    if (options->page_size > 0)
+    {
+        set_process_memories_list_page_frames(
+            state->proc_mems_list,
+            new_page_frames(options->memsize, options->page_size)
+            );
+        for (i = 0; i < options->cpus; i++)
+        {
+            state->cpus[i].tlb = new_tlb(options->tlb_entries, options->tlb_ways);
+        }
+    }
+
+    return state;
+}
+
+int run_scheduler_state(scheduled_process_source_t *source,
+    scheduler_state_t *state, int stop_time, scheduler_options_t *options,
+    simulation_summary_t *summary)
+{
+    int i;
+
+    int time = state->time;  // Time steps.
+    int steps;     // Time steps until the next event.
+    int idle;      // Whether any CPU is idle.
+    const scheduling_policy_t *policy = options->scheduling_policy;
+    int next_boost_time = state->next_boost_time;  // Time of next boost.
+    int finished = 0;
+    process_control_block_t *running;
+    cpu_t *cpus = state->cpus;
+    object_pool_t *pcb_pool = state->pcb_pool;
+    process_memories_list_t *process_memories_list = state->proc_mems_list;
+    free_memory_segments_list_t *free_list = state->mem_segs_list;
 
     while (1)
     {
+        // Stop between events, where the run can be continued from.
+        if (stop_time != NO_STOP_TIME && time >= stop_time)
+        {
+            break;
+        }
+        set_event_log_time(options->event_log, time);
+
+        /* Boost waiting processes back to the highest priority at the start of
+         * every boost interval, so they don't starve.
+         */
+        if (policy->boost != NULL && options->boost_interval > 0 &&
+            time >= next_boost_time)
+        {
+            for (i = 0; i < options->cpus; i++)
+            {
+                policy->boost(&cpus[i], options);
+            }
+            next_boost_time = (time / options->boost_interval + 1) * options->boost_interval;
+        }
+
         // Create and add new processes from scheduled processes if need be.
-        spi = check_scheduled_processes(
-            scheduled_processes, spi, time, ready_qs[1 - 1], process_memories_list
+        check_scheduled_processes(
+            source, time, cpus, options, process_memories_list, pcb_pool
             );
 
-        // No currently executing process, load next process in queue.
-        if (running == NULL)
+        // Preempt running processes for those that just arrived, if need be.
+        for (i = 0; i < options->cpus && policy->preempts_on_arrival; i++)
         {
-            for (i = 1; i <= MIN_PRIORITY && running == NULL; i++)
+            if (cpus[i].running != NULL && cpus[i].migration_time == 0 &&
+                policy->tick(&cpus[i], options) == 0)
             {
-                running = pop_front_pcb_from_pcbs_queue(ready_qs[i - 1]);
+                preempt_cpu(&cpus[i], process_memories_list, options);
             }
+        }
 
-            // Load next process.
-            if (running != NULL)
+        // Load the next process on each CPU without a currently executing one.
+        for (i = 0; i < options->cpus; i++)
+        {
+            if (cpus[i].running == NULL)
             {
-                load_pcb(running, time, process_memories_list, free_list);
-                print_simulation_status(time, running, process_memories_list, free_list, memsize);
+                dispatch_cpu(&cpus[i], cpus, time, process_memories_list,
+                    free_list, options, summary);
             }
-            /* Still no process running. Check if there are more incoming. If
-             * break out of loop and exit.
-             */
-            else if (scheduled_processes[spi] == NULL)
+        }
+
+        /* Execute processes until the next event on any CPU (one finishes or
+         * is preempted, a boost is due, or a process arrives for an idle CPU or
+         * to preempt with).
+         */
+        steps = INT_MAX;
+        idle = 0;
+        for (i = 0; i < options->cpus; i++)
+        {
+            if (cpus[i].running == NULL)
+            {
+                idle = 1;
+            }
+            else if (get_remaining_time_by_cpu(&cpus[i], options) < steps)
             {
-                break;
+                steps = get_remaining_time_by_cpu(&cpus[i], options);
             }
         }
 
-        // Execute process for one time step.
-        if (running != NULL)
+        /* No process running. Check if there are more incoming. If break out
+         * of loop and exit.
+         */
+        if (steps == INT_MAX && peek_scheduled_process(source) == NULL)
+        {
+            finished = 1;
+            break;
+        }
+        // Nothing to run, skip ahead to the next arrival.
+        else if (steps == INT_MAX)
         {
-            run_pcb(running);
+            time = peek_scheduled_process(source)->start_time;
+            continue;
         }
 
-        // Next time step.
-        //sleep(1);
-        time++;
+        if (policy->boost != NULL && options->boost_interval > 0 &&
+            next_boost_time - time < steps)
+        {
+            steps = next_boost_time - time;
+        }
+        if ((idle || policy->preempts_on_arrival) &&
+            peek_scheduled_process(source) != NULL &&
+            peek_scheduled_process(source)->start_time - time < steps)
+        {
+            steps = peek_scheduled_process(source)->start_time - time;
+        }
 
-        if (running != NULL)
+        /* Processes that arrive before then are added to the queues first, in
+         * the same order as if time was advanced one step at a time.
+         */
+        check_scheduled_processes(
+            source, time + steps - 1, cpus, options,
+            process_memories_list, pcb_pool
+            );
+        if (options->page_size > 0)
         {
-            /* Current executing process finished, terminate it and make it no
-             * currently executing process.
+            touch_cpus_pages(cpus, time, steps, process_memories_list, options);
+        }
+        for (i = 0; i < options->cpus; i++)
+        {
+            if (cpus[i].running != NULL)
+            {
+                run_cpu_for(&cpus[i], steps);
+            }
+        }
+
+        // Next event time.
+        time += steps;
+        set_event_log_time(options->event_log, time);
+
+        for (i = 0; i < options->cpus; i++)
+        {
+            running = cpus[i].running;
+            if (running == NULL || cpus[i].migration_time > 0)
+            {
+                continue;
+            }
+
+            /* Current executing process finished, terminate and release it and
+             * make it no currently executing process.
              */
             if (is_pcb_finished(running))
             {
-                terminate_pcb(running, free_list);
-                append_pcb_to_pcbs_list(running, terminated_list);
-                running = NULL;
+                log_simulation_event(options->event_log, terminate_event,
+                    running->process_id, NO_EVENT_VALUE, running->cpu_time);
+                terminate_pcb(running, time, process_memories_list, free_list);
+                record_process_metrics(&running->metrics, options->metrics);
+                release_to_object_pool(running, pcb_pool);
+                cpus[i].running = NULL;
             }
-            /* Current executing process exhausted their quantum, stop it and
-             * re-add it to end of the queue with a lower priority.
+            /* Current executing process is preempted by the scheduling policy
+             * (e.g. exhausted their quantum), stop it and re-add it to its
+             * CPU's waiting processes.
              */
-            else if (is_quantum_exhausted_by_pcb(running))
+            else if (policy->tick(&cpus[i], options) == 0)
             {
-                ready_and_decrease_priority_pcb(running);
-                append_pcb_to_pcbs_list(running, ready_qs[running->priority - 1]);
-                running = NULL;
+                preempt_cpu(&cpus[i], process_memories_list, options);
             }
         }
     }
 
-    // Print end simulation message.
-    printf("time %d, simulation finished.\n", time);
+    state->time = time;
+    state->next_boost_time = next_boost_time;
 
-    // Free allocated memory.
-    for (i = 0; i < MIN_PRIORITY; i++)
+    return finished;
+}
+
+void finish_scheduler_state(scheduler_state_t *state,
+    scheduler_options_t *options, simulation_summary_t *summary)
+{
+    // Print end simulation message.
+    if (options->page_size > 0)
     {
-        free_pcbs_queue(ready_qs[i]);
+        record_paging_summary(
+            state->cpus, state->proc_mems_list, options, summary
+            );
     }
-    free_pcbs_list(terminated_list);
-    free_scheduled_processes(scheduled_processes);
-    free_free_memory_segments_list(free_list);
-    free_process_memories_list(process_memories_list);
+    summary->compactions = state->mem_segs_list->compactions;
+    summary->compacted_size = state->mem_segs_list->compacted_size;
+    print_simulation_finished(state->time, options, summary);
+
+    return;
+}
+
+void free_scheduler_state(scheduler_state_t *state)
+{
+    free_cpus(state->cpus, state->cpus_len);
+    free_object_pool(state->pcb_pool);
+    free_free_memory_segments_list(state->mem_segs_list);
+    free_process_memories_list(state->proc_mems_list);
+    free(state);
 
     return;
 }
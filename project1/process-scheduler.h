@@ -7,10 +7,31 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Constants ///////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
+// Default priority levels and their quanta, overridable when run.
 #define MIN_PRIORITY     3
 #define Q1_QUANTUM       2
 #define Q2_QUANTUM       4
 #define Q3_QUANTUM       8
+// Default time between priority boosts, 0 for never.
+#define BOOST_INTERVAL   0
+// Number of pcbs allocated at a time by the pcb pool.
+#define PCBS_PER_SLAB    256
+// Default number of CPUs, and time lost when a process moves between them.
+#define CPUS             1
+#define MIGRATION_COST   0
+// Default page size, 0 for contiguous memory segments, and tlb of each CPU.
+#define PAGE_SIZE        0
+#define TLB_ENTRIES      64
+#define TLB_WAYS         4
+/* Default external fragmentation percentage main memory is compacted at, and
+ * time taken to copy each byte of process memory moved by compaction.
+ */
+#define COMPACTION_THRESHOLD NO_COMPACTION
+#define COMPACTION_COST      0.01
+// CPU of a process that has not run yet.
+#define NO_CPU           -1
+// Used in stop_time when a run is not stopped until it finishes.
+#define NO_STOP_TIME     -1
 
 ////////////////////////////////////////////////////////////////////////////////
 // Data structures. ////////////////////////////////////////////////////////////
@@ -21,6 +42,7 @@ enum process_state_t { ready, running, terminated };
 typedef struct process_control_block_t
 {
     struct process_control_block_t *next;
+    struct process_control_block_t *prev;
     int                            process_id;
     enum process_state_t           process_state;
     process_memory_t               *process_memory;
@@ -28,24 +50,156 @@ typedef struct process_control_block_t
     int                            job_time;    // Total time to finish process.
     int                            burst_time;  // Time ran continuously on CPU.
     int                            cpu_time;    // Total time ran on CPU.
+    int                            cpu;         // CPU it last ran on.
+    process_metrics_t              metrics;
+    // Scheduling policy state while waiting.
+    int                            tickets;     // Lottery tickets held.
+    int                            lottery_slot;  // Index in lottery tree.
+    int                            vruntime;    // Fair share of time ran.
+    struct process_control_block_t *tree_left;
+    struct process_control_block_t *tree_right;
+    struct process_control_block_t *tree_parent;
+    int                            tree_red;
 } process_control_block_t;
 
+/* Data structure to hold a queue (or list) of process control blocks, doubly
+ * linked through the pcbs so adding to the end and removing are constant time.
+ */
 typedef struct pcbs_queue_t
 {
     struct process_control_block_t *head;
+    struct process_control_block_t *tail;
+    int                            len;
 } pcbs_queue_t;
 
+/* Data structure to hold a scheduling policy, which chooses the next waiting
+ * process to run on a CPU and when to preempt the running one. Processes are
+ * enqueued on arrival and when preempted, and put back when picked but unable
+ * to be loaded yet.
+ */
+struct cpu_t;
+struct scheduler_options_t;
+typedef struct scheduling_policy_t
+{
+    char *name;
+    void (*enqueue)(process_control_block_t *pcb, struct cpu_t *cpu,
+        struct scheduler_options_t *options);
+    void (*put_back)(process_control_block_t *pcb, struct cpu_t *cpu,
+        struct scheduler_options_t *options);
+    process_control_block_t *(*pick_next)(struct cpu_t *cpu,
+        struct scheduler_options_t *options);
+    // Time steps the running process has left before it is preempted.
+    int (*tick)(struct cpu_t *cpu, struct scheduler_options_t *options);
+    void (*on_preempt)(process_control_block_t *pcb, struct cpu_t *cpu,
+        struct scheduler_options_t *options);
+    // Priority boost of waiting processes, NULL if the policy has none.
+    void (*boost)(struct cpu_t *cpu, struct scheduler_options_t *options);
+    // Whether an arrival can preempt the running process.
+    int preempts_on_arrival;
+} scheduling_policy_t;
+
+/* Data structure to hold a (simulated) CPU, running one process at a time from
+ * its own waiting processes. Depending on the scheduling policy, they are kept
+ * in ready queues, one per priority level, a binary heap or a red-black tree.
+ * Lottery scheduling also keeps the tickets of its ready queue in a Fenwick
+ * tree, each process in a slot in the order it was added.
+ */
+typedef struct cpu_t
+{
+    int                     id;
+    process_control_block_t *running;  // Currently executing process.
+    int                     waiting;   // Number of waiting processes.
+    pcbs_queue_t            **ready_qs;
+    int                     levels;
+    process_control_block_t **ready_heap;
+    int                     ready_heap_len;
+    int                     ready_heap_max_len;
+    process_control_block_t *ready_tree;
+    int                     min_vruntime;
+    int                     tickets;  // Lottery tickets of waiting processes.
+    unsigned int            random_state;
+    process_control_block_t **lottery_pcbs;  // Waiting processes by slot.
+    int                     *lottery_tree;   // Ticket sums by slot.
+    int                     lottery_len;
+    int                     lottery_max_len;
+    int                     migration_time;  // Time left moving a process in
+                                             // (or compacting memory for it).
+    struct tlb_t            *tlb;  // Tlb, NULL if not paged.
+} cpu_t;
+
+/* Data structure to hold the options a process scheduler runs with. */
+typedef struct scheduler_options_t
+{
+    const scheduling_policy_t *scheduling_policy;  // Process to run next.
+    int               memsize;     // Main memory size.
+    enum fit_policy_t fit_policy;  // Free memory segment to swap into.
+    const eviction_policy_t *eviction_policy;  // Process memory to swap out.
+    int               levels;      // Number of (MLFQ) priority levels.
+    int               *quanta;     // Quantum of each level, highest first.
+    int               boost_interval;  // Time between boosts, 0 for never.
+    int               cpus;        // Number of CPUs.
+    int               migration_cost;  // Time to move a process between CPUs.
+    int               page_size;   // Page size, 0 for contiguous memory.
+    int               tlb_entries; // Tlb entries of each CPU, if paged.
+    int               tlb_ways;    // Tlb entries of each set, if paged.
+    int               compaction_threshold;  // NO_COMPACTION for never.
+    double            compaction_cost;  // Time to copy each byte compacted.
+    FILE              *output;     // Where to print status, NULL for nowhere.
+    event_log_t       *event_log;  // Where to log events, NULL for nowhere.
+    simulation_metrics_t *metrics; // Where to record per-process metrics.
+} scheduler_options_t;
+
+/* Data structure to hold the summary of a simulation. */
+typedef struct simulation_summary_t
+{
+    int context_switches;  // Number of times a process was loaded to run.
+    int max_processes;     // Max number of processes in main memory.
+    int max_holes;         // Max number of free memory segments.
+    int max_memusage;      // Max main memory usage percentage.
+    int finish_time;
+    /* Max main memory percentage allocated to but unused by process memories
+     * (internal fragmentation), and max free memory percentage outside the
+     * largest hole (external fragmentation).
+     */
+    int max_internal_frag;
+    int max_external_frag;
+    // Times main memory was compacted, and total size of memory moved.
+    int compactions;
+    long compacted_size;
+    // Page and tlb statistics, if paged.
+    long page_faults;
+    long page_outs;
+    long tlb_hits;
+    long tlb_misses;
+} simulation_summary_t;
+
+/* Data structure to hold the state of a process scheduler run between events,
+ * which the run can be stopped at and continued from.
+ */
+typedef struct scheduler_state_t
+{
+    int                         time;             // Time steps.
+    int                         next_boost_time;  // Time of next boost.
+    cpu_t                       *cpus;
+    int                         cpus_len;
+    object_pool_t               *pcb_pool;  // Pool all pcbs are allocated from.
+    process_memories_list_t     *proc_mems_list;
+    free_memory_segments_list_t *mem_segs_list;
+} scheduler_state_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Function prototypes. ////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
-/* Allocate memory for and initialise a new process control block. */
+/* Allocate from a pool and initialise a new process control block. */
 process_control_block_t *new_process_control_block(int process_id,
-    int memory_size, int job_time, process_memories_list_t *proc_mems_list);
-/* Allocate memory for and initialise a new process control block with a
+    int memory_size, int job_time, process_memories_list_t *proc_mems_list,
+    object_pool_t *pcb_pool);
+/* Allocate from a pool and initialise a new process control block with a
  * scheduled process.
  */
 process_control_block_t *new_process_control_block_by_scheduled_process(
-    scheduled_process_t *sp, process_memories_list_t *proc_mems_list);
+    scheduled_process_t *sp, process_memories_list_t *proc_mems_list,
+    object_pool_t *pcb_pool);
 /* Allocate memory for and initialise a new process control block queue or list.
  */
 pcbs_queue_t *new_pcbs_queue();
@@ -54,6 +208,19 @@ pcbs_queue_t *new_pcbs_list();
  * priority then process number.
  */
 void add_pcb_to_pcbs_queue(process_control_block_t *pcb, pcbs_queue_t *pcbs_queue);
+/* Insert a process control block after another (or first if NULL) in the
+ * process control block queue.
+ */
+void insert_pcb_after_in_pcbs_queue(process_control_block_t *pcb,
+    process_control_block_t *prev_pcb, pcbs_queue_t *pcbs_queue);
+/* Remove a process control block from the process control block queue. */
+void remove_pcb_from_pcbs_queue(process_control_block_t *pcb,
+    pcbs_queue_t *pcbs_queue);
+/* Move a process control block to the end of another process control block
+ * queue, such as the queue of another priority level.
+ */
+void move_pcb_to_pcbs_queue(process_control_block_t *pcb,
+    pcbs_queue_t *from_pcbs_queue, pcbs_queue_t *to_pcbs_queue);
 /* Get and remove the first process control block in the process control block
  * queue or list.
  */
@@ -63,41 +230,150 @@ process_control_block_t *pop_front_pcb_from_pcbs_list(pcbs_queue_t *pcbs_list);
  */
 void append_pcb_to_pcbs_list(process_control_block_t *pcb, pcbs_queue_t *pcbs_list);
 /* Load the process control block's memory into main memory and update its
- * attributes to prepare to run.
+ * attributes to prepare to run. Returns 0 if it cannot fit until processes
+ * running on other CPUs are stopped.
  */
-void load_pcb(process_control_block_t *pcb, int time,
+int load_pcb(process_control_block_t *pcb, int time,
     process_memories_list_t *proc_mems_list,
     free_memory_segments_list_t *mem_segs_list);
 /* Run the process for one time step. */
 void run_pcb(process_control_block_t *pcb);
+/* Run the process for a number of time steps at once. */
+void run_pcb_for(process_control_block_t *pcb, int steps);
 /* Preempt the process and updates its attributes. This does NOT lower its
  * priority.
  */
 void preempt_pcb(process_control_block_t *pcb);
 /* Decrease priority and reset state to ready for the process. */
-void ready_and_decrease_priority_pcb(process_control_block_t *pcb);
+void ready_and_decrease_priority_pcb(process_control_block_t *pcb,
+    scheduler_options_t *options);
 /* Termiante the process and release its memory from main memory. */
-void terminate_pcb(process_control_block_t *pcb,
+void terminate_pcb(process_control_block_t *pcb, int time,
+    process_memories_list_t *proc_mems_list,
     free_memory_segments_list_t *mem_segs_list);
 /* Check if the process has finished its job(-time). */
 int is_pcb_finished(process_control_block_t *pcb);
-/* Print the running process and memory statistics. */
+/* Print the running process and memory statistics, and record them in the
+ * simulation summary.
+ */
 void print_simulation_status(int time, process_control_block_t *running,
-    process_memories_list_t *process_memories_list,
-    free_memory_segments_list_t *free_list, int memsize);
-/* Load, on arrival of, new processes in the ready queue using the first come
- * first serve algorithm.
- */
-int check_scheduled_processes(scheduled_process_t *sps[], int spi, int time,
-    pcbs_queue_t *ready_queue, process_memories_list_t *proc_mems_list);
-/* Free all memory allocated for process control block queue or list. */
+    int cpu_id, process_memories_list_t *process_memories_list,
+    free_memory_segments_list_t *free_list, scheduler_options_t *options,
+    simulation_summary_t *summary);
+/* Print a running process and a snapshot of main memory use, and record them
+ * in the simulation summary.
+ */
+void print_simulation_status_by_stats(int time, int process_id, int cpu_id,
+    memory_stats_t *stats, scheduler_options_t *options,
+    simulation_summary_t *summary);
+/* Print the end of the simulation, page and tlb statistics if paged,
+ * fragmentation if buddy fit, and compaction if enabled, and record it in the
+ * simulation summary.
+ */
+void print_simulation_finished(int time, scheduler_options_t *options,
+    simulation_summary_t *summary);
+/* Reset the simulation summary for a new simulation. */
+void reset_simulation_summary(simulation_summary_t *summary);
+/* Load, on arrival of, new processes and enqueue them on the least loaded CPU.
+ */
+void check_scheduled_processes(scheduled_process_source_t *source,
+    int time, cpu_t cpus[], scheduler_options_t *options,
+    process_memories_list_t *proc_mems_list, object_pool_t *pcb_pool);
+/* Free all memory allocated for process control block queue or list. Its
+ * pcbs are freed with the pool they were allocated from.
+ */
 void free_pcbs_queue(pcbs_queue_t *pcbs_queue);
 void free_pcbs_list(pcbs_queue_t *pcbs_list);
-/* Get the quantum (time) of a process. */
-int get_quantum_by_pcb(process_control_block_t *pcb);
+/* Get the quantum (time) of a process from its priority level's quantum. */
+int get_quantum_by_pcb(process_control_block_t *pcb,
+    scheduler_options_t *options);
 /* Check if quantum is exhausted by process. */
-int is_quantum_exhausted_by_pcb(process_control_block_t *pcb);
-/* Run the first come first serve process scheduler. */
-void fcfs_scheduler_runner(char filename[], int memsize);
-/* Run the multi-level feedback queue process scheduler. */
-void multi_scheduler_runner(char filename[], int memsize);
+int is_quantum_exhausted_by_pcb(process_control_block_t *pcb,
+    scheduler_options_t *options);
+/* Get the time steps left until the process finishes its job(-time), which is
+ * at least one.
+ */
+int get_remaining_job_time_by_pcb(process_control_block_t *pcb);
+/* Get the time steps left until the process exhausts its quantum, which is at
+ * least one.
+ */
+int get_remaining_quantum_by_pcb(process_control_block_t *pcb,
+    scheduler_options_t *options);
+/* Move every waiting process to the highest priority level queue. The running
+ * process keeps its priority.
+ */
+void boost_pcbs_queues(pcbs_queue_t *ready_qs[], int levels);
+/* Allocate memory for and initialise CPUs, each with empty ready queues. */
+cpu_t *new_cpus(int len, int levels);
+/* Enqueue a waiting process on a CPU with the scheduling policy. */
+void enqueue_pcb_on_cpu(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options);
+/* Free all memory allocated for CPUs and their ready queues. */
+void free_cpus(cpu_t cpus[], int len);
+/* Get the number of processes running on or waiting for a CPU. */
+int get_cpu_load(cpu_t *cpu);
+/* Get the CPU with the least load, the lowest numbered one on ties. */
+cpu_t *get_least_loaded_cpu(cpu_t cpus[], int len);
+/* Get and remove the waiting process the scheduling policy picks next on a CPU,
+ * or NULL if none wait.
+ */
+process_control_block_t *pop_next_pcb_from_cpu(cpu_t *cpu,
+    scheduler_options_t *options);
+/* Steal the next waiting process of the CPU with the most waiting processes
+ * (the lowest numbered one on ties), or NULL if none wait. from_cpu is set to
+ * the CPU it was stolen from.
+ */
+process_control_block_t *steal_pcb_for_cpu(cpu_t *cpu, cpu_t cpus[],
+    scheduler_options_t *options, cpu_t **from_cpu);
+/* Dispatch the next process, its own or a stolen one, to an idle CPU and load
+ * it. The CPU stays idle if there is none or it cannot be loaded yet.
+ */
+void dispatch_cpu(cpu_t *cpu, cpu_t cpus[], int time,
+    process_memories_list_t *proc_mems_list,
+    free_memory_segments_list_t *mem_segs_list, scheduler_options_t *options,
+    simulation_summary_t *summary);
+/* Get the time steps left until the running process of a CPU finishes or is
+ * preempted, including moving it in first.
+ */
+int get_remaining_time_by_cpu(cpu_t *cpu, scheduler_options_t *options);
+/* Run a CPU for a number of time steps, moving its running process in first. */
+void run_cpu_for(cpu_t *cpu, int steps);
+/* Touch the pages of every CPU's running process for a number of time steps,
+ * one step of every CPU at a time, as they would run them.
+ */
+void touch_cpus_pages(cpu_t cpus[], int time, int steps,
+    process_memories_list_t *proc_mems_list, scheduler_options_t *options);
+/* Record the page and tlb statistics of a paged simulation in its summary. */
+void record_paging_summary(cpu_t cpus[],
+    process_memories_list_t *proc_mems_list, scheduler_options_t *options,
+    simulation_summary_t *summary);
+/* Stop the running process of a CPU and enqueue it again. */
+void preempt_cpu(cpu_t *cpu, process_memories_list_t *proc_mems_list,
+    scheduler_options_t *options);
+/* Parse comma separated, positive quanta (e.g. "2,4,8") into a newly allocated
+ * array. Returns the number of quanta (levels), or 0 if invalid.
+ */
+int parse_quanta(char str[], int **quanta);
+/* Run the process scheduler with its scheduling policy on every CPU over the
+ * scheduled processes pulled from a source, and fill in the simulation summary.
+ */
+void scheduler_run(scheduled_process_source_t *source,
+    scheduler_options_t *options, simulation_summary_t *summary);
+/* Allocate memory for and initialise the state of a new run at time 0, with
+ * all of main memory free.
+ */
+scheduler_state_t *new_scheduler_state(scheduler_options_t *options);
+/* Run the process scheduler from its state until it finishes, or until the
+ * first event at or after a stop time (NO_STOP_TIME for none). Returns 0 if
+ * stopped before it finished.
+ */
+int run_scheduler_state(scheduled_process_source_t *source,
+    scheduler_state_t *state, int stop_time, scheduler_options_t *options,
+    simulation_summary_t *summary);
+/* Print the end of a finished run and record it in the simulation summary. */
+void finish_scheduler_state(scheduler_state_t *state,
+    scheduler_options_t *options, simulation_summary_t *summary);
+/* Free all memory allocated for the state of a run. */
+void free_scheduler_state(scheduler_state_t *state);
+/* Parse a fit policy name. Returns 0 if invalid. */
+int parse_fit_policy(char str[], enum fit_policy_t *fit_policy);
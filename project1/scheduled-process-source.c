@@ -0,0 +1,267 @@
+/*
+ * scheduled-process-source.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "process-data-file-parser.h"
+#include "binary-trace.h"
+#include "scheduled-process-source.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+scheduled_process_source_t *new_scheduled_process_source(
+    int (*read)(void *state, scheduled_process_t *sp),
+    void (*close)(void *state), void *state)
+{
+    scheduled_process_source_t *source;
+
+    // Allocate memory for source and error check.
+    source = (scheduled_process_source_t*)malloc(sizeof(scheduled_process_source_t));
+    if (source == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set source.
+    source->read = read;
+    source->close = close;
+    source->state = state;
+    source->has_next = 0;
+    source->ended = 0;
+    source->taken = 0;
+
+    return source;
+}
+
+scheduled_process_source_t *new_table_source(
+    scheduled_processes_table_t *table, int owns_table)
+{
+    table_source_state_t *state;
+
+    // Allocate memory for state and error check.
+    state = (table_source_state_t*)malloc(sizeof(table_source_state_t));
+    if (state == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set state.
+    state->table = table;
+    state->index = 0;
+    state->owns_table = owns_table;
+
+    return new_scheduled_process_source(
+        read_table_source, close_table_source, state
+        );
+}
+
+scheduled_process_source_t *new_binary_trace_source(char filename[])
+{
+    return new_scheduled_process_source(
+        read_binary_trace_source, close_binary_trace_source,
+        open_binary_trace(filename)
+        );
+}
+
+scheduled_process_source_t *new_text_stream_source(char filename[])
+{
+    text_stream_source_state_t *state;
+
+    // Allocate memory for state and error check.
+    state = (text_stream_source_state_t*)malloc(sizeof(text_stream_source_state_t));
+    if (state == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Open file and error check.
+    state->fp = (strcmp(filename, "-") == 0) ? stdin : fopen(filename, "r");
+    if (state->fp == NULL)
+    {
+        perror("fopen");
+        exit(1);
+    }
+
+    return new_scheduled_process_source(
+        read_text_stream_source, close_text_stream_source, state
+        );
+}
+
+scheduled_process_source_t *open_scheduled_process_source(char filename[],
+    int loader_threads, int stream)
+{
+    int c;
+
+    /* Standard input can only be read once, so peek at its first character
+     * rather than the whole magic, which a text file never starts with.
+     */
+    if (strcmp(filename, "-") == 0)
+    {
+        c = getc(stdin);
+        ungetc(c, stdin);
+        if (c == BINARY_TRACE_MAGIC[0])
+        {
+            return new_binary_trace_source(filename);
+        }
+        return new_text_stream_source(filename);
+    }
+
+    if (is_binary_trace_file(filename))
+    {
+        return new_binary_trace_source(filename);
+    }
+    if (stream)
+    {
+        return new_text_stream_source(filename);
+    }
+    return new_table_source(map_process_data_file(filename, loader_threads), 1);
+}
+
+scheduled_processes_table_t *load_scheduled_processes_table(char filename[],
+    int loader_threads)
+{
+    scheduled_processes_table_t *table;
+    scheduled_process_source_t *source;
+    scheduled_process_t sp;
+
+    // Text file, memory map and parse it.
+    if (strcmp(filename, "-") != 0 && !is_binary_trace_file(filename))
+    {
+        return map_process_data_file(filename, loader_threads);
+    }
+
+    // Binary trace or standard input, read each record into table.
+    table = new_scheduled_processes_table(INITIAL_SCHEDULED_PROCS_MAX_LEN);
+    source = open_scheduled_process_source(filename, loader_threads, 1);
+    while (take_scheduled_process(source, &sp))
+    {
+        append_to_scheduled_processes_table(&sp, table);
+    }
+    free_scheduled_process_source(source);
+
+    return table;
+}
+
+scheduled_process_t *peek_scheduled_process(scheduled_process_source_t *source)
+{
+    // Read next scheduled process if not already.
+    if (!source->has_next && !source->ended)
+    {
+        source->has_next = source->read(source->state, &source->next);
+        source->ended = !source->has_next;
+    }
+
+    return source->has_next ? &source->next : NULL;
+}
+
+int take_scheduled_process(scheduled_process_source_t *source,
+    scheduled_process_t *sp)
+{
+    if (peek_scheduled_process(source) == NULL)
+    {
+        return 0;
+    }
+
+    if (sp != NULL)
+    {
+        *sp = source->next;
+    }
+    source->has_next = 0;
+    source->taken++;
+
+    return 1;
+}
+
+void free_scheduled_process_source(scheduled_process_source_t *source)
+{
+    if (source != NULL)
+    {
+        source->close(source->state);
+    }
+    free(source);
+    return;
+}
+
+int read_table_source(void *state_arg, scheduled_process_t *sp)
+{
+    table_source_state_t *state = (table_source_state_t*)state_arg;
+    scheduled_processes_table_t *table = state->table;
+
+    if (state->index >= table->len)
+    {
+        return 0;
+    }
+
+    // Set scheduled process from row of table.
+    sp->start_time = table->start_times[state->index];
+    sp->process_id = table->process_ids[state->index];
+    sp->memory_size = table->memory_sizes[state->index];
+    sp->job_time = table->job_times[state->index];
+    state->index++;
+
+    return 1;
+}
+
+void close_table_source(void *state_arg)
+{
+    table_source_state_t *state = (table_source_state_t*)state_arg;
+
+    if (state->owns_table)
+    {
+        free_scheduled_processes_table(state->table);
+    }
+    free(state);
+
+    return;
+}
+
+int read_text_stream_source(void *state_arg, scheduled_process_t *sp)
+{
+    text_stream_source_state_t *state = (text_stream_source_state_t*)state_arg;
+
+    // Read in lines until a valid one is parsed.
+    while (fgets(state->line, LINE_MAX_LEN, state->fp) != NULL)
+    {
+        if (parse_process_data_line(state->line, sp))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void close_text_stream_source(void *state_arg)
+{
+    text_stream_source_state_t *state = (text_stream_source_state_t*)state_arg;
+
+    if (state->fp != stdin)
+    {
+        fclose(state->fp);
+    }
+    free(state);
+
+    return;
+}
+
+int read_binary_trace_source(void *state, scheduled_process_t *sp)
+{
+    return read_binary_trace((binary_trace_t*)state, sp);
+}
+
+void close_binary_trace_source(void *state)
+{
+    close_binary_trace((binary_trace_t*)state);
+    return;
+}
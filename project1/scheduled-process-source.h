@@ -0,0 +1,89 @@
+/*
+ * scheduled-process-source.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Data structure to hold a source of scheduled processes, which the process
+ * schedulers pull from in start time order, one at a time, as they arrive.
+ */
+typedef struct scheduled_process_source_t
+{
+    // Read the next scheduled process, returning 0 at the end.
+    int                 (*read)(void *state, scheduled_process_t *sp);
+    // Free all memory allocated for the state.
+    void                (*close)(void *state);
+    void                *state;
+    scheduled_process_t next;      // Next scheduled process, once read.
+    int                 has_next;  // Next has been read but not taken.
+    int                 ended;
+    long                taken;     // Scheduled processes taken so far.
+} scheduled_process_source_t;
+
+/* Data structure to hold the state of a source reading from a table. */
+typedef struct table_source_state_t
+{
+    scheduled_processes_table_t *table;
+    int                         index;
+    int                         owns_table;  // Free table when closed.
+} table_source_state_t;
+
+/* Data structure to hold the state of a source streaming a text file, one line
+ * at a time.
+ */
+typedef struct text_stream_source_state_t
+{
+    FILE *fp;
+    char line[LINE_MAX_LEN];
+} text_stream_source_state_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Allocate memory for and initialise a new scheduled process source. */
+scheduled_process_source_t *new_scheduled_process_source(
+    int (*read)(void *state, scheduled_process_t *sp),
+    void (*close)(void *state), void *state);
+/* Allocate memory for and initialise a new source reading from a scheduled
+ * processes table, freeing the table when closed if it owns it.
+ */
+scheduled_process_source_t *new_table_source(
+    scheduled_processes_table_t *table, int owns_table);
+/* Allocate memory for and initialise a new source reading a binary trace
+ * incrementally.
+ */
+scheduled_process_source_t *new_binary_trace_source(char filename[]);
+/* Allocate memory for and initialise a new source reading a text file ("-" for
+ * standard input) incrementally.
+ */
+scheduled_process_source_t *new_text_stream_source(char filename[]);
+/* Open a source for a file ("-" for standard input). Binary traces and, if
+ * streamed, text files are read incrementally, otherwise text files are loaded
+ * into a table by a number of threads.
+ */
+scheduled_process_source_t *open_scheduled_process_source(char filename[],
+    int loader_threads, int stream);
+/* Load all scheduled processes of a binary trace or text file into a table. */
+scheduled_processes_table_t *load_scheduled_processes_table(char filename[],
+    int loader_threads);
+/* Get the next scheduled process without taking it, or NULL if none left. */
+scheduled_process_t *peek_scheduled_process(scheduled_process_source_t *source);
+/* Take the next scheduled process, copying it into sp unless NULL. Returns 0
+ * if none left.
+ */
+int take_scheduled_process(scheduled_process_source_t *source,
+    scheduled_process_t *sp);
+/* Close the source and free all memory allocated for it. */
+void free_scheduled_process_source(scheduled_process_source_t *source);
+/* Table source hooks. */
+int read_table_source(void *state, scheduled_process_t *sp);
+void close_table_source(void *state);
+/* Text stream source hooks. */
+int read_text_stream_source(void *state, scheduled_process_t *sp);
+void close_text_stream_source(void *state);
+/* Binary trace source hooks. */
+int read_binary_trace_source(void *state, scheduled_process_t *sp);
+void close_binary_trace_source(void *state);
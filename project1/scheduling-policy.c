@@ -0,0 +1,735 @@
+/*
+ * scheduling-policy.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "object-pool.h"
+#include "event-log.h"
+#include "memory-management.h"
+#include "process-data-file-parser.h"
+#include "scheduled-process-source.h"
+#include "process-metrics.h"
+#include "process-scheduler.h"
+#include "scheduling-policy.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Global variables. ///////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const scheduling_policy_t fcfs_scheduling_policy = {
+    "fcfs",
+    fifo_scheduling_enqueue,
+    fifo_scheduling_put_back,
+    fifo_scheduling_pick_next,
+    fcfs_scheduling_tick,
+    rr_scheduling_on_preempt,
+    NULL,
+    0
+};
+
+const scheduling_policy_t multi_scheduling_policy = {
+    "multi",
+    fifo_scheduling_enqueue,
+    fifo_scheduling_put_back,
+    fifo_scheduling_pick_next,
+    multi_scheduling_tick,
+    multi_scheduling_on_preempt,
+    multi_scheduling_boost,
+    0
+};
+
+const scheduling_policy_t sjf_scheduling_policy = {
+    "sjf",
+    sjf_scheduling_enqueue,
+    sjf_scheduling_enqueue,
+    sjf_scheduling_pick_next,
+    fcfs_scheduling_tick,
+    rr_scheduling_on_preempt,
+    NULL,
+    0
+};
+
+const scheduling_policy_t srtf_scheduling_policy = {
+    "srtf",
+    sjf_scheduling_enqueue,
+    sjf_scheduling_enqueue,
+    sjf_scheduling_pick_next,
+    srtf_scheduling_tick,
+    rr_scheduling_on_preempt,
+    NULL,
+    1
+};
+
+const scheduling_policy_t rr_scheduling_policy = {
+    "rr",
+    fifo_scheduling_enqueue,
+    fifo_scheduling_put_back,
+    fifo_scheduling_pick_next,
+    rr_scheduling_tick,
+    rr_scheduling_on_preempt,
+    NULL,
+    0
+};
+
+const scheduling_policy_t lottery_scheduling_policy = {
+    "lottery",
+    lottery_scheduling_enqueue,
+    lottery_scheduling_enqueue,
+    lottery_scheduling_pick_next,
+    rr_scheduling_tick,
+    rr_scheduling_on_preempt,
+    NULL,
+    0
+};
+
+const scheduling_policy_t cfs_scheduling_policy = {
+    "cfs",
+    cfs_scheduling_enqueue,
+    cfs_scheduling_enqueue,
+    cfs_scheduling_pick_next,
+    rr_scheduling_tick,
+    cfs_scheduling_on_preempt,
+    NULL,
+    0
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const scheduling_policy_t *get_scheduling_policy_by_name(char name[])
+{
+    const scheduling_policy_t *policies[] = {
+        &fcfs_scheduling_policy,
+        &multi_scheduling_policy,
+        &sjf_scheduling_policy,
+        &srtf_scheduling_policy,
+        &rr_scheduling_policy,
+        &lottery_scheduling_policy,
+        &cfs_scheduling_policy,
+        NULL
+    };
+    int i;
+
+    // Iterate over policies and find policy by name.
+    for (i = 0; policies[i] != NULL; i++)
+    {
+        if (strcmp(policies[i]->name, name) == 0)
+        {
+            return policies[i];
+        }
+    }
+
+    return NULL;
+}
+
+void fifo_scheduling_enqueue(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    // Add to end of its priority level's queue.
+    append_pcb_to_pcbs_list(pcb, cpu->ready_qs[pcb->priority - 1]);
+    return;
+}
+
+void fifo_scheduling_put_back(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    // Add to front of its priority level's queue, to be picked again first.
+    insert_pcb_after_in_pcbs_queue(pcb, NULL, cpu->ready_qs[pcb->priority - 1]);
+    return;
+}
+
+process_control_block_t *fifo_scheduling_pick_next(cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    int i;
+    process_control_block_t *pcb = NULL;
+
+    // First process of the highest priority level with any.
+    for (i = 1; i <= cpu->levels && pcb == NULL; i++)
+    {
+        pcb = pop_front_pcb_from_pcbs_queue(cpu->ready_qs[i - 1]);
+    }
+
+    return pcb;
+}
+
+int fcfs_scheduling_tick(cpu_t *cpu, scheduler_options_t *options)
+{
+    // Never preempted.
+    return INT_MAX;
+}
+
+int multi_scheduling_tick(cpu_t *cpu, scheduler_options_t *options)
+{
+    int remaining = get_quantum_by_pcb(cpu->running, options) - cpu->running->burst_time;
+    return (remaining < 0) ? 0 : remaining;
+}
+
+void multi_scheduling_on_preempt(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    ready_and_decrease_priority_pcb(pcb, options);
+    return;
+}
+
+void multi_scheduling_boost(cpu_t *cpu, scheduler_options_t *options)
+{
+    boost_pcbs_queues(cpu->ready_qs, cpu->levels);
+    return;
+}
+
+void sjf_scheduling_enqueue(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    add_pcb_to_ready_heap(pcb, cpu);
+    return;
+}
+
+process_control_block_t *sjf_scheduling_pick_next(cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    return pop_pcb_from_ready_heap(cpu);
+}
+
+int srtf_scheduling_tick(cpu_t *cpu, scheduler_options_t *options)
+{
+    // Preempted only by a waiting process with strictly less job time left.
+    if (cpu->ready_heap_len > 0 &&
+        get_job_time_left_by_pcb(cpu->ready_heap[0]) < get_job_time_left_by_pcb(cpu->running))
+    {
+        return 0;
+    }
+    return INT_MAX;
+}
+
+int rr_scheduling_tick(cpu_t *cpu, scheduler_options_t *options)
+{
+    // Every process has the quantum of the highest priority level.
+    int remaining = options->quanta[0] - cpu->running->burst_time;
+    return (remaining < 0) ? 0 : remaining;
+}
+
+void rr_scheduling_on_preempt(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    // Set pcb - keep priority.
+    pcb->process_state = ready;
+    pcb->burst_time = 0;
+    return;
+}
+
+void lottery_scheduling_enqueue(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    // Renumber the slots first if there are none left (or none yet).
+    if (cpu->lottery_pcbs == NULL || cpu->lottery_len == cpu->lottery_max_len)
+    {
+        rebuild_lottery_tree(cpu);
+    }
+
+    // Order doesn't matter to the draw, so always add to the end.
+    append_pcb_to_pcbs_list(pcb, cpu->ready_qs[1 - 1]);
+    pcb->lottery_slot = cpu->lottery_len++;
+    cpu->lottery_pcbs[pcb->lottery_slot] = pcb;
+    add_lottery_tree_tickets(cpu, pcb->lottery_slot, pcb->tickets);
+    cpu->tickets += pcb->tickets;
+    return;
+}
+
+process_control_block_t *lottery_scheduling_pick_next(cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    process_control_block_t *pcb;
+    unsigned int draw;
+
+    if (cpu->ready_qs[1 - 1]->head == NULL)
+    {
+        return NULL;
+    }
+
+    // Slots aren't kept in checkpoints, so number them again after a restore.
+    if (cpu->lottery_pcbs == NULL)
+    {
+        rebuild_lottery_tree(cpu);
+    }
+
+    // Find the process holding the drawn ticket, or the first if none have any.
+    if (cpu->tickets <= 0)
+    {
+        pcb = cpu->ready_qs[1 - 1]->head;
+    }
+    else
+    {
+        draw = get_next_lottery_draw(cpu) % (unsigned int)cpu->tickets;
+        pcb = cpu->lottery_pcbs[find_lottery_tree_slot(cpu, draw)];
+    }
+
+    remove_pcb_from_pcbs_queue(pcb, cpu->ready_qs[1 - 1]);
+    add_lottery_tree_tickets(cpu, pcb->lottery_slot, -pcb->tickets);
+    cpu->lottery_pcbs[pcb->lottery_slot] = NULL;
+    cpu->tickets -= pcb->tickets;
+
+    return pcb;
+}
+
+void cfs_scheduling_enqueue(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    /* New (or moved) processes start at the least virtual time waiting, so
+     * they don't run ahead of the rest for as long as they have run less.
+     */
+    if (pcb->vruntime < cpu->min_vruntime)
+    {
+        pcb->vruntime = cpu->min_vruntime;
+    }
+    add_pcb_to_ready_tree(pcb, cpu);
+    return;
+}
+
+process_control_block_t *cfs_scheduling_pick_next(cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    process_control_block_t *pcb = pop_pcb_from_ready_tree(cpu);
+    if (pcb != NULL && pcb->vruntime > cpu->min_vruntime)
+    {
+        cpu->min_vruntime = pcb->vruntime;
+    }
+    return pcb;
+}
+
+void cfs_scheduling_on_preempt(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options)
+{
+    // Set pcb - account the time it ran, keep priority.
+    pcb->vruntime += pcb->burst_time;
+    pcb->process_state = ready;
+    pcb->burst_time = 0;
+    return;
+}
+
+int get_job_time_left_by_pcb(process_control_block_t *pcb)
+{
+    int left = pcb->job_time - pcb->cpu_time;
+    return (left < 0) ? 0 : left;
+}
+
+int is_pcb_shorter(process_control_block_t *pcb,
+    process_control_block_t *other_pcb)
+{
+    int left = get_job_time_left_by_pcb(pcb);
+    int other_left = get_job_time_left_by_pcb(other_pcb);
+    return (left < other_left ||
+        (left == other_left && pcb->process_id < other_pcb->process_id));
+}
+
+void add_pcb_to_ready_heap(process_control_block_t *pcb, cpu_t *cpu)
+{
+    process_control_block_t **heap;
+    int i, parent;
+
+    // Allocate or grow heap array first if necessary.
+    if (cpu->ready_heap_len == cpu->ready_heap_max_len)
+    {
+        cpu->ready_heap_max_len = (cpu->ready_heap_max_len == 0) ?
+            INITIAL_READY_HEAP_MAX_LEN : cpu->ready_heap_max_len * READY_HEAP_GROW_FACTOR;
+        cpu->ready_heap = (process_control_block_t**)realloc(cpu->ready_heap, sizeof(process_control_block_t*) * cpu->ready_heap_max_len);
+        if (cpu->ready_heap == NULL)
+        {
+            perror("realloc");
+            exit(1);
+        }
+    }
+
+    // Add to bottom of heap and move up while shorter than parent.
+    heap = cpu->ready_heap;
+    i = cpu->ready_heap_len++;
+    while (i > 0)
+    {
+        parent = (i - 1) / 2;
+        if (!is_pcb_shorter(pcb, heap[parent]))
+        {
+            break;
+        }
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = pcb;
+
+    return;
+}
+
+process_control_block_t *pop_pcb_from_ready_heap(cpu_t *cpu)
+{
+    process_control_block_t **heap = cpu->ready_heap, *pcb, *last_pcb;
+    int i = 0, child, len;
+
+    if (cpu->ready_heap_len == 0)
+    {
+        return NULL;
+    }
+
+    // Move last process into the top and down while a child is shorter.
+    pcb = heap[0];
+    len = --cpu->ready_heap_len;
+    last_pcb = heap[len];
+    while ((child = 2 * i + 1) < len)
+    {
+        if (child + 1 < len && is_pcb_shorter(heap[child + 1], heap[child]))
+        {
+            child++;
+        }
+        if (!is_pcb_shorter(heap[child], last_pcb))
+        {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last_pcb;
+
+    return pcb;
+}
+
+unsigned int get_next_lottery_draw(cpu_t *cpu)
+{
+    unsigned int x = cpu->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    cpu->random_state = x;
+    return x;
+}
+
+void rebuild_lottery_tree(cpu_t *cpu)
+{
+    process_control_block_t *pcb;
+    int i, parent, len = cpu->ready_qs[1 - 1]->len;
+
+    // Allocate arrays with room for as many processes again and error check.
+    cpu->lottery_max_len = (len == 0) ?
+        INITIAL_LOTTERY_TREE_MAX_LEN : len * LOTTERY_TREE_GROW_FACTOR;
+    cpu->lottery_pcbs = (process_control_block_t**)realloc(cpu->lottery_pcbs, sizeof(process_control_block_t*) * cpu->lottery_max_len);
+    cpu->lottery_tree = (int*)realloc(cpu->lottery_tree, sizeof(int) * (cpu->lottery_max_len + 1));
+    if (cpu->lottery_pcbs == NULL || cpu->lottery_tree == NULL)
+    {
+        perror("realloc");
+        exit(1);
+    }
+
+    // Slot each process in queue order, so draws land as they would in a scan.
+    memset(cpu->lottery_tree, 0, sizeof(int) * (cpu->lottery_max_len + 1));
+    cpu->lottery_len = 0;
+    for (pcb = cpu->ready_qs[1 - 1]->head; pcb != NULL; pcb = pcb->next)
+    {
+        pcb->lottery_slot = cpu->lottery_len++;
+        cpu->lottery_pcbs[pcb->lottery_slot] = pcb;
+        cpu->lottery_tree[cpu->lottery_len] = pcb->tickets;
+    }
+
+    // Sum each (one-based) node into its parent, in linear time.
+    for (i = 1; i <= cpu->lottery_max_len; i++)
+    {
+        parent = i + (i & -i);
+        if (parent <= cpu->lottery_max_len)
+        {
+            cpu->lottery_tree[parent] += cpu->lottery_tree[i];
+        }
+    }
+
+    return;
+}
+
+void add_lottery_tree_tickets(cpu_t *cpu, int slot, int tickets)
+{
+    int i;
+
+    for (i = slot + 1; i <= cpu->lottery_max_len; i += i & -i)
+    {
+        cpu->lottery_tree[i] += tickets;
+    }
+
+    return;
+}
+
+int find_lottery_tree_slot(cpu_t *cpu, unsigned int draw)
+{
+    int step = 1, i = 0;
+
+    // Descend from the largest power of two, skipping nodes summing to <= draw.
+    while (step * 2 <= cpu->lottery_max_len)
+    {
+        step *= 2;
+    }
+    for (; step > 0; step /= 2)
+    {
+        if (i + step <= cpu->lottery_max_len &&
+            (unsigned int)cpu->lottery_tree[i + step] <= draw)
+        {
+            i += step;
+            draw -= cpu->lottery_tree[i];
+        }
+    }
+
+    // Node i + 1 is the first past the draw, which is slot i.
+    return i;
+}
+
+int is_pcb_fair_before(process_control_block_t *pcb,
+    process_control_block_t *other_pcb)
+{
+    return (pcb->vruntime < other_pcb->vruntime ||
+        (pcb->vruntime == other_pcb->vruntime && pcb->process_id < other_pcb->process_id));
+}
+
+void add_pcb_to_ready_tree(process_control_block_t *pcb, cpu_t *cpu)
+{
+    process_control_block_t *parent = NULL, *node = cpu->ready_tree;
+    process_control_block_t *grandparent, *uncle;
+
+    // Find leaf to add process as a red node to.
+    while (node != NULL)
+    {
+        parent = node;
+        node = is_pcb_fair_before(pcb, node) ? node->tree_left : node->tree_right;
+    }
+    pcb->tree_parent = parent;
+    pcb->tree_left = NULL;
+    pcb->tree_right = NULL;
+    pcb->tree_red = 1;
+    if (parent == NULL)
+    {
+        cpu->ready_tree = pcb;
+    }
+    else if (is_pcb_fair_before(pcb, parent))
+    {
+        parent->tree_left = pcb;
+    }
+    else
+    {
+        parent->tree_right = pcb;
+    }
+
+    // Restore red-black properties while a red node has a red parent.
+    while ((parent = pcb->tree_parent) != NULL && parent->tree_red)
+    {
+        grandparent = parent->tree_parent;
+        if (parent == grandparent->tree_left)
+        {
+            uncle = grandparent->tree_right;
+            if (uncle != NULL && uncle->tree_red)
+            {
+                parent->tree_red = 0;
+                uncle->tree_red = 0;
+                grandparent->tree_red = 1;
+                pcb = grandparent;
+                continue;
+            }
+            if (pcb == parent->tree_right)
+            {
+                rotate_ready_tree_left(parent, cpu);
+                pcb = parent;
+                parent = pcb->tree_parent;
+            }
+            parent->tree_red = 0;
+            grandparent->tree_red = 1;
+            rotate_ready_tree_right(grandparent, cpu);
+        }
+        else
+        {
+            uncle = grandparent->tree_left;
+            if (uncle != NULL && uncle->tree_red)
+            {
+                parent->tree_red = 0;
+                uncle->tree_red = 0;
+                grandparent->tree_red = 1;
+                pcb = grandparent;
+                continue;
+            }
+            if (pcb == parent->tree_left)
+            {
+                rotate_ready_tree_right(parent, cpu);
+                pcb = parent;
+                parent = pcb->tree_parent;
+            }
+            parent->tree_red = 0;
+            grandparent->tree_red = 1;
+            rotate_ready_tree_left(grandparent, cpu);
+        }
+    }
+    cpu->ready_tree->tree_red = 0;
+
+    return;
+}
+
+process_control_block_t *pop_pcb_from_ready_tree(cpu_t *cpu)
+{
+    process_control_block_t *pcb = cpu->ready_tree, *node, *parent, *sibling;
+    int removed_red;
+
+    if (pcb == NULL)
+    {
+        return NULL;
+    }
+
+    // The first (leftmost) process has no left child, replace it by its right.
+    while (pcb->tree_left != NULL)
+    {
+        pcb = pcb->tree_left;
+    }
+    node = pcb->tree_right;
+    parent = pcb->tree_parent;
+    removed_red = pcb->tree_red;
+    if (parent == NULL)
+    {
+        cpu->ready_tree = node;
+    }
+    else
+    {
+        parent->tree_left = node;
+    }
+    if (node != NULL)
+    {
+        node->tree_parent = parent;
+    }
+    pcb->tree_left = pcb->tree_right = pcb->tree_parent = NULL;
+
+    /* Restore red-black properties if a black node was removed, moving the
+     * extra black up from node until it can be absorbed.
+     */
+    while (!removed_red && node != cpu->ready_tree && (node == NULL || !node->tree_red))
+    {
+        if (node == parent->tree_left)
+        {
+            sibling = parent->tree_right;
+            if (sibling->tree_red)
+            {
+                sibling->tree_red = 0;
+                parent->tree_red = 1;
+                rotate_ready_tree_left(parent, cpu);
+                sibling = parent->tree_right;
+            }
+            if ((sibling->tree_left == NULL || !sibling->tree_left->tree_red) &&
+                (sibling->tree_right == NULL || !sibling->tree_right->tree_red))
+            {
+                sibling->tree_red = 1;
+                node = parent;
+                parent = node->tree_parent;
+                continue;
+            }
+            if (sibling->tree_right == NULL || !sibling->tree_right->tree_red)
+            {
+                sibling->tree_left->tree_red = 0;
+                sibling->tree_red = 1;
+                rotate_ready_tree_right(sibling, cpu);
+                sibling = parent->tree_right;
+            }
+            sibling->tree_red = parent->tree_red;
+            parent->tree_red = 0;
+            sibling->tree_right->tree_red = 0;
+            rotate_ready_tree_left(parent, cpu);
+        }
+        else
+        {
+            sibling = parent->tree_left;
+            if (sibling->tree_red)
+            {
+                sibling->tree_red = 0;
+                parent->tree_red = 1;
+                rotate_ready_tree_right(parent, cpu);
+                sibling = parent->tree_left;
+            }
+            if ((sibling->tree_left == NULL || !sibling->tree_left->tree_red) &&
+                (sibling->tree_right == NULL || !sibling->tree_right->tree_red))
+            {
+                sibling->tree_red = 1;
+                node = parent;
+                parent = node->tree_parent;
+                continue;
+            }
+            if (sibling->tree_left == NULL || !sibling->tree_left->tree_red)
+            {
+                sibling->tree_right->tree_red = 0;
+                sibling->tree_red = 1;
+                rotate_ready_tree_left(sibling, cpu);
+                sibling = parent->tree_left;
+            }
+            sibling->tree_red = parent->tree_red;
+            parent->tree_red = 0;
+            sibling->tree_left->tree_red = 0;
+            rotate_ready_tree_right(parent, cpu);
+        }
+        node = cpu->ready_tree;
+        break;
+    }
+    if (!removed_red && node != NULL)
+    {
+        node->tree_red = 0;
+    }
+
+    return pcb;
+}
+
+void rotate_ready_tree_left(process_control_block_t *pcb, cpu_t *cpu)
+{
+    process_control_block_t *right = pcb->tree_right;
+
+    // Right child takes the place of pcb, which becomes its left child.
+    pcb->tree_right = right->tree_left;
+    if (right->tree_left != NULL)
+    {
+        right->tree_left->tree_parent = pcb;
+    }
+    right->tree_parent = pcb->tree_parent;
+    if (pcb->tree_parent == NULL)
+    {
+        cpu->ready_tree = right;
+    }
+    else if (pcb == pcb->tree_parent->tree_left)
+    {
+        pcb->tree_parent->tree_left = right;
+    }
+    else
+    {
+        pcb->tree_parent->tree_right = right;
+    }
+    right->tree_left = pcb;
+    pcb->tree_parent = right;
+
+    return;
+}
+
+void rotate_ready_tree_right(process_control_block_t *pcb, cpu_t *cpu)
+{
+    process_control_block_t *left = pcb->tree_left;
+
+    // Left child takes the place of pcb, which becomes its right child.
+    pcb->tree_left = left->tree_right;
+    if (left->tree_right != NULL)
+    {
+        left->tree_right->tree_parent = pcb;
+    }
+    left->tree_parent = pcb->tree_parent;
+    if (pcb->tree_parent == NULL)
+    {
+        cpu->ready_tree = left;
+    }
+    else if (pcb == pcb->tree_parent->tree_right)
+    {
+        pcb->tree_parent->tree_right = left;
+    }
+    else
+    {
+        pcb->tree_parent->tree_left = left;
+    }
+    left->tree_right = pcb;
+    pcb->tree_parent = left;
+
+    return;
+}
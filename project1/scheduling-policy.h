@@ -0,0 +1,123 @@
+/*
+ * scheduling-policy.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Lottery tickets each process holds, and the seed of every CPU's draws.
+#define LOTTERY_TICKETS  100
+#define LOTTERY_SEED     2463534242u
+// Initial length of, and how much to grow, the ready heap array.
+#define INITIAL_READY_HEAP_MAX_LEN 16
+#define READY_HEAP_GROW_FACTOR     2
+// Initial length of, and how much room to leave in, the lottery tree arrays.
+#define INITIAL_LOTTERY_TREE_MAX_LEN 16
+#define LOTTERY_TREE_GROW_FACTOR     2
+
+////////////////////////////////////////////////////////////////////////////////
+// Global variables. ///////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* First come first serve: run each process to completion in arrival order. */
+extern const scheduling_policy_t fcfs_scheduling_policy;
+/* Multi-level feedback queue: run the highest priority process for its level's
+ * quantum, then lower its priority.
+ */
+extern const scheduling_policy_t multi_scheduling_policy;
+/* Shortest job first: run the process with the least job time left to
+ * completion.
+ */
+extern const scheduling_policy_t sjf_scheduling_policy;
+/* Shortest remaining time first: shortest job first, preempting the running
+ * process as soon as one with less job time left arrives.
+ */
+extern const scheduling_policy_t srtf_scheduling_policy;
+/* Round robin: run each process in turn for the (highest level) quantum. */
+extern const scheduling_policy_t rr_scheduling_policy;
+/* Lottery: run a process drawn at random by its tickets for the quantum. */
+extern const scheduling_policy_t lottery_scheduling_policy;
+/* Completely fair: run the process that has run the least (virtual) time for
+ * the quantum.
+ */
+extern const scheduling_policy_t cfs_scheduling_policy;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Get a scheduling policy by its name, or NULL if there is none. */
+const scheduling_policy_t *get_scheduling_policy_by_name(char name[]);
+/* First in first out (per priority level) scheduling policy hooks. */
+void fifo_scheduling_enqueue(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options);
+void fifo_scheduling_put_back(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options);
+process_control_block_t *fifo_scheduling_pick_next(cpu_t *cpu,
+    scheduler_options_t *options);
+/* Run to completion scheduling policy hooks. */
+int fcfs_scheduling_tick(cpu_t *cpu, scheduler_options_t *options);
+/* Multi-level feedback queue scheduling policy hooks. */
+int multi_scheduling_tick(cpu_t *cpu, scheduler_options_t *options);
+void multi_scheduling_on_preempt(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options);
+void multi_scheduling_boost(cpu_t *cpu, scheduler_options_t *options);
+/* Shortest job first and shortest remaining time first scheduling policy
+ * hooks.
+ */
+void sjf_scheduling_enqueue(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options);
+process_control_block_t *sjf_scheduling_pick_next(cpu_t *cpu,
+    scheduler_options_t *options);
+int srtf_scheduling_tick(cpu_t *cpu, scheduler_options_t *options);
+/* Round robin scheduling policy hooks. */
+int rr_scheduling_tick(cpu_t *cpu, scheduler_options_t *options);
+void rr_scheduling_on_preempt(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options);
+/* Lottery scheduling policy hooks. */
+void lottery_scheduling_enqueue(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options);
+process_control_block_t *lottery_scheduling_pick_next(cpu_t *cpu,
+    scheduler_options_t *options);
+/* Completely fair scheduling policy hooks. */
+void cfs_scheduling_enqueue(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options);
+process_control_block_t *cfs_scheduling_pick_next(cpu_t *cpu,
+    scheduler_options_t *options);
+void cfs_scheduling_on_preempt(process_control_block_t *pcb, cpu_t *cpu,
+    scheduler_options_t *options);
+/* Get the job time left to completion of a process, which may be zero. */
+int get_job_time_left_by_pcb(process_control_block_t *pcb);
+/* Check if a process goes before another in the ready heap, by least job time
+ * left and then process id.
+ */
+int is_pcb_shorter(process_control_block_t *pcb,
+    process_control_block_t *other_pcb);
+/* Add a process to, or remove the first process from, the ready heap. */
+void add_pcb_to_ready_heap(process_control_block_t *pcb, cpu_t *cpu);
+process_control_block_t *pop_pcb_from_ready_heap(cpu_t *cpu);
+/* Get the next (xorshift) pseudo-random number of a CPU's lottery draws. */
+unsigned int get_next_lottery_draw(cpu_t *cpu);
+/* Put each process in the ready queue in a slot of the lottery tree, in queue
+ * order, with room to add as many again.
+ */
+void rebuild_lottery_tree(cpu_t *cpu);
+/* Add tickets (or take them away if negative) at a slot of the lottery tree. */
+void add_lottery_tree_tickets(cpu_t *cpu, int slot, int tickets);
+/* Find the slot of the lottery tree holding a ticket, which must be less than
+ * the tickets of the waiting processes.
+ */
+int find_lottery_tree_slot(cpu_t *cpu, unsigned int draw);
+/* Check if a process goes before another in the ready tree, by least virtual
+ * time ran and then process id.
+ */
+int is_pcb_fair_before(process_control_block_t *pcb,
+    process_control_block_t *other_pcb);
+/* Add a process to, or remove the first process from, the ready (red-black)
+ * tree.
+ */
+void add_pcb_to_ready_tree(process_control_block_t *pcb, cpu_t *cpu);
+process_control_block_t *pop_pcb_from_ready_tree(cpu_t *cpu);
+/* Rotate the ready tree left or right around a process. */
+void rotate_ready_tree_left(process_control_block_t *pcb, cpu_t *cpu);
+void rotate_ready_tree_right(process_control_block_t *pcb, cpu_t *cpu);
@@ -11,15 +11,20 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include "object-pool.h"
+#include "event-log.h"
 #include "memory-management.h"
+#include "eviction-policy.h"
+#include "paged-memory.h"
+#include "buddy-allocator.h"
 #include "process-data-file-parser.h"
+#include "scheduled-process-source.h"
+#include "process-metrics.h"
 #include "process-scheduler.h"
-
-////////////////////////////////////////////////////////////////////////////////
-// Constants ///////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-#define FCFS_ALGORITHM   0
-#define MULTI_ALGORITHM  1
+#include "scheduling-policy.h"
+#include "parameter-sweep.h"
+#include "checkpoint.h"
+#include "pcb-table.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Function definitions. ///////////////////////////////////////////////////////
@@ -29,11 +34,57 @@ extern char *optarg;
 
 int main(int argc, char *argv[])
 {
-    char input, *filename;
-    int algorithm, memsize;
+    char input, *filename = NULL;
+    scheduler_options_t options;
+    int default_quanta[MIN_PRIORITY] = { Q1_QUANTUM, Q2_QUANTUM, Q3_QUANTUM };
+    // Arguments as given, parsed once all are read.
+    char *algorithm_arg = NULL, *memsize_arg = NULL, *fit_policy_arg = NULL,
+        *eviction_policy_arg = NULL, *quanta_arg = NULL;
+    // Number of threads to run a parameter sweep with, 0 for a single run.
+    int sweep_threads = 0;
+    // Number of threads to load scheduled processes with.
+    int loader_threads = 1;
+    // Read scheduled processes incrementally as they arrive.
+    int stream = 0;
+    // Where and how to log events, if at all.
+    char *event_log_filename = NULL;
+    const event_log_format_t *event_log_format = &csv_event_log_format;
+    // Print per-process latency metrics.
+    int print_metrics = 0;
+    /* Stop the run at a time and save a checkpoint of it, or continue a run
+     * from a checkpoint.
+     */
+    int stop_time = NO_STOP_TIME, finished;
+    char *checkpoint_filename = NULL, *restore_filename = NULL;
+    // Run with a pcb table rather than linked pcbs.
+    int pcb_table = 0;
+    scheduled_processes_table_t *scheduled_processes;
+    scheduled_process_source_t *source;
+    simulation_summary_t summary;
+    scheduler_state_t *state;
+    parameter_sweep_t *sweep;
+
+    // Default options.
+    options.scheduling_policy = NULL;
+    options.memsize = 0;
+    options.fit_policy = first_fit;
+    options.eviction_policy = &largest_eviction_policy;
+    options.levels = MIN_PRIORITY;
+    options.quanta = default_quanta;
+    options.boost_interval = BOOST_INTERVAL;
+    options.cpus = CPUS;
+    options.migration_cost = MIGRATION_COST;
+    options.page_size = PAGE_SIZE;
+    options.tlb_entries = TLB_ENTRIES;
+    options.tlb_ways = TLB_WAYS;
+    options.compaction_threshold = COMPACTION_THRESHOLD;
+    options.compaction_cost = COMPACTION_COST;
+    options.output = stdout;
+    options.event_log = NULL;
+    options.metrics = NULL;
 
     // Handle program arguments.
-    while ((input = getopt(argc, argv, "f:a:m:")) != EOF)
+    while ((input = getopt(argc, argv, "f:a:m:p:e:q:b:c:k:P:T:W:C:K:j:t:sl:L:Mu:S:R:E:")) != EOF)
     {
         switch (input)
         {
@@ -41,22 +92,132 @@ int main(int argc, char *argv[])
                 filename = optarg;
                 break;
             case 'a':  // Algorithm to run.
-                if (strcmp("fcfs", optarg) == 0)
+                algorithm_arg = optarg;
+                break;
+            case 'm':  // Memory size.
+                memsize_arg = optarg;
+                break;
+            case 'p':  // Placement (fit) policy for swapping in.
+                fit_policy_arg = optarg;
+                break;
+            case 'e':  // Eviction policy for swapping out.
+                eviction_policy_arg = optarg;
+                break;
+            case 'q':  // Quantum of each priority level, e.g. "2,4,8".
+                quanta_arg = optarg;
+                break;
+            case 'b':  // Priority boost interval.
+                options.boost_interval = atoi(optarg);
+                if (options.boost_interval < 0)
                 {
-                    algorithm = FCFS_ALGORITHM;
+                    fprintf(stderr, "Invalid boost interval argument\n");
+                    exit(1);
                 }
-                else if (strcmp("multi", optarg) == 0)
+                break;
+            case 'c':  // Number of CPUs.
+                options.cpus = atoi(optarg);
+                if (options.cpus < 1)
                 {
-                    algorithm = MULTI_ALGORITHM;
+                    fprintf(stderr, "Invalid cpus argument\n");
+                    exit(1);
                 }
-                else
+                break;
+            case 'k':  // Time to move a process between CPUs.
+                options.migration_cost = atoi(optarg);
+                if (options.migration_cost < 0)
                 {
-                    fprintf(stderr, "Invalid algorithm argument\n");
+                    fprintf(stderr, "Invalid migration cost argument\n");
                     exit(1);
                 }
                 break;
-            case 'm':  // Memory size.
-                memsize = atoi(optarg);
+            case 'P':  // Page size, to page memory rather than segment it.
+                options.page_size = atoi(optarg);
+                if (options.page_size < 1)
+                {
+                    fprintf(stderr, "Invalid page size argument\n");
+                    exit(1);
+                }
+                break;
+            case 'T':  // Tlb entries of each CPU.
+                options.tlb_entries = atoi(optarg);
+                break;
+            case 'W':  // Tlb entries of each set (ways).
+                options.tlb_ways = atoi(optarg);
+                break;
+            case 'C':  // External fragmentation percentage to compact at.
+                options.compaction_threshold = atoi(optarg);
+                if (options.compaction_threshold < 0 ||
+                    options.compaction_threshold > 100)
+                {
+                    fprintf(stderr, "Invalid compaction threshold argument\n");
+                    exit(1);
+                }
+                break;
+            case 'K':  // Time to copy each byte compacted.
+                options.compaction_cost = atof(optarg);
+                if (options.compaction_cost < 0)
+                {
+                    fprintf(stderr, "Invalid compaction cost argument\n");
+                    exit(1);
+                }
+                break;
+            case 'j':  // Run a parameter sweep with this many threads.
+                sweep_threads = atoi(optarg);
+                if (sweep_threads < 1)
+                {
+                    fprintf(stderr, "Invalid threads argument\n");
+                    exit(1);
+                }
+                break;
+            case 't':  // Load scheduled processes with this many threads.
+                loader_threads = atoi(optarg);
+                if (loader_threads < 1 || loader_threads > MAX_LOADER_THREADS)
+                {
+                    fprintf(stderr, "Invalid loader threads argument\n");
+                    exit(1);
+                }
+                break;
+            case 's':  // Stream text scheduled processes rather than load them.
+                stream = 1;
+                break;
+            case 'l':  // Filename of event log output.
+                event_log_filename = optarg;
+                break;
+            case 'L':  // Format of event log, binary, csv or jsonl.
+                event_log_format = get_event_log_format_by_name(optarg);
+                if (event_log_format == NULL)
+                {
+                    fprintf(stderr, "Invalid event log format argument\n");
+                    exit(1);
+                }
+                break;
+            case 'M':  // Print per-process latency metrics when finished.
+                print_metrics = 1;
+                break;
+            case 'u':  // Time to stop the run at (until).
+                stop_time = atoi(optarg);
+                if (stop_time < 0)
+                {
+                    fprintf(stderr, "Invalid stop time argument\n");
+                    exit(1);
+                }
+                break;
+            case 'S':  // Filename of checkpoint to save when stopped.
+                checkpoint_filename = optarg;
+                break;
+            case 'R':  // Filename of checkpoint to restore the run from.
+                restore_filename = optarg;
+                break;
+            case 'E':  // Engine to run with, list (of pcbs) or table.
+                if (strcmp(optarg, "table") == 0)
+                {
+                    pcb_table = 1;
+                }
+                else if (strcmp(optarg, "list") != 0)
+                {
+                    fprintf(stderr, "Invalid engine argument\n");
+                    exit(1);
+                }
                 break;
             default:  // Unknown argument.
                 fprintf(stderr, "Unknown argument\n");
@@ -64,15 +225,155 @@ int main(int argc, char *argv[])
                 break;
         }
     }
+    if (filename == NULL)
+    {
+        fprintf(stderr, "Missing filename argument\n");
+        exit(1);
+    }
+    if (checkpoint_filename != NULL && stop_time == NO_STOP_TIME)
+    {
+        fprintf(stderr, "Missing stop time argument\n");
+        exit(1);
+    }
+    if (options.tlb_ways < 1 || options.tlb_entries < options.tlb_ways ||
+        options.tlb_entries % options.tlb_ways != 0)
+    {
+        fprintf(stderr, "Invalid tlb argument\n");
+        exit(1);
+    }
 
-    // Run algorithm schedule.
-    if (algorithm == FCFS_ALGORITHM)
+    /* Run every combination of the (comma separated) arguments over the
+     * scheduled processes, parsed once, and print a summary of each.
+     */
+    if (sweep_threads > 0)
     {
-        fcfs_scheduler_runner(filename, memsize);
+        if (stop_time != NO_STOP_TIME || restore_filename != NULL)
+        {
+            fprintf(stderr, "Checkpoints are not supported by sweeps\n");
+            exit(1);
+        }
+        if (pcb_table)
+        {
+            fprintf(stderr, "Table engine is not supported by sweeps\n");
+            exit(1);
+        }
+        scheduled_processes = load_scheduled_processes_table(filename, loader_threads);
+        sweep = new_parameter_sweep(scheduled_processes, algorithm_arg,
+            memsize_arg, quanta_arg, fit_policy_arg, eviction_policy_arg,
+            &options);
+        run_parameter_sweep(sweep, sweep_threads);
+        print_parameter_sweep(sweep, stdout);
+        free_parameter_sweep(sweep);
+        free_scheduled_processes_table(scheduled_processes);
+        return 0;
     }
-    else if (algorithm == MULTI_ALGORITHM)
+
+    // Parse arguments of a single run.
+    if (algorithm_arg != NULL)
+    {
+        options.scheduling_policy = get_scheduling_policy_by_name(algorithm_arg);
+    }
+    if (options.scheduling_policy == NULL)
+    {
+        fprintf(stderr, "Invalid algorithm argument\n");
+        exit(1);
+    }
+    options.memsize = (memsize_arg != NULL) ? atoi(memsize_arg) : 0;
+    if (options.memsize < 1)
+    {
+        fprintf(stderr, "Invalid memory size argument\n");
+        exit(1);
+    }
+    if (fit_policy_arg != NULL &&
+        !parse_fit_policy(fit_policy_arg, &options.fit_policy))
+    {
+        fprintf(stderr, "Invalid fit policy argument\n");
+        exit(1);
+    }
+    if (eviction_policy_arg != NULL)
+    {
+        options.eviction_policy = get_eviction_policy_by_name(eviction_policy_arg);
+        if (options.eviction_policy == NULL)
+        {
+            fprintf(stderr, "Invalid eviction policy argument\n");
+            exit(1);
+        }
+    }
+    if (quanta_arg != NULL)
+    {
+        options.levels = parse_quanta(quanta_arg, &options.quanta);
+        if (options.levels == 0)
+        {
+            fprintf(stderr, "Invalid quanta argument\n");
+            exit(1);
+        }
+    }
+    if (pcb_table && (stop_time != NO_STOP_TIME || restore_filename != NULL ||
+        !is_pcb_table_supported(&options)))
+    {
+        fprintf(stderr, "Options not supported by the table engine\n");
+        exit(1);
+    }
+
+    /* Open scheduled processes and run algorithm schedule, binary traces (and
+     * text files, if asked to) are streamed rather than loaded up front. A run
+     * restored from a checkpoint continues where it was stopped, and a stopped
+     * run is finished by the run that restores it.
+     */
+    if (event_log_filename != NULL)
+    {
+        options.event_log = open_event_log(event_log_filename, event_log_format);
+    }
+    if (print_metrics)
+    {
+        options.metrics = new_simulation_metrics();
+    }
+    source = open_scheduled_process_source(filename, loader_threads, stream);
+    if (pcb_table)
+    {
+        scheduler_run_pcb_table(source, &options, &summary);
+        finished = 1;
+    }
+    else
+    {
+        if (restore_filename != NULL)
+        {
+            state = restore_checkpoint(restore_filename, source, &options, &summary);
+        }
+        else
+        {
+            state = new_scheduler_state(&options);
+            reset_simulation_summary(&summary);
+        }
+        finished = run_scheduler_state(source, state, stop_time, &options, &summary);
+        if (finished)
+        {
+            finish_scheduler_state(state, &options, &summary);
+            if (checkpoint_filename != NULL)
+            {
+                fprintf(stderr, "Finished before stop time, no checkpoint saved\n");
+            }
+        }
+        else if (checkpoint_filename != NULL)
+        {
+            save_checkpoint(checkpoint_filename, state, source, &options, &summary);
+        }
+        free_scheduler_state(state);
+    }
+    free_scheduled_process_source(source);
+    close_event_log(options.event_log);
+    if (options.metrics != NULL)
+    {
+        if (finished)
+        {
+            print_simulation_metrics(options.metrics, summary.finish_time, stdout);
+        }
+        free_simulation_metrics(options.metrics);
+    }
+
+    if (options.quanta != default_quanta)
     {
-        multi_scheduler_runner(filename, memsize);
+        free(options.quanta);
     }
 
     return 0;
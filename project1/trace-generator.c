@@ -0,0 +1,179 @@
+/*
+ * trace-generator.c
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Libraries. //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include "process-data-file-parser.h"
+#include "trace-generator.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Function definitions. ///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void set_default_trace_generator_options(trace_generator_options_t *options)
+{
+    options->records = TRACE_RECORDS;
+    options->seed = TRACE_GENERATOR_SEED;
+    options->arrivals = poisson_arrivals;
+    options->mean_interarrival_time = MEAN_INTERARRIVAL_TIME;
+    options->mean_job_time = MEAN_JOB_TIME;
+    options->max_job_time = MAX_JOB_TIME;
+    options->mean_memory_size = MEAN_MEMORY_SIZE;
+    options->max_memory_size = MAX_MEMORY_SIZE;
+    options->tail_index = TAIL_INDEX;
+    return;
+}
+
+trace_generator_t *new_trace_generator(trace_generator_options_t *options)
+{
+    trace_generator_t *generator;
+
+    // Pareto means are only finite above a tail index of 1.
+    if (options->tail_index <= 1.0 || options->mean_interarrival_time <= 0 ||
+        options->mean_job_time < 1 || options->max_job_time < 1 ||
+        options->mean_memory_size < 1 || options->max_memory_size < 1)
+    {
+        fprintf(stderr, "Invalid trace generator options\n");
+        exit(1);
+    }
+    if (options->records > MAX_TRACE_RECORDS)
+    {
+        fprintf(stderr, "Invalid records, at most %d\n", MAX_TRACE_RECORDS);
+        exit(1);
+    }
+
+    // Allocate memory for trace generator and error check.
+    generator = (trace_generator_t*)malloc(sizeof(trace_generator_t));
+    if (generator == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Set trace generator, first arriving at time 0, then in a burst.
+    generator->options = *options;
+    generator->random_state = (options->seed != 0) ? options->seed : TRACE_GENERATOR_SEED;
+    generator->generated = 0;
+    generator->time = 0;
+    generator->bursting = 0;
+    generator->phase_arrivals = 0;
+
+    return generator;
+}
+
+int generate_scheduled_process(trace_generator_t *generator,
+    scheduled_process_t *sp)
+{
+    trace_generator_options_t *options = &generator->options;
+
+    if (generator->generated == options->records)
+    {
+        return 0;
+    }
+    if (generator->generated > 0)
+    {
+        generator->time += get_next_interarrival_time(generator);
+    }
+    generator->generated++;
+
+    /* Time runs on past the last start time, so arrivals after it all start
+     * then.
+     */
+    sp->start_time = (generator->time < MAX_TRACE_START_TIME) ?
+        (int)generator->time : MAX_TRACE_START_TIME;
+    sp->process_id = (int)generator->generated;
+    sp->memory_size = get_next_pareto(
+        generator, options->mean_memory_size, options->max_memory_size
+        );
+    sp->job_time = get_next_pareto(
+        generator, options->mean_job_time, options->max_job_time
+        );
+
+    return 1;
+}
+
+double get_next_interarrival_time(trace_generator_t *generator)
+{
+    double mean = generator->options.mean_interarrival_time;
+
+    if (generator->options.arrivals == poisson_arrivals)
+    {
+        return get_next_exponential(generator, mean);
+    }
+
+    // Switch between burst and lull once the phase has no arrivals left.
+    while (generator->phase_arrivals == 0)
+    {
+        generator->bursting = !generator->bursting;
+        generator->phase_arrivals = (int)get_next_exponential(
+            generator, MEAN_PHASE_ARRIVALS
+            );
+    }
+    generator->phase_arrivals--;
+
+    /* Lulls are as much slower than the mean as bursts are faster, so the
+     * mean is kept over as many arrivals in each.
+     */
+    return get_next_exponential(generator, generator->bursting ?
+        mean / BURST_FACTOR : 2 * mean - mean / BURST_FACTOR);
+}
+
+unsigned long long get_next_random(trace_generator_t *generator)
+{
+    generator->random_state ^= generator->random_state >> 12;
+    generator->random_state ^= generator->random_state << 25;
+    generator->random_state ^= generator->random_state >> 27;
+    return generator->random_state * 2685821657736338717ull;
+}
+
+double get_next_uniform(trace_generator_t *generator)
+{
+    // Top 53 bits, offset by half so never 0 or 1.
+    return ((get_next_random(generator) >> 11) + 0.5) / 9007199254740992.0;
+}
+
+double get_next_exponential(trace_generator_t *generator, double mean)
+{
+    return -mean * log(get_next_uniform(generator));
+}
+
+int get_next_pareto(trace_generator_t *generator, double mean, int max)
+{
+    double alpha = generator->options.tail_index;
+    // Scale (least value) giving the mean.
+    double scale = mean * (alpha - 1) / alpha;
+    double value = ceil(scale * pow(get_next_uniform(generator), -1 / alpha));
+
+    return (value < max) ? (int)value : max;
+}
+
+int parse_arrival_process(char str[], enum arrival_process_t *arrivals)
+{
+    if (strcmp("poisson", str) == 0)
+    {
+        *arrivals = poisson_arrivals;
+    }
+    else if (strcmp("bursty", str) == 0)
+    {
+        *arrivals = bursty_arrivals;
+    }
+    else
+    {
+        return 0;
+    }
+    return 1;
+}
+
+void free_trace_generator(trace_generator_t *generator)
+{
+    free(generator);
+    return;
+}
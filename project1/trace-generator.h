@@ -0,0 +1,97 @@
+/*
+ * trace-generator.h
+ * Version 20160416
+ * Written by Harry Wong (harryw1)
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants ///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Default seed, record count and shape of generated traces.
+#define TRACE_GENERATOR_SEED      88172645463325252ull
+#define TRACE_RECORDS             1000
+#define MEAN_INTERARRIVAL_TIME    10.0
+#define MEAN_JOB_TIME             8.0
+#define MAX_JOB_TIME              10000
+#define MEAN_MEMORY_SIZE          20.0
+#define MAX_MEMORY_SIZE           100
+#define TAIL_INDEX                1.5
+/* Bursty arrivals alternate between bursts, arriving this many times faster
+ * than the mean, and lulls, slower to keep the mean, each of this many
+ * arrivals on average.
+ */
+#define BURST_FACTOR              10.0
+#define MEAN_PHASE_ARRIVALS       50.0
+/* Start times are clamped to this, leaving room in an int for arrivals running
+ * late, and process ids count up to the most records.
+ */
+#define MAX_TRACE_START_TIME      (INT_MAX / 2)
+#define MAX_TRACE_RECORDS         INT_MAX
+
+////////////////////////////////////////////////////////////////////////////////
+// Data structures. ////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Processes generating the time between arrivals. Poisson arrivals are
+ * exponentially distributed apart, bursty arrivals too but at a rate switching
+ * between bursts and lulls (a two state Markov modulated Poisson process).
+ */
+enum arrival_process_t { poisson_arrivals, bursty_arrivals };
+
+/* Data structure to hold the shape of a generated trace. Job times and memory
+ * sizes are heavy-tailed: Pareto distributed with the tail index, rounded up
+ * and capped at their max.
+ */
+typedef struct trace_generator_options_t
+{
+    unsigned long long     records;
+    unsigned long long     seed;
+    enum arrival_process_t arrivals;
+    double                 mean_interarrival_time;
+    double                 mean_job_time;
+    int                    max_job_time;
+    double                 mean_memory_size;
+    int                    max_memory_size;
+    double                 tail_index;  // Smaller has heavier tails, above 1.
+} trace_generator_options_t;
+
+/* Data structure to hold a trace generator, which deterministically generates
+ * the same scheduled processes, in start time order, for the same options.
+ */
+typedef struct trace_generator_t
+{
+    trace_generator_options_t options;
+    unsigned long long        random_state;
+    unsigned long long        generated;  // Scheduled processes so far.
+    double                    time;       // Arrival time of the last one.
+    int                       bursting;   // In a burst, not a lull.
+    int                       phase_arrivals;  // Arrivals left in the phase.
+} trace_generator_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function prototypes. ////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/* Set trace generator options to the defaults. */
+void set_default_trace_generator_options(trace_generator_options_t *options);
+/* Allocate memory for and initialise a new trace generator. Exits if the
+ * options are invalid.
+ */
+trace_generator_t *new_trace_generator(trace_generator_options_t *options);
+/* Generate the next scheduled process of the trace, starting no later than
+ * MAX_TRACE_START_TIME. Returns 0 at its end.
+ */
+int generate_scheduled_process(trace_generator_t *generator,
+    scheduled_process_t *sp);
+/* Get the time until the next arrival, by the arrival process. */
+double get_next_interarrival_time(trace_generator_t *generator);
+/* Get the next pseudo-random (xorshift64*) number, or one uniform in (0, 1),
+ * exponential with a mean, or Pareto with a mean rounded up and capped at a
+ * max.
+ */
+unsigned long long get_next_random(trace_generator_t *generator);
+double get_next_uniform(trace_generator_t *generator);
+double get_next_exponential(trace_generator_t *generator, double mean);
+int get_next_pareto(trace_generator_t *generator, double mean, int max);
+/* Parse an arrival process name. Returns 0 if invalid. */
+int parse_arrival_process(char str[], enum arrival_process_t *arrivals);
+/* Free all memory allocated for a trace generator. */
+void free_trace_generator(trace_generator_t *generator);